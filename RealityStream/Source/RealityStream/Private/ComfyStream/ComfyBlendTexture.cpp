@@ -0,0 +1,127 @@
+#include "ComfyStream/ComfyBlendTexture.h"
+#include "Async/ParallelFor.h"
+#include "TextureResource.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#endif
+
+static bool debug = false;
+//Ping-pong textures for CPU-blended interpolation frames
+
+UTexture2D* FComfyBlendTexture::Blend(const FComfyDecodedImage& A, const FComfyDecodedImage& B, int32 Weight)
+{
+	if (!A.IsValid() || !B.IsValid() || A.Width != B.Width || A.Height != B.Height || A.Format != B.Format)
+		return nullptr;
+
+	Weight = FMath::Clamp(Weight, 0, 256);
+	return Write(A.Width, A.Height, A.Format, [&A, &B, Weight](uint8* Dst)
+	{
+		BlendPixels(A, B, Weight, Dst);
+	});
+}
+
+UTexture2D* FComfyBlendTexture::Write(int32 Width, int32 Height, EPixelFormat Format, TFunctionRef<void(uint8*)> Fill)
+{
+	const int32 Bpp = FComfyDecodedImage::GetBytesPerPixel(Format);
+	if (Width <= 0 || Height <= 0 || Bpp == 0)
+		return nullptr;
+
+	const int32 Next = (Current == INDEX_NONE) ? 0 : (Current + 1) % 2;
+	UTexture2D* Texture = Textures[Next];
+
+	const bool bReuse = IsValid(Texture) && Texture->GetResource() &&
+	                    Texture->GetSizeX() == Width && Texture->GetSizeY() == Height &&
+	                    Texture->GetPixelFormat() == Format;
+	if (!bReuse)
+	{
+		// First use or layout change - create with the new pixels (same texture settings as streamed frames)
+		FComfyDecodedImage Image;
+		Image.Width = Width;
+		Image.Height = Height;
+		Image.Format = Format;
+		Image.Pixels.SetNumUninitialized(Width * Height * Bpp);
+		Fill(Image.Pixels.GetData());
+		Texture = UComfyPngDecoder::CreateTextureFromImage(Image);
+		Textures[Next] = Texture;
+		Current = Next;
+		if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyBlendTexture] Created blend texture %d (%dx%d)"), Next, Width, Height);
+		return Texture;
+	}
+
+	// Fill a heap buffer owned by the render command (the CPU bulk data of blend textures is not kept in sync)
+	TArray<uint8>* Buffer = new TArray<uint8>();
+	Buffer->SetNumUninitialized(Width * Height * Bpp);
+	Fill(Buffer->GetData());
+
+	FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(0, 0, 0, 0, Width, Height);
+	Texture->UpdateTextureRegions(0, 1, Region, Width * Bpp, Bpp, Buffer->GetData(),
+		[Buffer](uint8*, const FUpdateTextureRegion2D* InRegion)
+		{
+			delete Buffer;
+			delete InRegion;
+		});
+
+	Current = Next;
+	return Texture;
+}
+
+void FComfyBlendTexture::Reset()
+{
+	Textures[0] = nullptr;
+	Textures[1] = nullptr;
+	Current = INDEX_NONE;
+}
+
+void FComfyBlendTexture::BlendPixels(const FComfyDecodedImage& A, const FComfyDecodedImage& B, int32 Weight, uint8* Dst)
+{
+	const int32 RowBytes = A.Width * A.GetBytesPerPixel();
+	const int32 InvWeight = 256 - Weight;
+
+	// Bands of rows per task (small frames would otherwise be dominated by scheduling)
+	constexpr int32 BandRows = 32;
+	ParallelFor(FMath::DivideAndRoundUp(A.Height, BandRows), [&](int32 Band)
+	{
+		const int32 YEnd = FMath::Min(A.Height, (Band + 1) * BandRows);
+		for (int32 Y = Band * BandRows; Y < YEnd; ++Y)
+		{
+			const uint8* RowA = A.Pixels.GetData() + Y * RowBytes;
+			const uint8* RowB = B.Pixels.GetData() + Y * RowBytes;
+			uint8* RowDst = Dst + Y * RowBytes;
+
+			if (A.Format == PF_G16)
+			{
+				// 16-bit depth keeps full precision: 16.8 products fit in 32 bits
+				const uint16* SrcA = reinterpret_cast<const uint16*>(RowA);
+				const uint16* SrcB = reinterpret_cast<const uint16*>(RowB);
+				uint16* Out = reinterpret_cast<uint16*>(RowDst);
+				for (int32 X = 0; X < A.Width; ++X)
+				{
+					Out[X] = (uint16)((uint32(SrcA[X]) * InvWeight + uint32(SrcB[X]) * Weight + 128) >> 8);
+				}
+				continue;
+			}
+
+			// 8-bit channels: 255 * 256 + 128 fits an unsigned 16-bit lane
+			int32 I = 0;
+#if PLATFORM_CPU_X86_FAMILY
+			const __m128i Zero = _mm_setzero_si128();
+			const __m128i WA = _mm_set1_epi16((short)InvWeight);
+			const __m128i WB = _mm_set1_epi16((short)Weight);
+			const __m128i Round = _mm_set1_epi16(128);
+			for (; I + 16 <= RowBytes; I += 16)
+			{
+				const __m128i VA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(RowA + I));
+				const __m128i VB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(RowB + I));
+				const __m128i Lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(VA, Zero), WA), _mm_mullo_epi16(_mm_unpacklo_epi8(VB, Zero), WB)), Round);
+				const __m128i Hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(VA, Zero), WA), _mm_mullo_epi16(_mm_unpackhi_epi8(VB, Zero), WB)), Round);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(RowDst + I), _mm_packus_epi16(_mm_srli_epi16(Lo, 8), _mm_srli_epi16(Hi, 8)));
+			}
+#endif
+			for (; I < RowBytes; ++I)
+			{
+				RowDst[I] = (uint8)((uint32(RowA[I]) * InvWeight + uint32(RowB[I]) * Weight + 128) >> 8);
+			}
+		}
+	});
+}
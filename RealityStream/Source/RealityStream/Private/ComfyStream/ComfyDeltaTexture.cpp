@@ -0,0 +1,182 @@
+#include "ComfyStream/ComfyDeltaTexture.h"
+#include "ComfyStream/ComfyPngDecoder.h"
+#include "Engine/Texture2D.h"
+#include "TextureResource.h"
+
+static bool debug = false;
+//Persistent stream textures updated with dirty tiles only
+
+UTexture2D* FComfyDeltaTexture::Upload(const FComfyImageRef& ImageRef, const FComfyTileHashes& Tiles,
+                                       FComfyTextureLeaseRef& OutLease, int32& OutTilesUploaded, int32& OutTilesTotal)
+{
+	OutLease.Reset();
+	OutTilesUploaded = 0;
+	OutTilesTotal = Tiles.Hashes.Num();
+	if (!ImageRef.IsValid() || !ImageRef->IsValid())
+		return nullptr;
+	const FComfyDecodedImage& Image = *ImageRef;
+
+	// Most recently written texture that no frame holds any more (closest content, fewest dirty tiles)
+	int32 Slot = INDEX_NONE;
+	for (int32 i = 0; i < Textures.Num(); ++i)
+	{
+		if (Leases[i].GetSharedReferenceCount() == 1 && (Slot == INDEX_NONE || LastWritten[i] > LastWritten[Slot]))
+		{
+			Slot = i;
+		}
+	}
+
+	if (Slot == INDEX_NONE)
+	{
+		if (Textures.Num() >= MaxTextures)
+		{
+			// Every ring texture is still held - this frame gets a texture of its own
+			OutTilesUploaded = OutTilesTotal;
+			if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyDeltaTexture] All %d textures held, standalone upload (%dx%d)"), MaxTextures, Image.Width, Image.Height);
+			return UComfyPngDecoder::CreateTextureFromImage(Image);
+		}
+		Slot = Textures.Add(nullptr);
+		TextureTiles.AddDefaulted();
+		Leases.Add(MakeShared<FComfyTextureLease, ESPMode::ThreadSafe>());
+		LastWritten.Add(0);
+	}
+
+	UTexture2D* Texture = Textures[Slot];
+	LastWritten[Slot] = ++UploadCounter;
+	OutLease = Leases[Slot];
+
+	const bool bCanDelta = IsValid(Texture) && LayoutMatches(Texture, Image) &&
+	                       Tiles.Hashes.Num() > 0 && Tiles.Matches(TextureTiles[Slot]);
+	if (!bCanDelta)
+	{
+		// First use or layout change - full upload into a new texture
+		Texture = UComfyPngDecoder::CreateTextureFromImage(Image);
+		Textures[Slot] = Texture;
+		TextureTiles[Slot] = Tiles;
+		OutTilesUploaded = OutTilesTotal;
+		if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyDeltaTexture] Full upload into texture %d (%dx%d)"), Slot, Image.Width, Image.Height);
+		return Texture;
+	}
+
+	// Compare against what this texture holds (the last frame written into it)
+	const FComfyTileHashes& Held = TextureTiles[Slot];
+	TBitArray<> Dirty(false, Tiles.Hashes.Num());
+	for (int32 i = 0; i < Tiles.Hashes.Num(); ++i)
+	{
+		if (Tiles.Hashes[i] != Held.Hashes[i])
+		{
+			Dirty[i] = true;
+			OutTilesUploaded++;
+		}
+	}
+
+	if (OutTilesUploaded > 0)
+	{
+		UploadDirtyTiles(Texture, ImageRef, Tiles.TileSize, Tiles.TilesX, Tiles.TilesY, Dirty);
+	}
+
+	TextureTiles[Slot] = Tiles;
+	if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyDeltaTexture] Delta upload into texture %d of %d: %d / %d tiles"), Slot, Textures.Num(), OutTilesUploaded, OutTilesTotal);
+	return Texture;
+}
+
+void FComfyDeltaTexture::Reset()
+{
+	// Frames still holding leases keep their textures; the ring just stops reusing them
+	Textures.Empty();
+	TextureTiles.Empty();
+	Leases.Empty();
+	LastWritten.Empty();
+	UploadCounter = 0;
+}
+
+bool FComfyDeltaTexture::LayoutMatches(UTexture2D* Texture, const FComfyDecodedImage& Image)
+{
+	FTexturePlatformData* PlatformData = Texture->GetPlatformData();
+	return PlatformData && Texture->GetResource() &&
+	       Texture->GetSizeX() == Image.Width && Texture->GetSizeY() == Image.Height &&
+	       Texture->GetPixelFormat() == Image.Format &&
+	       PlatformData->Mips.Num() == Image.GetNumMips();
+}
+
+void FComfyDeltaTexture::UploadDirtyTiles(UTexture2D* Texture, const FComfyImageRef& ImageRef, int32 TileSize, int32 TilesX, int32 TilesY, const TBitArray<>& Dirty)
+{
+	const FComfyDecodedImage& Image = *ImageRef;
+	FTexturePlatformData* PlatformData = Texture->GetPlatformData();
+	const int32 Bpp = Image.GetBytesPerPixel();
+
+	for (int32 MipIndex = 0; MipIndex < Image.GetNumMips(); ++MipIndex)
+	{
+		const int32 MipW = FMath::Max(1, Image.Width >> MipIndex);
+		const int32 MipH = FMath::Max(1, Image.Height >> MipIndex);
+		const int32 Scale = 1 << MipIndex;
+
+		// Dirty tile runs along each row become one region; mip pixels cover Scale x Scale source pixels
+		TArray<FUpdateTextureRegion2D> Regions;
+		if (Scale >= TileSize)
+		{
+			// Tiles collapse below one pixel - the whole (tiny) mip is cheaper than overlapping regions
+			Regions.Add(FUpdateTextureRegion2D(0, 0, 0, 0, MipW, MipH));
+		}
+		else
+		{
+			for (int32 TY = 0; TY < TilesY; ++TY)
+			{
+				int32 TX = 0;
+				while (TX < TilesX)
+				{
+					if (!Dirty[TY * TilesX + TX])
+					{
+						++TX;
+						continue;
+					}
+					const int32 RunStart = TX;
+					while (TX < TilesX && Dirty[TY * TilesX + TX])
+					{
+						++TX;
+					}
+
+					const int32 X0 = (RunStart * TileSize) / Scale;
+					const int32 X1 = FMath::Min(FMath::DivideAndRoundUp(FMath::Min(TX * TileSize, Image.Width), Scale), MipW);
+					const int32 Y0 = (TY * TileSize) / Scale;
+					const int32 Y1 = FMath::Min(FMath::DivideAndRoundUp(FMath::Min((TY + 1) * TileSize, Image.Height), Scale), MipH);
+					if (X1 > X0 && Y1 > Y0)
+					{
+						Regions.Add(FUpdateTextureRegion2D(X0, Y0, X0, Y0, X1 - X0, Y1 - Y0));
+					}
+				}
+			}
+		}
+
+		if (Regions.Num() == 0)
+			continue;
+
+		// The shared image keeps the source pixels alive until the render thread has copied them
+		const uint8* SrcData = (MipIndex == 0) ? Image.Pixels.GetData() : Image.Mips[MipIndex - 1].GetData();
+		const uint32 SrcPitch = MipW * Bpp;
+
+		// Keep the CPU copy in sync for readers of the bulk data
+		FTexture2DMipMap& Mip = PlatformData->Mips[MipIndex];
+		if (uint8* Mirror = static_cast<uint8*>(Mip.BulkData.Lock(LOCK_READ_WRITE)))
+		{
+			for (const FUpdateTextureRegion2D& Region : Regions)
+			{
+				for (uint32 Row = 0; Row < Region.Height; ++Row)
+				{
+					const int64 Offset = int64(Region.DestY + Row) * SrcPitch + int64(Region.DestX) * Bpp;
+					FMemory::Memcpy(Mirror + Offset, SrcData + Offset, Region.Width * Bpp);
+				}
+			}
+		}
+		Mip.BulkData.Unlock();
+
+		FUpdateTextureRegion2D* RegionData = new FUpdateTextureRegion2D[Regions.Num()];
+		FMemory::Memcpy(RegionData, Regions.GetData(), Regions.Num() * sizeof(FUpdateTextureRegion2D));
+
+		Texture->UpdateTextureRegions(MipIndex, Regions.Num(), RegionData, SrcPitch, Bpp, const_cast<uint8*>(SrcData),
+			[ImageRef](uint8*, const FUpdateTextureRegion2D* InRegions)
+			{
+				delete[] InRegions;
+			});
+	}
+}
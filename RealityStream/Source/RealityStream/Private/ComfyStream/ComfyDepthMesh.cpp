@@ -0,0 +1,208 @@
+#include "ComfyStream/ComfyDepthMesh.h"
+#include "Async/ParallelFor.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#endif
+
+static bool debug = false;
+//Unprojects streamed depth maps into a procedural mesh grid
+
+// Camera-space position of grid points: Z = Near + (1 - d) * Scale along the view axis, X/Y through the pinhole.
+// Stored relative to the near plane with Z towards the camera.
+static void UnprojectRow(const float* Depth, int32 Count, float U0, float StepU, float V, float Cx, float Cy, float InvFocal,
+                         float Near, float Scale, float* OutX, float* OutY, float* OutZ)
+{
+	const float RayY = (V - Cy) * InvFocal;
+	int32 I = 0;
+
+#if PLATFORM_CPU_X86_FAMILY
+	const __m128 NearV = _mm_set1_ps(Near);
+	const __m128 ScaleV = _mm_set1_ps(Scale);
+	const __m128 One = _mm_set1_ps(1.0f);
+	const __m128 RayYV = _mm_set1_ps(RayY);
+	const __m128 LaneU = _mm_mul_ps(_mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f), _mm_set1_ps(StepU * InvFocal));
+	for (; I + 4 <= Count; I += 4)
+	{
+		const __m128 Z = _mm_add_ps(NearV, _mm_mul_ps(_mm_sub_ps(One, _mm_loadu_ps(Depth + I)), ScaleV));
+		const __m128 RayX = _mm_add_ps(_mm_set1_ps((U0 + I * StepU - Cx) * InvFocal), LaneU);
+		_mm_storeu_ps(OutX + I, _mm_mul_ps(RayX, Z));
+		_mm_storeu_ps(OutY + I, _mm_mul_ps(RayYV, Z));
+		_mm_storeu_ps(OutZ + I, _mm_sub_ps(NearV, Z));
+	}
+#endif
+
+	for (; I < Count; ++I)
+	{
+		const float Z = Near + (1.0f - Depth[I]) * Scale;
+		OutX[I] = (U0 + I * StepU - Cx) * InvFocal * Z;
+		OutY[I] = RayY * Z;
+		OutZ[I] = Near - Z;
+	}
+}
+
+void FComfyDepthMesh::BuildTopology(int32 Width, int32 Height, FComfyDepthMeshBuffers& Buffers)
+{
+	const int32 Step = Buffers.Grid.Step;
+	const int32 CellsX = Buffers.GridX - 1;
+	const int32 CellsY = Buffers.GridY - 1;
+	const int32 NumCells = CellsX * CellsY;
+
+	Buffers.Vertices.SetNumUninitialized(NumCells * 4);
+	Buffers.Normals.SetNumUninitialized(NumCells * 4);
+	Buffers.UV0.SetNumUninitialized(NumCells * 4);
+	Buffers.Triangles.SetNumUninitialized(NumCells * 6);
+
+	for (int32 CY = 0; CY < CellsY; ++CY)
+	{
+		for (int32 CX = 0; CX < CellsX; ++CX)
+		{
+			const int32 Cell = CY * CellsX + CX;
+			const int32 V0 = Cell * 4;
+
+			// Corners TL, TR, BL, BR at the grid points' pixel centres
+			const float U0 = (CX * Step + 0.5f) / Width;
+			const float U1 = ((CX + 1) * Step + 0.5f) / Width;
+			const float T0 = (CY * Step + 0.5f) / Height;
+			const float T1 = ((CY + 1) * Step + 0.5f) / Height;
+			Buffers.UV0[V0 + 0] = FVector2D(U0, T0);
+			Buffers.UV0[V0 + 1] = FVector2D(U1, T0);
+			Buffers.UV0[V0 + 2] = FVector2D(U0, T1);
+			Buffers.UV0[V0 + 3] = FVector2D(U1, T1);
+
+			// Clockwise seen from +Z (the camera side)
+			int32* Tri = Buffers.Triangles.GetData() + Cell * 6;
+			Tri[0] = V0 + 0; Tri[1] = V0 + 1; Tri[2] = V0 + 2;
+			Tri[3] = V0 + 1; Tri[4] = V0 + 3; Tri[5] = V0 + 2;
+		}
+	}
+	Buffers.bTopologyChanged = true;
+
+	if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyDepthMesh] New grid %dx%d (%d cells) for %dx%d depth"),
+		Buffers.GridX, Buffers.GridY, NumCells, Width, Height);
+}
+
+bool FComfyDepthMesh::UnprojectGrid(const FComfyPixelView& Depth, const FComfyPixelView& Mask, const FComfyDepthMeshSettings& Settings, FComfyDepthGrid& Grid)
+{
+	if (!Depth.IsValid())
+		return false;
+
+	const int32 W = Depth.GetWidth();
+	const int32 H = Depth.GetHeight();
+	const int32 Step = FMath::Clamp(Settings.GridStep, 1, FMath::Max(1, FMath::Min(W, H) - 1));
+	const int32 GX = (W - 1) / Step + 1;
+	const int32 GY = (H - 1) / Step + 1;
+	if (GX < 2 || GY < 2)
+		return false;
+
+	Grid.GridX = GX;
+	Grid.GridY = GY;
+	Grid.Step = Step;
+	const int32 NumPoints = GX * GY;
+	Grid.Depth.SetNumUninitialized(NumPoints);
+	Grid.Inside.SetNumUninitialized(NumPoints);
+	Grid.PointX.SetNumUninitialized(NumPoints);
+	Grid.PointY.SetNumUninitialized(NumPoints);
+	Grid.PointZ.SetNumUninitialized(NumPoints);
+
+	// Intrinsics of the full frame in the (possibly cropped) depth image's pixels
+	const double FullW = W / FMath::Max(Settings.RoiScale.X, UE_SMALL_NUMBER);
+	const double FullH = H / FMath::Max(Settings.RoiScale.Y, UE_SMALL_NUMBER);
+	const float Cx = float(FullW * (0.5 - Settings.RoiOffset.X));
+	const float Cy = float(FullH * (0.5 - Settings.RoiOffset.Y));
+	const float InvFocal = 1.0f / float(FMath::Max(Settings.FocalScale * FullW, 1.0));
+
+	const bool bMask = Mask.IsValid();
+	const float MaskScaleX = bMask ? float(Mask.GetWidth()) / W : 0.0f;
+	const float MaskScaleY = bMask ? float(Mask.GetHeight()) / H : 0.0f;
+	const float MaskThreshold = Settings.MaskThreshold / 255.0f;
+
+	// Sample and unproject grid points, one grid row per task
+	ParallelFor(GY, [&](int32 Row)
+	{
+		const int32 Y = Row * Step;
+		float* RowDepth = Grid.Depth.GetData() + Row * GX;
+		uint8* RowInside = Grid.Inside.GetData() + Row * GX;
+		for (int32 Col = 0; Col < GX; ++Col)
+		{
+			const int32 X = Col * Step;
+			RowDepth[Col] = Depth.GetValue(X, Y);
+			RowInside[Col] = !bMask || Mask.GetValue(int32((X + 0.5f) * MaskScaleX), int32((Y + 0.5f) * MaskScaleY)) > MaskThreshold;
+		}
+
+		UnprojectRow(RowDepth, GX, 0.5f, float(Step), Y + 0.5f, Cx, Cy, InvFocal, Settings.NearDistance, Settings.DepthScaleUnits,
+			Grid.PointX.GetData() + Row * GX, Grid.PointY.GetData() + Row * GX, Grid.PointZ.GetData() + Row * GX);
+	});
+	return true;
+}
+
+bool FComfyDepthMesh::Build(const FComfyPixelView& Depth, const FComfyPixelView& Mask, const FComfyDepthMeshSettings& Settings, FComfyDepthMeshBuffers& Buffers)
+{
+	Buffers.NumValidCells = 0;
+	FComfyDepthGrid& Grid = Buffers.Grid;
+	if (!UnprojectGrid(Depth, Mask, Settings, Grid))
+		return false;
+
+	const int32 GX = Grid.GridX;
+	const int32 GY = Grid.GridY;
+	const FIntPoint DepthSize(Depth.GetWidth(), Depth.GetHeight());
+	if (GX != Buffers.GridX || GY != Buffers.GridY || Grid.Step != Buffers.GridStep || DepthSize != Buffers.DepthSize)
+	{
+		Buffers.GridX = GX;
+		Buffers.GridY = GY;
+		Buffers.GridStep = Grid.Step;
+		Buffers.DepthSize = DepthSize;
+		BuildTopology(Depth.GetWidth(), Depth.GetHeight(), Buffers);
+	}
+	Buffers.PointNormals.SetNumUninitialized(GX * GY);
+
+	// Smooth normals from central differences of the unprojected grid
+	ParallelFor(GY, [&](int32 Row)
+	{
+		const int32 Up = FMath::Max(Row - 1, 0) * GX;
+		const int32 Down = FMath::Min(Row + 1, GY - 1) * GX;
+		for (int32 Col = 0; Col < GX; ++Col)
+		{
+			const int32 Left = Row * GX + FMath::Max(Col - 1, 0);
+			const int32 Right = Row * GX + FMath::Min(Col + 1, GX - 1);
+			const FVector3f DX(Grid.PointX[Right] - Grid.PointX[Left], Grid.PointY[Right] - Grid.PointY[Left], Grid.PointZ[Right] - Grid.PointZ[Left]);
+			const FVector3f DY(Grid.PointX[Down + Col] - Grid.PointX[Up + Col], Grid.PointY[Down + Col] - Grid.PointY[Up + Col], Grid.PointZ[Down + Col] - Grid.PointZ[Up + Col]);
+			Buffers.PointNormals[Row * GX + Col] = FVector3f::CrossProduct(DX, DY).GetSafeNormal(UE_SMALL_NUMBER, FVector3f::UnitZ());
+		}
+	});
+
+	// Cells: four corners inside the mask and no depth edge across the cell, otherwise collapsed
+	const int32 CellsX = GX - 1;
+	const int32 CellsY = GY - 1;
+	TArray<int32> RowValid;
+	RowValid.SetNumZeroed(CellsY);
+	ParallelFor(CellsY, [&](int32 CY)
+	{
+		int32 Valid = 0;
+		for (int32 CX = 0; CX < CellsX; ++CX)
+		{
+			const int32 Corner[4] = { CY * GX + CX, CY * GX + CX + 1, (CY + 1) * GX + CX, (CY + 1) * GX + CX + 1 };
+			const float D0 = Grid.Depth[Corner[0]], D1 = Grid.Depth[Corner[1]], D2 = Grid.Depth[Corner[2]], D3 = Grid.Depth[Corner[3]];
+			const bool bKeep = Grid.Inside[Corner[0]] && Grid.Inside[Corner[1]] && Grid.Inside[Corner[2]] && Grid.Inside[Corner[3]] &&
+			                   FMath::Max(FMath::Max(D0, D1), FMath::Max(D2, D3)) - FMath::Min(FMath::Min(D0, D1), FMath::Min(D2, D3)) <= Settings.DepthEdgeThreshold;
+
+			const int32 V0 = (CY * CellsX + CX) * 4;
+			for (int32 K = 0; K < 4; ++K)
+			{
+				const int32 P = bKeep ? Corner[K] : Corner[0];
+				Buffers.Vertices[V0 + K] = FVector(Grid.PointX[P], Grid.PointY[P], Grid.PointZ[P]);
+				Buffers.Normals[V0 + K] = FVector(Buffers.PointNormals[P]);
+			}
+			Valid += bKeep ? 1 : 0;
+		}
+		RowValid[CY] = Valid;
+	});
+
+	for (int32 Valid : RowValid)
+	{
+		Buffers.NumValidCells += Valid;
+	}
+
+	if (debug) UE_LOG(LogTemp, Verbose, TEXT("[ComfyDepthMesh] %d of %d cells inside the mask"), Buffers.NumValidCells, CellsX * CellsY);
+	return Buffers.NumValidCells > 0;
+}
@@ -0,0 +1,1227 @@
+#include "ComfyStream/ComfyFrameIngest.h"
+#include "HAL/PlatformTime.h"
+#include "Hash/CityHash.h"
+#include "Async/ParallelFor.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#endif
+
+static bool debug = false;
+//Ingest stages for one received frame, run on a worker thread by UComfyImageFetcher
+
+// Crop rectangles snap outward to 1/CropGridCells of the frame, and the previous crop is kept while the
+// padded mask bounds fit inside it and it covers at most CropKeepAreaRatio times the snapped bounds.
+// A stable ROI keeps ring textures reusable and lets consecutive frames interpolate instead of switching.
+static constexpr int32 CropGridCells = 16;
+static constexpr int64 CropKeepAreaRatio = 2;
+
+bool FComfyFrameIngest::ProcessTriplet(const TArray<TArray<uint8>>& Pngs, const FComfyIngestSettings& Settings, FComfyIngestResult& OutResult,
+                                       const FIntRect& PreviousCrop)
+{
+	OutResult = FComfyIngestResult();
+	FComfyIngestStats& Stats = OutResult.Stats;
+	const double StartTime = FPlatformTime::Seconds();
+	double StageStart = StartTime;
+
+	// Milliseconds since the previous stage ended
+	auto EndStage = [&StageStart]() -> float
+	{
+		const double Now = FPlatformTime::Seconds();
+		const float Ms = float((Now - StageStart) * 1000.0);
+		StageStart = Now;
+		return Ms;
+	};
+
+	// Decode all PNGs to CPU pixels first, then check if they're grayscale to assign channels
+	TArray<FComfyDecodedImage> Images;
+	Images.SetNum(Pngs.Num());
+	for (int32 i = 0; i < Pngs.Num(); ++i)
+	{
+		if (!UComfyPngDecoder::DecodePNGToImage(Pngs[i], Images[i]))
+		{
+			if (debug) UE_LOG(LogTemp, Warning, TEXT("[ComfyFrameIngest] Failed to decode PNG %d (%d bytes)"), i, Pngs[i].Num());
+		}
+	}
+
+	AssignChannels(Pngs, Images, OutResult);
+	Stats.DecodeMs = EndStage();
+
+	// Optional upscale for low-resolution generation; replaces the half-resolution pass
+	const bool bUpscale = Settings.UpscaleFactor > 1.0f;
+	if (bUpscale)
+	{
+		UpscaleImage(OutResult.RGB, Settings.UpscaleFactor, EComfyUpscaleChannel::Color);
+		UpscaleImage(OutResult.Depth, Settings.UpscaleFactor, EComfyUpscaleChannel::Depth, Settings.UpscaleDepthEdgeThreshold);
+		UpscaleImage(OutResult.Mask, Settings.UpscaleFactor, EComfyUpscaleChannel::Mask);
+	}
+	Stats.UpscaleMs = EndStage();
+
+	// Optional half-resolution pass (all channels, keeps them the same size)
+	if (Settings.bDownscaleHalf && !bUpscale)
+	{
+		UComfyPngDecoder::DownscaleImageHalf(OutResult.RGB);
+		UComfyPngDecoder::DownscaleImageHalf(OutResult.Depth);
+		UComfyPngDecoder::DownscaleImageHalf(OutResult.Mask);
+	}
+	Stats.DownscaleMs = EndStage();
+
+	// Clean the mask once here instead of multi-tap filtering in the material every rendered frame
+	if (Settings.MaskErodeRadius > 0 || Settings.MaskDilateRadius > 0 || Settings.MaskFeatherSigma > 0.0f)
+	{
+		CleanMask(OutResult.Mask, Settings.MaskErodeRadius, Settings.MaskDilateRadius, Settings.MaskFeatherSigma);
+	}
+	Stats.MaskCleanupMs = EndStage();
+
+	// Normals once per depth frame instead of finite differences per pixel per view in the material.
+	// Before the crop so the kernel sees the neighbours outside the ROI and pixel spacing is that of the full frame.
+	if (Settings.bComputeNormals && OutResult.Depth.IsValid())
+	{
+		ComputeNormalsFromDepth(OutResult.Depth, Settings.NormalDepthScale, OutResult.Normal);
+	}
+	Stats.NormalMs = EndStage();
+
+	// Subject shape for placing content, on the full frame (before the crop changes pixel coordinates)
+	if (Settings.bComputeMaskAnalytics)
+	{
+		ComputeMaskAnalytics(OutResult.Mask, OutResult.Depth, (uint8)FMath::Clamp(Settings.CropMaskThreshold, 0, 254), OutResult.Analytics);
+	}
+	Stats.AnalyticsMs = EndStage();
+
+	// Sparse subjects: upload only the padded mask bounds
+	if (Settings.bCropToMask)
+	{
+		CropToMask(OutResult, Settings, PreviousCrop);
+	}
+	Stats.CropMs = EndStage();
+
+	// Merge the mask into RGB.A so the frame needs one upload and one sampler for colour + coverage
+	if (Settings.bPackMaskIntoRGBAlpha && PackMaskIntoAlpha(OutResult.RGB, OutResult.Mask))
+	{
+		OutResult.Mask = FComfyDecodedImage();
+		OutResult.bMaskPacked = true;
+	}
+	Stats.PackMs = EndStage();
+
+	// Mips last so they include the packed alpha (same 2x2 kernel as the downscale)
+	if (Settings.bGenerateMips)
+	{
+		UComfyPngDecoder::BuildMipChain(OutResult.RGB);
+		UComfyPngDecoder::BuildMipChain(OutResult.Depth);
+		UComfyPngDecoder::BuildMipChain(OutResult.Mask);
+		UComfyPngDecoder::BuildMipChain(OutResult.Normal);
+	}
+	Stats.MipMs = EndStage();
+
+	// Tile hashes let the game thread upload only what changed since the texture was last written
+	if (Settings.bDeltaUploads)
+	{
+		ComputeTileHashes(OutResult.RGB, Settings.DeltaTileSize, OutResult.RGBTiles);
+		ComputeTileHashes(OutResult.Depth, Settings.DeltaTileSize, OutResult.DepthTiles);
+		ComputeTileHashes(OutResult.Mask, Settings.DeltaTileSize, OutResult.MaskTiles);
+		ComputeTileHashes(OutResult.Normal, Settings.DeltaTileSize, OutResult.NormalTiles);
+	}
+	Stats.HashMs = EndStage();
+
+	Stats.WorkerMs = float((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return OutResult.IsComplete();
+}
+
+// ============================================================
+// Upscale
+// ============================================================
+
+static constexpr int32 LanczosTaps = 6;
+
+static float Lanczos3(float X)
+{
+	X = FMath::Abs(X);
+	if (X < 1e-5f) return 1.0f;
+	if (X >= 3.0f) return 0.0f;
+	const float PiX = PI * X;
+	return 3.0f * FMath::Sin(PiX) * FMath::Sin(PiX / 3.0f) / (PiX * PiX);
+}
+
+// Six clamped source indices and normalized weights per output coordinate (pixel centres aligned)
+static void BuildLanczosTaps(int32 SrcSize, int32 DstSize, TArray<int32>& OutIndex, TArray<float>& OutWeight)
+{
+	OutIndex.SetNumUninitialized(DstSize * LanczosTaps);
+	OutWeight.SetNumUninitialized(DstSize * LanczosTaps);
+	const float InvScale = float(SrcSize) / float(DstSize);
+	for (int32 O = 0; O < DstSize; ++O)
+	{
+		const float Center = (O + 0.5f) * InvScale - 0.5f;
+		const int32 First = FMath::FloorToInt32(Center) - 2;
+		float Sum = 0.0f;
+		for (int32 K = 0; K < LanczosTaps; ++K)
+		{
+			const float Weight = Lanczos3(Center - float(First + K));
+			OutIndex[O * LanczosTaps + K] = FMath::Clamp(First + K, 0, SrcSize - 1);
+			OutWeight[O * LanczosTaps + K] = Weight;
+			Sum += Weight;
+		}
+		for (int32 K = 0; K < LanczosTaps; ++K)
+		{
+			OutWeight[O * LanczosTaps + K] /= Sum;
+		}
+	}
+}
+
+void FComfyFrameIngest::UpscaleImage(FComfyDecodedImage& Image, float Factor, EComfyUpscaleChannel Channel, float DepthEdgeThreshold)
+{
+	if (!Image.IsValid() || Factor <= 1.0f)
+		return;
+
+	const bool b16 = (Image.Format == PF_G16);
+	const int32 C = b16 ? 1 : Image.GetBytesPerPixel();
+	const int32 SrcW = Image.Width;
+	const int32 SrcH = Image.Height;
+	const int32 DstW = FMath::Max(1, FMath::RoundToInt32(SrcW * Factor));
+	const int32 DstH = FMath::Max(1, FMath::RoundToInt32(SrcH * Factor));
+	const float MaxValue = b16 ? 65535.0f : 255.0f;
+	const uint8* Src8 = Image.Pixels.GetData();
+	const uint16* Src16 = reinterpret_cast<const uint16*>(Image.Pixels.GetData());
+	auto SrcValue = [&](int32 X, int32 Y, int32 Ch) -> float
+	{
+		const int32 Index = (Y * SrcW + X) * C + Ch;
+		return b16 ? float(Src16[Index]) : float(Src8[Index]);
+	};
+
+	TArray<int32> XIndex, YIndex;
+	TArray<float> XWeight, YWeight;
+	BuildLanczosTaps(SrcW, DstW, XIndex, XWeight);
+	BuildLanczosTaps(SrcH, DstH, YIndex, YWeight);
+
+	// Bands of rows per task keep each worker on a contiguous tile of the intermediate buffer
+	constexpr int32 BandRows = 32;
+
+	// Horizontal pass: source rows -> float rows of DstW * C
+	const int32 TmpPitch = DstW * C;
+	TArray<float> Tmp;
+	Tmp.SetNumUninitialized(TmpPitch * SrcH);
+	ParallelFor(FMath::DivideAndRoundUp(SrcH, BandRows), [&](int32 Band)
+	{
+		const int32 YEnd = FMath::Min(SrcH, (Band + 1) * BandRows);
+		for (int32 Y = Band * BandRows; Y < YEnd; ++Y)
+		{
+			float* Dst = Tmp.GetData() + Y * TmpPitch;
+#if PLATFORM_CPU_X86_FAMILY
+			if (C == 4 && !b16)
+			{
+				// One RGBA pixel per SSE register
+				const __m128i Zero = _mm_setzero_si128();
+				const uint8* Row = Src8 + Y * SrcW * 4;
+				for (int32 X = 0; X < DstW; ++X)
+				{
+					__m128 Acc = _mm_setzero_ps();
+					for (int32 K = 0; K < LanczosTaps; ++K)
+					{
+						int32 Packed;
+						FMemory::Memcpy(&Packed, Row + XIndex[X * LanczosTaps + K] * 4, 4);
+						const __m128i Px = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(Packed), Zero), Zero);
+						Acc = _mm_add_ps(Acc, _mm_mul_ps(_mm_cvtepi32_ps(Px), _mm_set1_ps(XWeight[X * LanczosTaps + K])));
+					}
+					_mm_storeu_ps(Dst + X * 4, Acc);
+				}
+				continue;
+			}
+#endif
+			for (int32 X = 0; X < DstW; ++X)
+			{
+				for (int32 Ch = 0; Ch < C; ++Ch)
+				{
+					float Acc = 0.0f;
+					for (int32 K = 0; K < LanczosTaps; ++K)
+					{
+						Acc += SrcValue(XIndex[X * LanczosTaps + K], Y, Ch) * XWeight[X * LanczosTaps + K];
+					}
+					Dst[X * C + Ch] = Acc;
+				}
+			}
+		}
+	});
+
+	// Vertical pass: float rows -> output pixels, with the channel's edge rule
+	FComfyDecodedImage Out;
+	Out.Width = DstW;
+	Out.Height = DstH;
+	Out.Format = Image.Format;
+	Out.Pixels.SetNumUninitialized(DstW * DstH * Image.GetBytesPerPixel());
+	const float XInvScale = float(SrcW) / float(DstW);
+	const float YInvScale = float(SrcH) / float(DstH);
+
+	ParallelFor(FMath::DivideAndRoundUp(DstH, BandRows), [&](int32 Band)
+	{
+		TArray<float> Row;
+		Row.SetNumUninitialized(TmpPitch);
+		const int32 YEnd = FMath::Min(DstH, (Band + 1) * BandRows);
+		for (int32 Y = Band * BandRows; Y < YEnd; ++Y)
+		{
+			const int32* Rows = YIndex.GetData() + Y * LanczosTaps;
+			const float* Weights = YWeight.GetData() + Y * LanczosTaps;
+			int32 I = 0;
+#if PLATFORM_CPU_X86_FAMILY
+			for (; I + 4 <= TmpPitch; I += 4)
+			{
+				__m128 Acc = _mm_setzero_ps();
+				for (int32 K = 0; K < LanczosTaps; ++K)
+				{
+					Acc = _mm_add_ps(Acc, _mm_mul_ps(_mm_loadu_ps(Tmp.GetData() + Rows[K] * TmpPitch + I), _mm_set1_ps(Weights[K])));
+				}
+				_mm_storeu_ps(Row.GetData() + I, Acc);
+			}
+#endif
+			for (; I < TmpPitch; ++I)
+			{
+				float Acc = 0.0f;
+				for (int32 K = 0; K < LanczosTaps; ++K)
+				{
+					Acc += Tmp[Rows[K] * TmpPitch + I] * Weights[K];
+				}
+				Row[I] = Acc;
+			}
+
+			if (Channel == EComfyUpscaleChannel::Mask)
+			{
+				// Binary coverage: drops Lanczos overshoot and half-transparent seams
+				const float Half = MaxValue * 0.5f;
+				for (float& V : Row) V = (V >= Half) ? MaxValue : 0.0f;
+			}
+			else if (Channel == EComfyUpscaleChannel::Depth && C == 1)
+			{
+				// Within smooth regions clamp to the 2x2 source footprint (no ringing); across steps take
+				// the nearest source sample so foreground and background never blend into floating pixels
+				const float CY = (Y + 0.5f) * YInvScale - 0.5f;
+				const int32 Y0 = FMath::Clamp(FMath::FloorToInt32(CY), 0, SrcH - 1);
+				const int32 Y1 = FMath::Min(Y0 + 1, SrcH - 1);
+				const int32 NearY = FMath::Clamp(FMath::FloorToInt32((Y + 0.5f) * YInvScale), 0, SrcH - 1);
+				const float EdgeRange = DepthEdgeThreshold * MaxValue;
+				for (int32 X = 0; X < DstW; ++X)
+				{
+					const float CX = (X + 0.5f) * XInvScale - 0.5f;
+					const int32 X0 = FMath::Clamp(FMath::FloorToInt32(CX), 0, SrcW - 1);
+					const int32 X1 = FMath::Min(X0 + 1, SrcW - 1);
+					const float A = SrcValue(X0, Y0, 0), B = SrcValue(X1, Y0, 0), D = SrcValue(X0, Y1, 0), E = SrcValue(X1, Y1, 0);
+					const float Lo = FMath::Min(FMath::Min(A, B), FMath::Min(D, E));
+					const float Hi = FMath::Max(FMath::Max(A, B), FMath::Max(D, E));
+					if (Hi - Lo > EdgeRange)
+					{
+						const int32 NearX = FMath::Clamp(FMath::FloorToInt32((X + 0.5f) * XInvScale), 0, SrcW - 1);
+						Row[X] = SrcValue(NearX, NearY, 0);
+					}
+					else
+					{
+						Row[X] = FMath::Clamp(Row[X], Lo, Hi);
+					}
+				}
+			}
+
+			// Quantize
+			if (b16)
+			{
+				uint16* Dst = reinterpret_cast<uint16*>(Out.Pixels.GetData()) + Y * DstW;
+				for (int32 X = 0; X < DstW; ++X)
+				{
+					Dst[X] = (uint16)FMath::Clamp(FMath::RoundToInt32(Row[X]), 0, 65535);
+				}
+				continue;
+			}
+			uint8* Dst = Out.Pixels.GetData() + Y * TmpPitch;
+			I = 0;
+#if PLATFORM_CPU_X86_FAMILY
+			for (; I + 8 <= TmpPitch; I += 8)
+			{
+				// Saturating packs clamp Lanczos overshoot to 0..255
+				const __m128i Lo = _mm_cvtps_epi32(_mm_loadu_ps(Row.GetData() + I));
+				const __m128i Hi = _mm_cvtps_epi32(_mm_loadu_ps(Row.GetData() + I + 4));
+				const __m128i Packed16 = _mm_packs_epi32(Lo, Hi);
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(Dst + I), _mm_packus_epi16(Packed16, Packed16));
+			}
+#endif
+			for (; I < TmpPitch; ++I)
+			{
+				Dst[I] = (uint8)FMath::Clamp(FMath::RoundToInt32(Row[I]), 0, 255);
+			}
+		}
+	});
+
+	if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyFrameIngest] Upscaled %dx%d -> %dx%d (format %d)"), SrcW, SrcH, DstW, DstH, (int32)Image.Format);
+	Image = MoveTemp(Out);
+}
+
+FComfyUpscaleBenchmark FComfyFrameIngest::BenchmarkUpscale(int32 Width, int32 Height, float Factor, int32 Iterations, float GenerationMs)
+{
+	FComfyUpscaleBenchmark Result;
+	Width = FMath::Max(Width, 8);
+	Height = FMath::Max(Height, 8);
+	Factor = FMath::Clamp(Factor, 1.0f, 4.0f);
+	Iterations = FMath::Max(Iterations, 1);
+
+	// Synthetic frame: noisy colour, a depth ramp with a foreground step, a disc mask
+	FComfyDecodedImage RGB, Depth, Mask;
+	RGB.Width = Depth.Width = Mask.Width = Width;
+	RGB.Height = Depth.Height = Mask.Height = Height;
+	RGB.Format = PF_R8G8B8A8;
+	Depth.Format = PF_G8;
+	Mask.Format = PF_G8;
+	RGB.Pixels.SetNumUninitialized(Width * Height * 4);
+	Depth.Pixels.SetNumUninitialized(Width * Height);
+	Mask.Pixels.SetNumUninitialized(Width * Height);
+	FRandomStream Random(1234);
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		for (int32 X = 0; X < Width; ++X)
+		{
+			const int32 Index = Y * Width + X;
+			const bool bInside = FMath::Square(X - Width / 2) + FMath::Square(Y - Height / 2) < FMath::Square(FMath::Min(Width, Height) / 3);
+			for (int32 Ch = 0; Ch < 3; ++Ch)
+			{
+				RGB.Pixels[Index * 4 + Ch] = (uint8)Random.RandRange(0, 255);
+			}
+			RGB.Pixels[Index * 4 + 3] = 255;
+			Depth.Pixels[Index] = bInside ? 200 : (uint8)(X * 120 / Width);
+			Mask.Pixels[Index] = bInside ? 255 : 0;
+		}
+	}
+
+	double TotalSeconds = 0.0;
+	for (int32 It = 0; It < Iterations; ++It)
+	{
+		FComfyDecodedImage R = RGB, D = Depth, M = Mask;
+		const double Start = FPlatformTime::Seconds();
+		UpscaleImage(R, Factor, EComfyUpscaleChannel::Color);
+		UpscaleImage(D, Factor, EComfyUpscaleChannel::Depth);
+		UpscaleImage(M, Factor, EComfyUpscaleChannel::Mask);
+		TotalSeconds += FPlatformTime::Seconds() - Start;
+		Result.OutputSize = FIntPoint(R.Width, R.Height);
+	}
+
+	Result.SourceSize = FIntPoint(Width, Height);
+	Result.UpscaleMs = float(TotalSeconds * 1000.0 / Iterations);
+	Result.GenerationMs = GenerationMs;
+	if (GenerationMs > 0.0f)
+	{
+		// Generation cost scales with pixel count; ingest runs alongside generation on another machine/thread
+		const float PixelRatio = float(Result.OutputSize.X * Result.OutputSize.Y) / float(Width * Height);
+		Result.GenerationMsSaved = GenerationMs * (PixelRatio - 1.0f);
+		Result.EstimatedSpeedup = (GenerationMs * PixelRatio) / FMath::Max(GenerationMs, Result.UpscaleMs);
+	}
+	return Result;
+}
+
+// ============================================================
+// Mask clean-up
+// ============================================================
+
+// Row with Radius replicated edge pixels on both sides, so filter taps never need bounds checks
+static void PadRow(const uint8* Row, int32 W, int32 Radius, TArray<uint8>& OutPadded)
+{
+	OutPadded.SetNumUninitialized(W + 2 * Radius);
+	FMemory::Memset(OutPadded.GetData(), Row[0], Radius);
+	FMemory::Memcpy(OutPadded.GetData() + Radius, Row, W);
+	FMemory::Memset(OutPadded.GetData() + Radius + W, Row[W - 1], Radius);
+}
+
+// Separable min (erode) or max (dilate) over a (2R+1) x (2R+1) box
+static void MinMaxFilter(TArray<uint8>& Pixels, int32 W, int32 H, int32 Radius, bool bMax)
+{
+	TArray<uint8> Temp;
+	Temp.SetNumUninitialized(W * H);
+
+	// Horizontal pass: Pixels -> Temp
+	ParallelFor(H, [&](int32 Y)
+	{
+		TArray<uint8> Padded;
+		PadRow(Pixels.GetData() + Y * W, W, Radius, Padded);
+		const uint8* Src = Padded.GetData();
+		uint8* Dst = Temp.GetData() + Y * W;
+		int32 X = 0;
+#if PLATFORM_CPU_X86_FAMILY
+		for (; X + 16 <= W; X += 16)
+		{
+			__m128i Acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + X));
+			for (int32 K = 1; K <= 2 * Radius; ++K)
+			{
+				const __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + X + K));
+				Acc = bMax ? _mm_max_epu8(Acc, V) : _mm_min_epu8(Acc, V);
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + X), Acc);
+		}
+#endif
+		for (; X < W; ++X)
+		{
+			uint8 Acc = Src[X];
+			for (int32 K = 1; K <= 2 * Radius; ++K)
+			{
+				Acc = bMax ? FMath::Max(Acc, Src[X + K]) : FMath::Min(Acc, Src[X + K]);
+			}
+			Dst[X] = Acc;
+		}
+	});
+
+	// Vertical pass: Temp -> Pixels (rows clamped at the edges)
+	ParallelFor(H, [&](int32 Y)
+	{
+		uint8* Dst = Pixels.GetData() + Y * W;
+		int32 X = 0;
+#if PLATFORM_CPU_X86_FAMILY
+		for (; X + 16 <= W; X += 16)
+		{
+			__m128i Acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Temp.GetData() + FMath::Max(Y - Radius, 0) * W + X));
+			for (int32 K = -Radius + 1; K <= Radius; ++K)
+			{
+				const int32 SrcY = FMath::Clamp(Y + K, 0, H - 1);
+				const __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Temp.GetData() + SrcY * W + X));
+				Acc = bMax ? _mm_max_epu8(Acc, V) : _mm_min_epu8(Acc, V);
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + X), Acc);
+		}
+#endif
+		for (; X < W; ++X)
+		{
+			uint8 Acc = Temp[FMath::Max(Y - Radius, 0) * W + X];
+			for (int32 K = -Radius + 1; K <= Radius; ++K)
+			{
+				const uint8 V = Temp[FMath::Clamp(Y + K, 0, H - 1) * W + X];
+				Acc = bMax ? FMath::Max(Acc, V) : FMath::Min(Acc, V);
+			}
+			Dst[X] = Acc;
+		}
+	});
+}
+
+// Separable Gaussian with 8.8 fixed-point weights summing to exactly 256
+// (255 * 256 + 128 still fits in an unsigned 16-bit lane, so SIMD and scalar give identical results)
+static void GaussianFeather(TArray<uint8>& Pixels, int32 W, int32 H, float Sigma)
+{
+	const int32 Radius = FMath::Max(1, FMath::CeilToInt32(Sigma * 3.0f));
+	TArray<uint16> Weights;
+	Weights.SetNumUninitialized(2 * Radius + 1);
+	{
+		TArray<float> Gauss;
+		Gauss.SetNumUninitialized(2 * Radius + 1);
+		float Sum = 0.0f;
+		for (int32 K = -Radius; K <= Radius; ++K)
+		{
+			Gauss[K + Radius] = FMath::Exp(-(K * K) / (2.0f * Sigma * Sigma));
+			Sum += Gauss[K + Radius];
+		}
+		int32 Total = 0;
+		for (int32 K = 0; K < Gauss.Num(); ++K)
+		{
+			if (K == Radius) continue;
+			Weights[K] = (uint16)FMath::RoundToInt32(Gauss[K] / Sum * 256.0f);
+			Total += Weights[K];
+		}
+		Weights[Radius] = (uint16)(256 - Total); // centre tap absorbs rounding
+	}
+
+	TArray<uint8> Temp;
+	Temp.SetNumUninitialized(W * H);
+
+	// Weighted sum of 2R+1 taps; GetTap(K) returns the row pointer for tap K at the current X
+	auto FilterRow = [&Weights, Radius, W](auto&& GetTap, uint8* Dst)
+	{
+		int32 X = 0;
+#if PLATFORM_CPU_X86_FAMILY
+		const __m128i Zero = _mm_setzero_si128();
+		const __m128i Round = _mm_set1_epi16(128);
+		for (; X + 16 <= W; X += 16)
+		{
+			__m128i AccLo = Round;
+			__m128i AccHi = Round;
+			for (int32 K = 0; K <= 2 * Radius; ++K)
+			{
+				const __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(GetTap(K) + X));
+				const __m128i Wt = _mm_set1_epi16((short)Weights[K]);
+				AccLo = _mm_add_epi16(AccLo, _mm_mullo_epi16(_mm_unpacklo_epi8(V, Zero), Wt));
+				AccHi = _mm_add_epi16(AccHi, _mm_mullo_epi16(_mm_unpackhi_epi8(V, Zero), Wt));
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + X), _mm_packus_epi16(_mm_srli_epi16(AccLo, 8), _mm_srli_epi16(AccHi, 8)));
+		}
+#endif
+		for (; X < W; ++X)
+		{
+			uint32 Acc = 128;
+			for (int32 K = 0; K <= 2 * Radius; ++K)
+			{
+				Acc += uint32(GetTap(K)[X]) * Weights[K];
+			}
+			Dst[X] = (uint8)(Acc >> 8);
+		}
+	};
+
+	// Horizontal pass: Pixels -> Temp
+	ParallelFor(H, [&](int32 Y)
+	{
+		TArray<uint8> Padded;
+		PadRow(Pixels.GetData() + Y * W, W, Radius, Padded);
+		FilterRow([&Padded](int32 K) { return Padded.GetData() + K; }, Temp.GetData() + Y * W);
+	});
+
+	// Vertical pass: Temp -> Pixels
+	ParallelFor(H, [&](int32 Y)
+	{
+		FilterRow([&Temp, Y, Radius, W, H](int32 K) { return Temp.GetData() + FMath::Clamp(Y + K - Radius, 0, H - 1) * W; },
+		          Pixels.GetData() + Y * W);
+	});
+}
+
+void FComfyFrameIngest::CleanMask(FComfyDecodedImage& Mask, int32 ErodeRadius, int32 DilateRadius, float FeatherSigma)
+{
+	if (!Mask.IsValid() || !Mask.IsSingleChannel())
+		return;
+
+	// Filters work on 8-bit coverage
+	if (Mask.Format == PF_G16)
+	{
+		const int32 NumPixels = Mask.Width * Mask.Height;
+		TArray<uint8> Mask8;
+		Mask8.SetNumUninitialized(NumPixels);
+		const uint16* Src16 = reinterpret_cast<const uint16*>(Mask.Pixels.GetData());
+		for (int32 i = 0; i < NumPixels; ++i)
+		{
+			Mask8[i] = static_cast<uint8>(Src16[i] >> 8);
+		}
+		Mask.Pixels = MoveTemp(Mask8);
+		Mask.Format = PF_G8;
+	}
+	Mask.Mips.Reset();
+
+	if (ErodeRadius > 0)
+	{
+		MinMaxFilter(Mask.Pixels, Mask.Width, Mask.Height, ErodeRadius, false);
+	}
+	if (DilateRadius > 0)
+	{
+		MinMaxFilter(Mask.Pixels, Mask.Width, Mask.Height, DilateRadius, true);
+	}
+	if (FeatherSigma > 0.0f)
+	{
+		GaussianFeather(Mask.Pixels, Mask.Width, Mask.Height, FeatherSigma);
+	}
+}
+
+// ============================================================
+// Depth normals
+// ============================================================
+
+bool FComfyFrameIngest::ComputeNormalsFromDepth(const FComfyDecodedImage& Depth, float DepthScale, FComfyDecodedImage& OutNormal)
+{
+	OutNormal = FComfyDecodedImage();
+	if (!Depth.IsValid() || !Depth.IsSingleChannel() || Depth.Width < 2 || Depth.Height < 2)
+		return false;
+
+	const int32 W = Depth.Width;
+	const int32 H = Depth.Height;
+	const int32 PaddedW = W + 2;
+
+	// Depth as float rows with one replicated pixel on each side, so the 3x3 kernel needs no bounds checks
+	TArray<float> DepthF;
+	DepthF.SetNumUninitialized(PaddedW * H);
+	const bool b16 = (Depth.Format == PF_G16);
+	ParallelFor(H, [&](int32 Y)
+	{
+		float* Dst = DepthF.GetData() + Y * PaddedW + 1;
+		if (b16)
+		{
+			const uint16* Src = reinterpret_cast<const uint16*>(Depth.Pixels.GetData()) + Y * W;
+			for (int32 X = 0; X < W; ++X) Dst[X] = float(Src[X]);
+		}
+		else
+		{
+			const uint8* Src = Depth.Pixels.GetData() + Y * W;
+			for (int32 X = 0; X < W; ++X) Dst[X] = float(Src[X]);
+		}
+		Dst[-1] = Dst[0];
+		Dst[W] = Dst[W - 1];
+	});
+
+	// Sobel sums are 8x the per-pixel slope in depth values. Convert to world units:
+	// depth value -> DepthScale / MaxValue, pixel -> 100 / W units across the plane
+	const float MaxValue = b16 ? 65535.0f : 255.0f;
+	const float SlopeScale = (DepthScale / MaxValue) / 8.0f / (100.0f / float(W));
+
+	OutNormal.Width = W;
+	OutNormal.Height = H;
+	OutNormal.Format = PF_R8G8;
+	OutNormal.Pixels.SetNumUninitialized(W * H * 2);
+
+	ParallelFor(H, [&](int32 Y)
+	{
+		const float* R0 = DepthF.GetData() + FMath::Max(Y - 1, 0) * PaddedW;
+		const float* R1 = DepthF.GetData() + Y * PaddedW;
+		const float* R2 = DepthF.GetData() + FMath::Min(Y + 1, H - 1) * PaddedW;
+		uint8* Dst = OutNormal.Pixels.GetData() + Y * W * 2;
+
+		// Padded index X is source pixel X - 1, so taps X, X+1, X+2 are left, centre, right
+		int32 X = 0;
+#if PLATFORM_CPU_X86_FAMILY
+		const __m128 Two = _mm_set1_ps(2.0f);
+		const __m128 NegScale = _mm_set1_ps(-SlopeScale);
+		const __m128 One = _mm_set1_ps(1.0f);
+		const __m128 Half = _mm_set1_ps(127.5f);
+		for (; X + 4 <= W; X += 4)
+		{
+			const __m128 L0 = _mm_loadu_ps(R0 + X), C0 = _mm_loadu_ps(R0 + X + 1), Rt0 = _mm_loadu_ps(R0 + X + 2);
+			const __m128 L1 = _mm_loadu_ps(R1 + X),                                 Rt1 = _mm_loadu_ps(R1 + X + 2);
+			const __m128 L2 = _mm_loadu_ps(R2 + X), C2 = _mm_loadu_ps(R2 + X + 1), Rt2 = _mm_loadu_ps(R2 + X + 2);
+
+			const __m128 Gx = _mm_add_ps(_mm_add_ps(_mm_sub_ps(Rt0, L0), _mm_sub_ps(Rt2, L2)), _mm_mul_ps(Two, _mm_sub_ps(Rt1, L1)));
+			const __m128 Gy = _mm_add_ps(_mm_add_ps(_mm_sub_ps(L2, L0), _mm_sub_ps(Rt2, Rt0)), _mm_mul_ps(Two, _mm_sub_ps(C2, C0)));
+
+			// n = normalize(-dz/dx, -dz/dy, 1), encoded as n * 127.5 + 127.5
+			const __m128 Nx = _mm_mul_ps(Gx, NegScale);
+			const __m128 Ny = _mm_mul_ps(Gy, NegScale);
+			const __m128 InvLen = _mm_div_ps(One, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(Nx, Nx), _mm_mul_ps(Ny, Ny)), One)));
+			const __m128i Xi = _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(Nx, InvLen), Half), Half));
+			const __m128i Yi = _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(Ny, InvLen), Half), Half));
+
+			// Interleave to X0 Y0 X1 Y1 ... and narrow to bytes
+			const __m128i XY16 = _mm_packs_epi32(_mm_unpacklo_epi32(Xi, Yi), _mm_unpackhi_epi32(Xi, Yi));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(Dst + X * 2), _mm_packus_epi16(XY16, XY16));
+		}
+#endif
+		for (; X < W; ++X)
+		{
+			const float Gx = (R0[X + 2] - R0[X]) + 2.0f * (R1[X + 2] - R1[X]) + (R2[X + 2] - R2[X]);
+			const float Gy = (R2[X] - R0[X]) + 2.0f * (R2[X + 1] - R0[X + 1]) + (R2[X + 2] - R0[X + 2]);
+			const float Nx = -Gx * SlopeScale;
+			const float Ny = -Gy * SlopeScale;
+			const float InvLen = 1.0f / FMath::Sqrt(Nx * Nx + Ny * Ny + 1.0f);
+			Dst[X * 2 + 0] = (uint8)FMath::Clamp(FMath::RoundToInt32(Nx * InvLen * 127.5f + 127.5f), 0, 255);
+			Dst[X * 2 + 1] = (uint8)FMath::Clamp(FMath::RoundToInt32(Ny * InvLen * 127.5f + 127.5f), 0, 255);
+		}
+	});
+
+	return true;
+}
+
+void FComfyFrameIngest::CropToMask(FComfyIngestResult& Result, const FComfyIngestSettings& Settings, const FIntRect& PreviousCrop)
+{
+	const FComfyDecodedImage& Mask = Result.Mask;
+	FIntRect Bounds;
+	if (!ComputeMaskBounds(Mask, (uint8)FMath::Clamp(Settings.CropMaskThreshold, 0, 254), Bounds))
+	{
+		// Empty mask - nothing to fit, keep the full frame
+		return;
+	}
+
+	const int32 Padding = FMath::Max(0, Settings.CropPadding);
+	Bounds.Min.X = FMath::Max(0, Bounds.Min.X - Padding);
+	Bounds.Min.Y = FMath::Max(0, Bounds.Min.Y - Padding);
+	Bounds.Max.X = FMath::Min(Mask.Width, Bounds.Max.X + Padding);
+	Bounds.Max.Y = FMath::Min(Mask.Height, Bounds.Max.Y + Padding);
+
+	// Snap outward to the coarse grid
+	const int32 CellX = FMath::Max(1, FMath::DivideAndRoundUp(Mask.Width, CropGridCells));
+	const int32 CellY = FMath::Max(1, FMath::DivideAndRoundUp(Mask.Height, CropGridCells));
+	const FIntRect Snapped(
+		(Bounds.Min.X / CellX) * CellX,
+		(Bounds.Min.Y / CellY) * CellY,
+		FMath::Min(Mask.Width, FMath::DivideAndRoundUp(Bounds.Max.X, CellX) * CellX),
+		FMath::Min(Mask.Height, FMath::DivideAndRoundUp(Bounds.Max.Y, CellY) * CellY));
+
+	// Hold the previous crop while the subject still fits and it is not much larger than needed
+	const bool bKeepPrevious = PreviousCrop.Width() > 0 && PreviousCrop.Height() > 0 &&
+		PreviousCrop.Min.X >= 0 && PreviousCrop.Min.Y >= 0 && PreviousCrop.Max.X <= Mask.Width && PreviousCrop.Max.Y <= Mask.Height &&
+		PreviousCrop.Min.X <= Bounds.Min.X && PreviousCrop.Min.Y <= Bounds.Min.Y && PreviousCrop.Max.X >= Bounds.Max.X && PreviousCrop.Max.Y >= Bounds.Max.Y &&
+		int64(PreviousCrop.Width()) * PreviousCrop.Height() <= CropKeepAreaRatio * int64(Snapped.Width()) * Snapped.Height();
+	Bounds = bKeepPrevious ? PreviousCrop : Snapped;
+	Result.CropRect = Bounds;
+
+	// ROI in UV of the full frame
+	const FVector2D FullSize(Mask.Width, Mask.Height);
+	Result.RoiOffset = FVector2D(Bounds.Min.X, Bounds.Min.Y) / FullSize;
+	Result.RoiScale = FVector2D(Bounds.Width(), Bounds.Height()) / FullSize;
+
+	// Channels of a different resolution get the same UV rectangle
+	auto CropChannel = [&Result](FComfyDecodedImage& Image)
+	{
+		if (!Image.IsValid())
+			return;
+		const FIntRect Rect(
+			FMath::FloorToInt32(Result.RoiOffset.X * Image.Width),
+			FMath::FloorToInt32(Result.RoiOffset.Y * Image.Height),
+			FMath::CeilToInt32((Result.RoiOffset.X + Result.RoiScale.X) * Image.Width),
+			FMath::CeilToInt32((Result.RoiOffset.Y + Result.RoiScale.Y) * Image.Height));
+		UComfyPngDecoder::CropImage(Image, Rect);
+	};
+	CropChannel(Result.RGB);
+	CropChannel(Result.Depth);
+	CropChannel(Result.Mask);
+	CropChannel(Result.Normal);
+
+	if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyFrameIngest] Cropped to mask bounds %dx%d at (%d,%d) of %dx%d (%s)"),
+		Bounds.Width(), Bounds.Height(), Bounds.Min.X, Bounds.Min.Y, (int32)FullSize.X, (int32)FullSize.Y,
+		bKeepPrevious ? TEXT("held") : TEXT("new"));
+}
+
+bool FComfyFrameIngest::ComputeMaskBounds(const FComfyDecodedImage& Mask, uint8 Threshold, FIntRect& OutBounds)
+{
+	if (!Mask.IsValid() || !Mask.IsSingleChannel())
+		return false;
+
+	const int32 W = Mask.Width;
+	const int32 H = Mask.Height;
+
+	// 16-bit masks are scanned on their high byte
+	TArray<uint8> Mask8;
+	const uint8* Src = Mask.Pixels.GetData();
+	if (Mask.Format == PF_G16)
+	{
+		Mask8.SetNumUninitialized(W * H);
+		const uint16* Src16 = reinterpret_cast<const uint16*>(Mask.Pixels.GetData());
+		for (int32 i = 0; i < W * H; ++i)
+		{
+			Mask8[i] = static_cast<uint8>(Src16[i] >> 8);
+		}
+		Src = Mask8.GetData();
+	}
+
+	// One pass: per-row max decides the Y range, running per-column max decides the X range
+	TArray<uint8> ColumnMax;
+	ColumnMax.SetNumZeroed(W);
+	int32 MinY = H;
+	int32 MaxY = -1;
+
+	for (int32 Y = 0; Y < H; ++Y)
+	{
+		const uint8* Row = Src + Y * W;
+		bool bRowHit = false;
+		int32 X = 0;
+
+#if PLATFORM_CPU_X86_FAMILY
+		const __m128i Zero = _mm_setzero_si128();
+		__m128i RowMax = Zero;
+		for (; X + 16 <= W; X += 16)
+		{
+			const __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Row + X));
+			__m128i* Col = reinterpret_cast<__m128i*>(ColumnMax.GetData() + X);
+			_mm_storeu_si128(Col, _mm_max_epu8(_mm_loadu_si128(Col), V));
+			RowMax = _mm_max_epu8(RowMax, V);
+		}
+		// Any byte above the threshold leaves a non-zero saturated difference
+		const __m128i Above = _mm_subs_epu8(RowMax, _mm_set1_epi8((char)Threshold));
+		bRowHit = _mm_movemask_epi8(_mm_cmpeq_epi8(Above, Zero)) != 0xFFFF;
+#endif
+
+		for (; X < W; ++X)
+		{
+			ColumnMax[X] = FMath::Max(ColumnMax[X], Row[X]);
+			bRowHit |= Row[X] > Threshold;
+		}
+
+		if (bRowHit)
+		{
+			MinY = FMath::Min(MinY, Y);
+			MaxY = Y;
+		}
+	}
+
+	if (MaxY < 0)
+		return false;
+
+	int32 MinX = 0;
+	while (MinX < W && ColumnMax[MinX] <= Threshold) ++MinX;
+	int32 MaxX = W - 1;
+	while (MaxX > MinX && ColumnMax[MaxX] <= Threshold) --MaxX;
+
+	OutBounds = FIntRect(MinX, MinY, MaxX + 1, MaxY + 1);
+	return true;
+}
+
+void FComfyFrameIngest::AssignChannels(const TArray<TArray<uint8>>& Pngs, TArray<FComfyDecodedImage>& Images, FComfyIngestResult& OutResult)
+{
+	int32 ColoredIndex = INDEX_NONE;
+	TArray<int32> GrayscaleIndices;
+
+	for (int32 i = 0; i < Images.Num(); ++i)
+	{
+		FComfyDecodedImage& Image = Images[i];
+		if (!Image.IsValid())
+		{
+			continue;
+		}
+
+		if (UComfyPngDecoder::IsImageGrayscale(Image))
+		{
+			// Depth/Mask saved as RGB PNGs carry the same value in every channel - keep one
+			UComfyPngDecoder::ConvertToSingleChannel(Image);
+			GrayscaleIndices.Add(i);
+		}
+		else
+		{
+			ColoredIndex = i; // Colored image = RGB
+		}
+	}
+
+	// Assign channels based on grayscale detection and size:
+	// - Colored image = RGB
+	// - Grayscale images: larger = Depth, smaller = Mask
+	// Otherwise fallback to sequential assignment (RGB, Depth, Mask)
+	if (ColoredIndex != INDEX_NONE && GrayscaleIndices.Num() == 2)
+	{
+		const int32 Size0 = Pngs[GrayscaleIndices[0]].Num();
+		const int32 Size1 = Pngs[GrayscaleIndices[1]].Num();
+		const int32 DepthIndex = (Size0 > Size1) ? GrayscaleIndices[0] : GrayscaleIndices[1];
+		const int32 MaskIndex  = (Size0 > Size1) ? GrayscaleIndices[1] : GrayscaleIndices[0];
+
+		OutResult.RGB   = MoveTemp(Images[ColoredIndex]);
+		OutResult.Depth = MoveTemp(Images[DepthIndex]);
+		OutResult.Mask  = MoveTemp(Images[MaskIndex]);
+	}
+	else
+	{
+		if (debug) UE_LOG(LogTemp, Warning, TEXT("[ComfyFrameIngest] Channel detection failed (colored=%d, grayscale=%d), using arrival order"),
+			ColoredIndex != INDEX_NONE ? 1 : 0, GrayscaleIndices.Num());
+
+		if (Images.Num() > 0) OutResult.RGB   = MoveTemp(Images[0]);
+		if (Images.Num() > 1) OutResult.Depth = MoveTemp(Images[1]);
+		if (Images.Num() > 2) OutResult.Mask  = MoveTemp(Images[2]);
+	}
+}
+
+// ============================================================
+// Mask analytics
+// ============================================================
+
+// Coverage-weighted sums over one band of rows (pixel coordinates)
+struct FComfyMaskMomentSums
+{
+	double W = 0.0;
+	double WX = 0.0;
+	double WY = 0.0;
+	double WXX = 0.0;
+	double WYY = 0.0;
+	double WXY = 0.0;
+	double WDepth = 0.0;
+	int32 MinX = MAX_int32;
+	int32 MinY = MAX_int32;
+	int32 MaxX = -1;
+	int32 MaxY = -1;
+};
+
+#if PLATFORM_CPU_X86_FAMILY
+static FORCEINLINE int32 HorizontalSumEpi32(__m128i V)
+{
+	V = _mm_add_epi32(V, _mm_shuffle_epi32(V, _MM_SHUFFLE(1, 0, 3, 2)));
+	V = _mm_add_epi32(V, _mm_shuffle_epi32(V, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(V);
+}
+#endif
+
+// Sum of weights w, w*x and w*x^2 over one 8-bit row (w = value above Threshold, else 0) and the first/last hit.
+// Returns false for a row without hits.
+static bool AccumulateMaskRow(const uint8* Row, int32 W, uint8 Threshold, int64& OutW, int64& OutWX, int64& OutWXX, int32& OutFirst, int32& OutLast)
+{
+	int64 SumW = 0;
+	int64 SumWX = 0;
+	int64 SumWXX = 0;
+	int32 First = -1;
+	int32 Last = -1;
+	int32 X = 0;
+
+#if PLATFORM_CPU_X86_FAMILY
+	// 16 pixels per step: moments relative to the block start (i = 0..15) keep the products in 16-bit inputs,
+	// the block offset is added in 64-bit afterwards
+	const __m128i Zero = _mm_setzero_si128();
+	const __m128i Thresh = _mm_set1_epi8((char)Threshold);
+	const __m128i IndexLo = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m128i IndexHi = _mm_setr_epi16(8, 9, 10, 11, 12, 13, 14, 15);
+	const __m128i SquareLo = _mm_setr_epi16(0, 1, 4, 9, 16, 25, 36, 49);
+	const __m128i SquareHi = _mm_setr_epi16(64, 81, 100, 121, 144, 169, 196, 225);
+	for (; X + 16 <= W; X += 16)
+	{
+		const __m128i V = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Row + X));
+		const __m128i Below = _mm_cmpeq_epi8(_mm_subs_epu8(V, Thresh), Zero);
+		const uint32 Hits = ~uint32(_mm_movemask_epi8(Below)) & 0xFFFFu;
+		if (Hits == 0)
+		{
+			continue;
+		}
+
+		const __m128i Weight = _mm_andnot_si128(Below, V);
+		const __m128i Sad = _mm_sad_epu8(Weight, Zero);
+		const int64 BlockW = _mm_cvtsi128_si32(Sad) + _mm_extract_epi16(Sad, 4);
+		const __m128i Lo = _mm_unpacklo_epi8(Weight, Zero);
+		const __m128i Hi = _mm_unpackhi_epi8(Weight, Zero);
+		const int64 BlockWI = HorizontalSumEpi32(_mm_add_epi32(_mm_madd_epi16(Lo, IndexLo), _mm_madd_epi16(Hi, IndexHi)));
+		const int64 BlockWII = HorizontalSumEpi32(_mm_add_epi32(_mm_madd_epi16(Lo, SquareLo), _mm_madd_epi16(Hi, SquareHi)));
+
+		const int64 X0 = X;
+		SumW += BlockW;
+		SumWX += X0 * BlockW + BlockWI;
+		SumWXX += X0 * X0 * BlockW + 2 * X0 * BlockWI + BlockWII;
+		if (First < 0)
+		{
+			First = X + (int32)FMath::CountTrailingZeros(Hits);
+		}
+		Last = X + (int32)FMath::FloorLog2(Hits);
+	}
+#endif
+
+	for (; X < W; ++X)
+	{
+		const int64 Value = Row[X];
+		if (Value > Threshold)
+		{
+			SumW += Value;
+			SumWX += Value * X;
+			SumWXX += Value * X * X;
+			First = First < 0 ? X : First;
+			Last = X;
+		}
+	}
+
+	OutW = SumW;
+	OutWX = SumWX;
+	OutWXX = SumWXX;
+	OutFirst = First;
+	OutLast = Last;
+	return First >= 0;
+}
+
+bool FComfyFrameIngest::ComputeMaskAnalytics(const FComfyDecodedImage& Mask, const FComfyDecodedImage& Depth, uint8 Threshold, FComfyMaskAnalytics& OutAnalytics)
+{
+	OutAnalytics = FComfyMaskAnalytics();
+	if (!Mask.IsValid() || !Mask.IsSingleChannel())
+		return false;
+
+	const int32 W = Mask.Width;
+	const int32 H = Mask.Height;
+
+	// Depth of another resolution is sampled at the nearest pixel
+	const bool bDepth = Depth.IsValid() && Depth.IsSingleChannel();
+	TArray<int32> DepthColumn;
+	if (bDepth)
+	{
+		DepthColumn.SetNumUninitialized(W);
+		for (int32 X = 0; X < W; ++X)
+		{
+			DepthColumn[X] = FMath::Min(Depth.Width - 1, int32((int64(X) * 2 + 1) * Depth.Width / (int64(W) * 2)));
+		}
+	}
+
+	constexpr int32 BandRows = 32;
+	const int32 NumBands = FMath::DivideAndRoundUp(H, BandRows);
+	TArray<FComfyMaskMomentSums> Bands;
+	Bands.SetNum(NumBands);
+
+	ParallelFor(NumBands, [&](int32 Band)
+	{
+		FComfyMaskMomentSums& Sums = Bands[Band];
+
+		// 16-bit masks are scanned on their high byte
+		TArray<uint8> Row8;
+		if (Mask.Format == PF_G16)
+		{
+			Row8.SetNumUninitialized(W);
+		}
+
+		const int32 YEnd = FMath::Min(H, (Band + 1) * BandRows);
+		for (int32 Y = Band * BandRows; Y < YEnd; ++Y)
+		{
+			const uint8* Row = Mask.Pixels.GetData() + int64(Y) * W * Mask.GetBytesPerPixel();
+			if (Mask.Format == PF_G16)
+			{
+				const uint16* Row16 = reinterpret_cast<const uint16*>(Row);
+				for (int32 X = 0; X < W; ++X)
+				{
+					Row8[X] = static_cast<uint8>(Row16[X] >> 8);
+				}
+				Row = Row8.GetData();
+			}
+
+			int64 RowW, RowWX, RowWXX;
+			int32 First, Last;
+			if (!AccumulateMaskRow(Row, W, Threshold, RowW, RowWX, RowWXX, First, Last))
+			{
+				continue;
+			}
+
+			const double DY = Y;
+			Sums.W += double(RowW);
+			Sums.WX += double(RowWX);
+			Sums.WXX += double(RowWXX);
+			Sums.WY += DY * double(RowW);
+			Sums.WYY += DY * DY * double(RowW);
+			Sums.WXY += DY * double(RowWX);
+			Sums.MinX = FMath::Min(Sums.MinX, First);
+			Sums.MaxX = FMath::Max(Sums.MaxX, Last);
+			Sums.MinY = FMath::Min(Sums.MinY, Y);
+			Sums.MaxY = Y;
+
+			// Mean depth only visits the covered span of the row
+			if (bDepth)
+			{
+				const int32 DepthY = FMath::Min(Depth.Height - 1, int32((int64(Y) * 2 + 1) * Depth.Height / (int64(H) * 2)));
+				const uint8* DepthRow = Depth.Pixels.GetData() + int64(DepthY) * Depth.Width * Depth.GetBytesPerPixel();
+				const bool bDepth16 = Depth.Format == PF_G16;
+				const float DepthNorm = bDepth16 ? 1.0f / 65535.0f : 1.0f / 255.0f;
+				double RowDepth = 0.0;
+				for (int32 X = First; X <= Last; ++X)
+				{
+					if (Row[X] > Threshold)
+					{
+						const int32 DX = DepthColumn[X];
+						const uint32 Value = bDepth16 ? reinterpret_cast<const uint16*>(DepthRow)[DX] : DepthRow[DX];
+						RowDepth += double(Row[X]) * double(Value);
+					}
+				}
+				Sums.WDepth += RowDepth * DepthNorm;
+			}
+		}
+	});
+
+	FComfyMaskMomentSums Total;
+	for (const FComfyMaskMomentSums& Sums : Bands)
+	{
+		Total.W += Sums.W;
+		Total.WX += Sums.WX;
+		Total.WY += Sums.WY;
+		Total.WXX += Sums.WXX;
+		Total.WYY += Sums.WYY;
+		Total.WXY += Sums.WXY;
+		Total.WDepth += Sums.WDepth;
+		Total.MinX = FMath::Min(Total.MinX, Sums.MinX);
+		Total.MinY = FMath::Min(Total.MinY, Sums.MinY);
+		Total.MaxX = FMath::Max(Total.MaxX, Sums.MaxX);
+		Total.MaxY = FMath::Max(Total.MaxY, Sums.MaxY);
+	}
+
+	if (Total.W <= 0.0)
+		return false;
+
+	// Centroid and central moments in pixels (pixel centres at +0.5)
+	const double MeanX = Total.WX / Total.W;
+	const double MeanY = Total.WY / Total.W;
+	const double Mu20 = FMath::Max(0.0, Total.WXX / Total.W - MeanX * MeanX);
+	const double Mu02 = FMath::Max(0.0, Total.WYY / Total.W - MeanY * MeanY);
+	const double Mu11 = Total.WXY / Total.W - MeanX * MeanY;
+
+	// Eigenvalues of the covariance are the squared standard deviations along the principal axes
+	const double HalfTrace = 0.5 * (Mu20 + Mu02);
+	const double Spread = FMath::Sqrt(FMath::Square(0.5 * (Mu20 - Mu02)) + Mu11 * Mu11);
+	const double MajorVariance = HalfTrace + Spread;
+	const double MinorVariance = FMath::Max(0.0, HalfTrace - Spread);
+
+	OutAnalytics.bHasSubject = true;
+	OutAnalytics.BoundsMin = FVector2D(double(Total.MinX) / W, double(Total.MinY) / H);
+	OutAnalytics.BoundsMax = FVector2D(double(Total.MaxX + 1) / W, double(Total.MaxY + 1) / H);
+	OutAnalytics.Area = float(Total.W / (255.0 * double(W) * double(H)));
+	OutAnalytics.Centroid = FVector2D((MeanX + 0.5) / W, (MeanY + 0.5) / H);
+	OutAnalytics.OrientationDegrees = float(FMath::RadiansToDegrees(0.5 * FMath::Atan2(2.0 * Mu11, Mu20 - Mu02)));
+	OutAnalytics.SemiAxes = FVector2D(2.0 * FMath::Sqrt(MajorVariance) / W, 2.0 * FMath::Sqrt(MinorVariance) / W);
+	OutAnalytics.SecondMoments = FVector(Mu20, Mu02, Mu11);
+	OutAnalytics.bHasDepth = bDepth;
+	OutAnalytics.MeanDepth = bDepth ? float(Total.WDepth / Total.W) : 0.0f;
+
+	if (debug) UE_LOG(LogTemp, Verbose, TEXT("[ComfyFrameIngest] Mask analytics: area %.3f, centroid (%.3f, %.3f), orientation %.1f deg, mean depth %.3f"),
+		OutAnalytics.Area, OutAnalytics.Centroid.X, OutAnalytics.Centroid.Y, OutAnalytics.OrientationDegrees, OutAnalytics.MeanDepth);
+	return true;
+}
+
+// ============================================================
+// Mask packing
+// ============================================================
+
+bool FComfyFrameIngest::PackMaskIntoAlpha(FComfyDecodedImage& RGB, const FComfyDecodedImage& Mask)
+{
+	if (RGB.Format != PF_R8G8B8A8 || !RGB.IsValid() || !Mask.IsValid() || !Mask.IsSingleChannel())
+		return false;
+
+	// Channels must line up pixel for pixel
+	if (RGB.Width != Mask.Width || RGB.Height != Mask.Height)
+	{
+		if (debug) UE_LOG(LogTemp, Warning, TEXT("[ComfyFrameIngest] Mask %dx%d does not match RGB %dx%d, not packing"),
+			Mask.Width, Mask.Height, RGB.Width, RGB.Height);
+		return false;
+	}
+
+	const int32 NumPixels = RGB.Width * RGB.Height;
+	uint8* Dst = RGB.Pixels.GetData();
+
+	// 16-bit masks keep their high byte
+	TArray<uint8> Mask8;
+	const uint8* Src = Mask.Pixels.GetData();
+	if (Mask.Format == PF_G16)
+	{
+		Mask8.SetNumUninitialized(NumPixels);
+		const uint16* Src16 = reinterpret_cast<const uint16*>(Mask.Pixels.GetData());
+		for (int32 i = 0; i < NumPixels; ++i)
+		{
+			Mask8[i] = static_cast<uint8>(Src16[i] >> 8);
+		}
+		Src = Mask8.GetData();
+	}
+
+	int32 i = 0;
+
+#if PLATFORM_CPU_X86_FAMILY
+	// 16 pixels per iteration: clear alpha bytes, widen mask bytes to the top byte of each 32-bit pixel, OR in
+	const __m128i RGBKeep = _mm_set1_epi32(0x00FFFFFF);
+	const __m128i Zero = _mm_setzero_si128();
+	for (; i + 16 <= NumPixels; i += 16)
+	{
+		const __m128i M = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + i));
+		const __m128i MLo = _mm_unpacklo_epi8(Zero, M);	// m << 8 as 16-bit, pixels 0-7
+		const __m128i MHi = _mm_unpackhi_epi8(Zero, M);	// pixels 8-15
+		const __m128i A0 = _mm_unpacklo_epi16(Zero, MLo);	// m << 24 as 32-bit, pixels 0-3
+		const __m128i A1 = _mm_unpackhi_epi16(Zero, MLo);
+		const __m128i A2 = _mm_unpacklo_epi16(Zero, MHi);
+		const __m128i A3 = _mm_unpackhi_epi16(Zero, MHi);
+
+		__m128i* P = reinterpret_cast<__m128i*>(Dst + i * 4);
+		_mm_storeu_si128(P + 0, _mm_or_si128(_mm_and_si128(_mm_loadu_si128(P + 0), RGBKeep), A0));
+		_mm_storeu_si128(P + 1, _mm_or_si128(_mm_and_si128(_mm_loadu_si128(P + 1), RGBKeep), A1));
+		_mm_storeu_si128(P + 2, _mm_or_si128(_mm_and_si128(_mm_loadu_si128(P + 2), RGBKeep), A2));
+		_mm_storeu_si128(P + 3, _mm_or_si128(_mm_and_si128(_mm_loadu_si128(P + 3), RGBKeep), A3));
+	}
+#endif
+
+	// Scalar tail (and non-x86 fallback)
+	for (; i < NumPixels; ++i)
+	{
+		Dst[i * 4 + 3] = Src[i];
+	}
+
+	return true;
+}
+
+// ============================================================
+// Tile hashing
+// ============================================================
+
+void FComfyFrameIngest::ComputeTileHashes(const FComfyDecodedImage& Image, int32 TileSize, FComfyTileHashes& OutTiles)
+{
+	OutTiles = FComfyTileHashes();
+	if (!Image.IsValid() || TileSize <= 0)
+		return;
+
+	const int32 Bpp = Image.GetBytesPerPixel();
+	const int32 Pitch = Image.Width * Bpp;
+	OutTiles.TileSize = TileSize;
+	OutTiles.TilesX = FMath::DivideAndRoundUp(Image.Width, TileSize);
+	OutTiles.TilesY = FMath::DivideAndRoundUp(Image.Height, TileSize);
+	OutTiles.Hashes.SetNumUninitialized(OutTiles.TilesX * OutTiles.TilesY);
+
+	// Chain the hash through the rows of each tile (row segments are contiguous in memory)
+	for (int32 TY = 0; TY < OutTiles.TilesY; ++TY)
+	{
+		const int32 Y0 = TY * TileSize;
+		const int32 Y1 = FMath::Min(Y0 + TileSize, Image.Height);
+		for (int32 TX = 0; TX < OutTiles.TilesX; ++TX)
+		{
+			const int32 X0 = TX * TileSize;
+			const int32 RowBytes = (FMath::Min(X0 + TileSize, Image.Width) - X0) * Bpp;
+
+			uint64 Hash = 0;
+			for (int32 Y = Y0; Y < Y1; ++Y)
+			{
+				Hash = CityHash64WithSeed(reinterpret_cast<const char*>(Image.Pixels.GetData() + Y * Pitch + X0 * Bpp), RowBytes, Hash);
+			}
+			OutTiles.Hashes[TY * OutTiles.TilesX + TX] = Hash;
+		}
+	}
+}
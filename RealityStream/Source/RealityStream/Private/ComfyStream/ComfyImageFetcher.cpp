@@ -1,5 +1,8 @@
 #include "ComfyStream/ComfyImageFetcher.h"
 #include "ComfyStream/ComfyPngDecoder.h"
+#include "ComfyStream/ComfyFrameIngest.h"
+#include "IImageWrapperModule.h"
+#include "Modules/ModuleManager.h"
 #include "IWebSocket.h"
 #include "WebSocketsModule.h"
 #include "Async/Async.h"
@@ -29,6 +32,9 @@ void UComfyImageFetcher::StartPolling(const FString& ServerURL, int32 ChannelNum
 	if (!PngDecoder)
 		PngDecoder = NewObject<UComfyPngDecoder>(this);
 
+	// Ingest workers look the module up without loading it
+	FModuleManager::LoadModuleChecked<IImageWrapperModule>("ImageWrapper");
+
 	CurrentServerURL = ServerURL;
 	CurrentChannel = ChannelNumber;
 	bIsPolling = true;
@@ -60,6 +66,17 @@ void UComfyImageFetcher::StopPolling()
 	bReceivingChunks = false;
 	AccumulatedPngMessages.Empty();
 	MessagesSinceLastFrame = 0;
+	PendingIngestPngs.Empty();
+	bIngestInFlight = false;
+	IngestGeneration++;
+	RGBDelta.Reset();
+	DepthDelta.Reset();
+	MaskDelta.Reset();
+	NormalDelta.Reset();
+	TotalTilesUploaded = 0;
+	TotalTiles = 0;
+	LastCropRect = FIntRect();
+	LastIngestTime = 0.0;
 	SetConnectionStatus(EComfyConnectionStatus::Disconnected);
 }
 
@@ -524,210 +541,13 @@ void UComfyImageFetcher::ProcessImageData(const TArray<uint8>& In)
 				continue;
 			}
 			
-			// Identify PNGs by color type (most reliable), fallback to size-based assignment
-			TArray<int32> AssignedIndices;
-			AssignedIndices.SetNum(ExpectedPngCount);
-			AssignedIndices.Init(INDEX_NONE, ExpectedPngCount);
-			
-			// Decode all PNGs first, then check if they're grayscale to assign channels
-			TArray<UTexture2D*> DecodedTextures;
-			DecodedTextures.SetNum(ExpectedPngCount);
-			
-			// Helper function to check if a texture is grayscale (R=G=B for sampled pixels)
-			auto IsTextureGrayscale = [](UTexture2D* Texture) -> bool
-			{
-				if (!Texture || !Texture->GetPlatformData() || Texture->GetPlatformData()->Mips.Num() == 0)
-				{
-					return false;
-				}
-				
-				FTexture2DMipMap& Mip = Texture->GetPlatformData()->Mips[0];
-				if (!Mip.BulkData.GetBulkDataSize())
-				{
-					return false;
-				}
-				
-				const int32 Width = Texture->GetSizeX();
-				const int32 Height = Texture->GetSizeY();
-				if (Width <= 0 || Height <= 0)
-				{
-					return false;
-				}
-				
-				// Lock texture for reading
-				const FColor* Pixels = static_cast<const FColor*>(Mip.BulkData.LockReadOnly());
-				if (!Pixels)
-				{
-					return false;
-				}
-				
-				// Sample pixels to check if grayscale (R=G=B)
-				// Sample a grid of pixels (every Nth pixel) to avoid checking all pixels
-				const int32 SampleStep = FMath::Max(1, FMath::Min(Width, Height) / 20); // Sample ~20x20 grid
-				int32 GrayscaleCount = 0;
-				int32 TotalSamples = 0;
-				const int32 MaxSamples = 400; // Limit to 400 samples max
-				
-				for (int32 Y = 0; Y < Height && TotalSamples < MaxSamples; Y += SampleStep)
-				{
-					for (int32 X = 0; X < Width && TotalSamples < MaxSamples; X += SampleStep)
-					{
-						int32 Index = Y * Width + X;
-						if (Index < Width * Height)
-						{
-							const FColor& Pixel = Pixels[Index];
-							// Check if R=G=B (grayscale) with small tolerance for compression artifacts
-							const int32 Tolerance = 2; // Allow 2 levels of difference
-							if (FMath::Abs((int32)Pixel.R - (int32)Pixel.G) <= Tolerance &&
-							    FMath::Abs((int32)Pixel.G - (int32)Pixel.B) <= Tolerance)
-							{
-								GrayscaleCount++;
-							}
-							TotalSamples++;
-						}
-					}
-				}
-				
-				Mip.BulkData.Unlock();
-				
-				// If 95%+ of sampled pixels are grayscale, consider it grayscale
-				return TotalSamples > 0 && (GrayscaleCount * 100 / TotalSamples) >= 95;
-			};
-			
-			// First pass: decode all PNGs and check if they're grayscale
-			if (!PngDecoder) return;
-			TArray<bool> IsGrayscale;
-			IsGrayscale.SetNum(ExpectedPngCount);
-			int32 ColoredIndex = INDEX_NONE;
-			TArray<int32> GrayscaleIndices;
-			
+			// Hand the triplet to the worker-thread ingest (decode, channel assignment, packing)
+			TArray<TArray<uint8>> FramePngs;
 			for (int32 i = 0; i < ExpectedPngCount; ++i)
 			{
-				UTexture2D* Tex = PngDecoder->DecodePNGToTexture(AccumulatedPngMessages[i]);
-				DecodedTextures[i] = Tex;
-				
-				if (Tex)
-				{
-					IsGrayscale[i] = IsTextureGrayscale(Tex);
-					if (IsGrayscale[i])
-					{
-						GrayscaleIndices.Add(i);
-					}
-					else
-					{
-						ColoredIndex = i; // Colored image = RGB
-					}
-				}
-			}
-			
-			// Assign channels based on grayscale detection and size:
-			// - Colored image = RGB (index 0)
-			// - Grayscale images: larger = Depth (index 1), smaller = Mask (index 2)
-			// If we have exactly 1 colored and 2 grayscale, assign correctly
-			// Otherwise fallback to sequential assignment
-			if (ColoredIndex != INDEX_NONE && GrayscaleIndices.Num() == 2)
-			{
-				AssignedIndices[ColoredIndex] = 0; // RGB
-				
-				// Use size to distinguish Depth (larger) from Mask (smaller)
-				int32 Size0 = AccumulatedPngMessages[GrayscaleIndices[0]].Num();
-				int32 Size1 = AccumulatedPngMessages[GrayscaleIndices[1]].Num();
-				
-				if (Size0 > Size1)
-				{
-					// First grayscale is larger = Depth
-					AssignedIndices[GrayscaleIndices[0]] = 1; // Depth
-					AssignedIndices[GrayscaleIndices[1]] = 2; // Mask
-				}
-				else
-				{
-					// Second grayscale is larger = Depth
-					AssignedIndices[GrayscaleIndices[0]] = 2; // Mask
-					AssignedIndices[GrayscaleIndices[1]] = 1; // Depth
-				}
-			}
-			else
-			{
-				// Fallback to sequential assignment if detection fails
-				for (int32 i = 0; i < ExpectedPngCount; ++i)
-				{
-					AssignedIndices[i] = i;
-				}
-			}
-			
-			// Second pass: broadcast textures in CORRECT channel index order (RGB=0, Depth=1, Mask=2)
-			// This ensures HandleStreamTexture receives them in the correct order to assign to correct slots
-			int32 SuccessfullyBroadcast = 0;
-			
-			// Broadcast RGB first (always index 0)
-			if (AssignedIndices.Contains(0))
-			{
-				int32 RGBIndex = INDEX_NONE;
-				for (int32 i = 0; i < ExpectedPngCount; ++i)
-				{
-					if (AssignedIndices[i] == 0)
-					{
-						RGBIndex = i;
-						break;
-					}
-				}
-				if (RGBIndex != INDEX_NONE && DecodedTextures[RGBIndex])
-				{
-					if(debug) UE_LOG(LogTemp, Display, TEXT("[ComfyImageFetcher] Broadcasting RGB texture (FrameBuffer index 0) - texture %d"), RGBIndex);
-					OnTextureReceived.Broadcast(DecodedTextures[RGBIndex]);
-					SuccessfullyBroadcast++;
-				}
+				FramePngs.Add(MoveTemp(AccumulatedPngMessages[i]));
 			}
-			
-			// Broadcast Depth second (index 1, optional)
-			if (AssignedIndices.Contains(1))
-			{
-				int32 DepthIndex = INDEX_NONE;
-				for (int32 i = 0; i < ExpectedPngCount; ++i)
-				{
-					if (AssignedIndices[i] == 1)
-					{
-						DepthIndex = i;
-						break;
-					}
-				}
-				if (DepthIndex != INDEX_NONE && DecodedTextures[DepthIndex])
-				{
-					if(debug) UE_LOG(LogTemp, Display, TEXT("[ComfyImageFetcher] Broadcasting Depth texture (FrameBuffer index 1) - texture %d"), DepthIndex);
-					OnTextureReceived.Broadcast(DecodedTextures[DepthIndex]);
-					SuccessfullyBroadcast++;
-				}
-			}
-			else
-			{
-				if(debug) UE_LOG(LogTemp, Verbose, TEXT("[ComfyImageFetcher] Depth texture missing (optional)"));
-			}
-			
-			// Broadcast Mask third (always index 2)
-			if (AssignedIndices.Contains(2))
-			{
-				int32 MaskIndex = INDEX_NONE;
-				for (int32 i = 0; i < ExpectedPngCount; ++i)
-				{
-					if (AssignedIndices[i] == 2)
-					{
-						MaskIndex = i;
-						break;
-					}
-				}
-				if (MaskIndex != INDEX_NONE && DecodedTextures[MaskIndex])
-				{
-					if(debug) UE_LOG(LogTemp, Display, TEXT("[ComfyImageFetcher] Broadcasting Mask texture (FrameBuffer index 2) - texture %d"), MaskIndex);
-					OnTextureReceived.Broadcast(DecodedTextures[MaskIndex]);
-					SuccessfullyBroadcast++;
-				}
-			}
-			
-			if(debug) UE_LOG(LogTemp, Display, TEXT("[ComfyImageFetcher] Successfully processed and broadcast %d textures in order RGB->Depth->Mask (RGB=%s, Depth=%s, Mask=%s)"), 
-				SuccessfullyBroadcast,
-				AssignedIndices.Contains(0) ? TEXT("YES") : TEXT("NO"),
-				AssignedIndices.Contains(1) ? TEXT("YES") : TEXT("NO"),
-				AssignedIndices.Contains(2) ? TEXT("YES") : TEXT("NO"));
+			QueueFrameIngest(MoveTemp(FramePngs));
 			
 			// Remove processed PNGs from accumulator
 			AccumulatedPngMessages.RemoveAt(0, ExpectedPngCount, EAllowShrinking::No);
@@ -736,6 +556,176 @@ void UComfyImageFetcher::ProcessImageData(const TArray<uint8>& In)
 	}
 }
 
+// ============================================================
+// FRAME INGEST (WORKER THREAD)
+// ============================================================
+
+void UComfyImageFetcher::QueueFrameIngest(TArray<TArray<uint8>>&& Pngs)
+{
+	// Only the newest triplet waits - if the worker is busy, an older pending frame is dropped
+	if (PendingIngestPngs.Num() > 0)
+	{
+		IngestStats.FramesDropped++;
+		if(debug) UE_LOG(LogTemp, Display, TEXT("[ComfyImageFetcher] Ingest busy, dropping older pending frame"));
+	}
+	PendingIngestPngs = MoveTemp(Pngs);
+
+	if (!bIngestInFlight)
+	{
+		StartFrameIngest();
+	}
+}
+
+void UComfyImageFetcher::StartFrameIngest()
+{
+	if (PendingIngestPngs.Num() == 0)
+	{
+		return;
+	}
+
+	bIngestInFlight = true;
+
+	TSharedPtr<TArray<TArray<uint8>>, ESPMode::ThreadSafe> Pngs = MakeShared<TArray<TArray<uint8>>, ESPMode::ThreadSafe>(MoveTemp(PendingIngestPngs));
+	PendingIngestPngs.Reset();
+
+	const FComfyIngestSettings Settings = IngestSettings;
+	const FIntRect PreviousCrop = LastCropRect;
+	const uint32 Generation = IngestGeneration;
+	TWeakObjectPtr<UComfyImageFetcher> WeakThis(this);
+
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Pngs, Settings, PreviousCrop, Generation]()
+	{
+		TSharedPtr<FComfyIngestResult, ESPMode::ThreadSafe> Result = MakeShared<FComfyIngestResult, ESPMode::ThreadSafe>();
+		FComfyFrameIngest::ProcessTriplet(*Pngs, Settings, *Result, PreviousCrop);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Result, Generation]()
+		{
+			UComfyImageFetcher* Fetcher = WeakThis.Get();
+			if (!Fetcher || Fetcher->IngestGeneration != Generation)
+			{
+				return; // Fetcher destroyed or polling restarted while the worker ran
+			}
+
+			Fetcher->bIngestInFlight = false;
+			Fetcher->OnFrameIngested(*Result);
+
+			// Continue with the newest triplet that arrived meanwhile
+			Fetcher->StartFrameIngest();
+		});
+	});
+}
+
+void UComfyImageFetcher::OnFrameIngested(FComfyIngestResult& Result)
+{
+	if (!Result.IsComplete() || !PngDecoder)
+	{
+		if(debug) UE_LOG(LogTemp, Warning, TEXT("[ComfyImageFetcher] Ingest produced incomplete frame (RGB=%s, Mask=%s), skipping"),
+			Result.RGB.IsValid() ? TEXT("YES") : TEXT("NO"),
+			(Result.bMaskPacked || Result.Mask.IsValid()) ? TEXT("YES") : TEXT("NO"));
+		return;
+	}
+
+	const int32 Width = Result.RGB.Width;
+	const int32 Height = Result.RGB.Height;
+	const int32 NumMips = Result.RGB.GetNumMips();
+
+	// Pixels become shared and immutable: textures upload from them and the frame keeps them for CPU readers
+	auto MakeRef = [](FComfyDecodedImage& Image) -> FComfyImageRef
+	{
+		return Image.IsValid() ? FComfyImageRef(MakeShared<FComfyDecodedImage, ESPMode::ThreadSafe>(MoveTemp(Image))) : FComfyImageRef();
+	};
+	FComfyFrame Frame;
+	Frame.RGBPixels = MakeRef(Result.RGB);
+	Frame.DepthPixels = MakeRef(Result.Depth);
+	Frame.MaskPixels = Result.bMaskPacked ? Frame.RGBPixels : MakeRef(Result.Mask);
+	Frame.NormalPixels = MakeRef(Result.Normal);
+
+	// Texture creation and upload must happen on the game thread
+	const double UploadStart = FPlatformTime::Seconds();
+	int32 TilesUploaded = 0;
+	int32 TilesTotal = 0;
+	if (IngestSettings.bDeltaUploads && Result.RGBTiles.Hashes.Num() > 0)
+	{
+		// Persistent textures, only changed tiles are uploaded (pixel buffers are handed to the render thread).
+		// The frame holds the ring leases so its textures are not rewritten while any copy of it is kept.
+		auto UploadDelta = [&Frame, &TilesUploaded, &TilesTotal](FComfyDeltaTexture& Channel, const FComfyImageRef& Image, const FComfyTileHashes& Tiles) -> UTexture2D*
+		{
+			int32 Uploaded = 0;
+			int32 Total = 0;
+			FComfyTextureLeaseRef Lease;
+			UTexture2D* Texture = Channel.Upload(Image, Tiles, Lease, Uploaded, Total);
+			if (Lease.IsValid())
+			{
+				Frame.TextureLeases.Add(MoveTemp(Lease));
+			}
+			TilesUploaded += Uploaded;
+			TilesTotal += Total;
+			return Texture;
+		};
+		Frame.RGB = UploadDelta(RGBDelta, Frame.RGBPixels, Result.RGBTiles);
+		Frame.Depth = Frame.DepthPixels ? UploadDelta(DepthDelta, Frame.DepthPixels, Result.DepthTiles) : nullptr;
+		Frame.Mask = Result.bMaskPacked ? Frame.RGB : UploadDelta(MaskDelta, Frame.MaskPixels, Result.MaskTiles);
+		Frame.Normal = Frame.NormalPixels ? UploadDelta(NormalDelta, Frame.NormalPixels, Result.NormalTiles) : nullptr;
+	}
+	else
+	{
+		Frame.RGB = UComfyPngDecoder::CreateTextureFromImage(*Frame.RGBPixels);
+		Frame.Depth = Frame.DepthPixels ? UComfyPngDecoder::CreateTextureFromImage(*Frame.DepthPixels) : nullptr;
+		Frame.Mask = Result.bMaskPacked ? Frame.RGB : UComfyPngDecoder::CreateTextureFromImage(*Frame.MaskPixels);
+		Frame.Normal = Frame.NormalPixels ? UComfyPngDecoder::CreateTextureFromImage(*Frame.NormalPixels) : nullptr;
+	}
+
+	Frame.RoiOffset = Result.RoiOffset;
+	Frame.RoiScale = Result.RoiScale;
+	LastCropRect = Result.CropRect;
+	Frame.Analytics = Result.Analytics;
+	Frame.ArrivalTime = UploadStart;
+
+	// Stage timings come from the worker; keep the running counters
+	const int32 FramesDropped = IngestStats.FramesDropped;
+	const int32 FramesIngested = IngestStats.FramesIngested;
+	IngestStats = Result.Stats;
+	IngestStats.UploadMs = float((FPlatformTime::Seconds() - UploadStart) * 1000.0);
+	IngestStats.FramesDropped = FramesDropped;
+	IngestStats.FramesIngested = FramesIngested + 1;
+	Frame.FrameNumber = IngestStats.FramesIngested;
+	IngestStats.FrameIntervalMs = LastIngestTime > 0.0 ? float((UploadStart - LastIngestTime) * 1000.0) : 0.0f;
+	LastIngestTime = UploadStart;
+
+	// Full uploads count every tile
+	IngestStats.TilesUploaded = TilesUploaded;
+	IngestStats.TilesTotal = TilesTotal;
+	IngestStats.UploadedTileFraction = TilesTotal > 0 ? float(TilesUploaded) / float(TilesTotal) : 1.0f;
+	if (TilesTotal > 0)
+	{
+		TotalTilesUploaded += TilesUploaded;
+		TotalTiles += TilesTotal;
+	}
+	IngestStats.AverageUploadedTileFraction = TotalTiles > 0 ? float(double(TotalTilesUploaded) / double(TotalTiles)) : 1.0f;
+
+	if (!Frame.IsComplete())
+	{
+		return;
+	}
+
+	// Per-texture events in channel order RGB -> Depth -> Mask (packed frames have no separate mask)
+	OnTextureReceived.Broadcast(Frame.RGB);
+	if (Frame.Depth) OnTextureReceived.Broadcast(Frame.Depth);
+	if (!Frame.IsMaskPacked()) OnTextureReceived.Broadcast(Frame.Mask);
+
+	if(debug) UE_LOG(LogTemp, Display, TEXT("[ComfyImageFetcher] Frame ready (RGB=%dx%d, Depth=%s, Normal=%s, MaskPacked=%s, Mips=%d) worker %.2f ms [decode %.2f, upscale %.2f, downscale %.2f, normals %.2f, crop %.2f, pack %.2f, mips %.2f, hash %.2f], upload %.2f ms, tiles %d/%d"),
+		Width, Height,
+		Frame.Depth ? TEXT("YES") : TEXT("NO"),
+		Frame.Normal ? TEXT("YES") : TEXT("NO"),
+		Frame.IsMaskPacked() ? TEXT("YES") : TEXT("NO"),
+		NumMips,
+		IngestStats.WorkerMs, IngestStats.DecodeMs, IngestStats.UpscaleMs, IngestStats.DownscaleMs, IngestStats.NormalMs, IngestStats.CropMs, IngestStats.PackMs, IngestStats.MipMs, IngestStats.HashMs,
+		IngestStats.UploadMs, IngestStats.TilesUploaded, IngestStats.TilesTotal);
+
+	OnFullFrameReadyNative.Broadcast(Frame);
+	OnFullFrameReady.Broadcast(Frame);
+}
+
 // ============================================================
 
 FString UComfyImageFetcher::BuildWebSocketURL(const FString& ServerURL, int32 ChannelNumber)
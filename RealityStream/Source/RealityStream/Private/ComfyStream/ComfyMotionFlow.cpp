@@ -0,0 +1,366 @@
+#include "ComfyStream/ComfyMotionFlow.h"
+#include "Async/ParallelFor.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#endif
+
+static bool debug = false;
+//Block-matching optical flow between streamed frames, used for motion-compensated interpolation
+
+static constexpr int32 FlowBlock = 8;			// block edge in pixels at every pyramid level
+static constexpr int32 MaxPyramidLevels = 4;
+static constexpr int32 MinLevelSize = 48;		// coarsest level keeps at least this many pixels on its short side
+static constexpr int32 CoarseSearchRadius = 4;	// full search at the coarsest level
+static constexpr int32 RefineSearchRadius = 1;	// around the upsampled vector on finer levels
+static constexpr uint32 MotionPenalty = 4;		// SAD units per pixel of deviation from the predicted vector
+static constexpr uint8 CoverageThreshold = 8;
+
+FVector2f FComfyFlowField::Sample(float X, float Y) const
+{
+	if (!IsValid())
+		return FVector2f::ZeroVector;
+
+	const float GX = FMath::Clamp(X / BlockSize - 0.5f, 0.0f, float(BlocksX - 1));
+	const float GY = FMath::Clamp(Y / BlockSize - 0.5f, 0.0f, float(BlocksY - 1));
+	const int32 X0 = FMath::FloorToInt32(GX);
+	const int32 Y0 = FMath::FloorToInt32(GY);
+	const int32 X1 = FMath::Min(X0 + 1, BlocksX - 1);
+	const int32 Y1 = FMath::Min(Y0 + 1, BlocksY - 1);
+	const float FX = GX - X0;
+	const float FY = GY - Y0;
+	const FVector2f Top = FMath::Lerp(Vectors[Y0 * BlocksX + X0], Vectors[Y0 * BlocksX + X1], FX);
+	const FVector2f Bottom = FMath::Lerp(Vectors[Y1 * BlocksX + X0], Vectors[Y1 * BlocksX + X1], FX);
+	return FMath::Lerp(Top, Bottom, FY);
+}
+
+// ============================================================
+// Estimation
+// ============================================================
+
+// Sum of absolute differences of two 8x8 blocks (two rows per SSE2 register)
+static uint32 BlockSAD(const uint8* A, const uint8* B, int32 Pitch)
+{
+#if PLATFORM_CPU_X86_FAMILY
+	__m128i Acc = _mm_setzero_si128();
+	for (int32 Row = 0; Row < FlowBlock; Row += 2)
+	{
+		const __m128i VA = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(A + Row * Pitch)),
+		                                      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(A + (Row + 1) * Pitch)));
+		const __m128i VB = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(B + Row * Pitch)),
+		                                      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(B + (Row + 1) * Pitch)));
+		Acc = _mm_add_epi64(Acc, _mm_sad_epu8(VA, VB));
+	}
+	return uint32(_mm_cvtsi128_si32(Acc)) + uint32(_mm_cvtsi128_si32(_mm_srli_si128(Acc, 8)));
+#else
+	uint32 Sum = 0;
+	for (int32 Row = 0; Row < FlowBlock; ++Row)
+	{
+		for (int32 X = 0; X < FlowBlock; ++X)
+		{
+			Sum += FMath::Abs(int32(A[Row * Pitch + X]) - int32(B[Row * Pitch + X]));
+		}
+	}
+	return Sum;
+#endif
+}
+
+struct FComfyLumaLevel
+{
+	int32 Width = 0;
+	int32 Height = 0;
+	TArray<uint8> From;
+	TArray<uint8> To;
+};
+
+bool FComfyMotionFlow::EstimateFlow(const FComfyDecodedImage& From, const FComfyDecodedImage& To,
+                                    const FComfyDecodedImage* FromMask, const FComfyDecodedImage* ToMask, FComfyFlowField& OutFlow)
+{
+	OutFlow = FComfyFlowField();
+	if (!From.IsValid() || !To.IsValid() || From.Width != To.Width || From.Height != To.Height ||
+	    From.Width < FlowBlock * 2 || From.Height < FlowBlock * 2)
+		return false;
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 W = From.Width;
+	const int32 H = From.Height;
+
+	// Luma pyramid (same 2x2 SSE2 kernel as the ingest downscale)
+	TArray<FComfyLumaLevel> Levels;
+	Levels.AddDefaulted();
+	Levels[0].Width = W;
+	Levels[0].Height = H;
+	ComputeLuma(From, Levels[0].From);
+	ComputeLuma(To, Levels[0].To);
+	while (Levels.Num() < MaxPyramidLevels && FMath::Min(Levels.Last().Width, Levels.Last().Height) / 2 >= MinLevelSize)
+	{
+		FComfyLumaLevel Next;
+		const FComfyLumaLevel& Prev = Levels.Last();
+		Next.Width = Prev.Width / 2;
+		Next.Height = Prev.Height / 2;
+		Next.From.SetNumUninitialized(Next.Width * Next.Height);
+		Next.To.SetNumUninitialized(Next.Width * Next.Height);
+		UComfyPngDecoder::DownsampleHalf(Prev.From.GetData(), Prev.Width, Prev.Height, PF_G8, Next.From.GetData());
+		UComfyPngDecoder::DownsampleHalf(Prev.To.GetData(), Prev.Width, Prev.Height, PF_G8, Next.To.GetData());
+		Levels.Add(MoveTemp(Next));
+	}
+
+	// Blocks (level 0) touched by the subject in either frame; the rest is treated as static background
+	const int32 BlocksX0 = FMath::DivideAndRoundUp(W, FlowBlock);
+	const int32 BlocksY0 = FMath::DivideAndRoundUp(H, FlowBlock);
+	TArray<uint8> Active0;
+	Active0.Init(1, BlocksX0 * BlocksY0);
+	if (FromMask || ToMask)
+	{
+		TArray<uint8> Coverage;
+		Coverage.Init(0, W * H);
+		for (const FComfyDecodedImage* Mask : { FromMask, ToMask })
+		{
+			if (!Mask || !Mask->IsValid())
+				continue;
+			TArray<uint8> MaskCoverage;
+			ComputeCoverage(*Mask, W, H, MaskCoverage);
+			for (int32 i = 0; i < W * H; ++i)
+			{
+				Coverage[i] = FMath::Max(Coverage[i], MaskCoverage[i]);
+			}
+		}
+		ParallelFor(BlocksY0, [&](int32 BY)
+		{
+			for (int32 BX = 0; BX < BlocksX0; ++BX)
+			{
+				uint8 Any = 0;
+				for (int32 Y = BY * FlowBlock; Y < FMath::Min(H, (BY + 1) * FlowBlock) && !Any; ++Y)
+				{
+					for (int32 X = BX * FlowBlock; X < FMath::Min(W, (BX + 1) * FlowBlock); ++X)
+					{
+						if (Coverage[Y * W + X] > CoverageThreshold) { Any = 1; break; }
+					}
+				}
+				Active0[BY * BlocksX0 + BX] = Any;
+			}
+		});
+	}
+
+	// Coarse to fine: full search on the coarsest level, then refine the doubled vector of the parent block
+	TArray<FIntPoint> Parent;
+	int32 ParentBX = 0;
+	int32 ParentBY = 0;
+	for (int32 L = Levels.Num() - 1; L >= 0; --L)
+	{
+		const FComfyLumaLevel& Level = Levels[L];
+		const int32 LW = Level.Width;
+		const int32 LH = Level.Height;
+		const int32 BlocksX = FMath::DivideAndRoundUp(LW, FlowBlock);
+		const int32 BlocksY = FMath::DivideAndRoundUp(LH, FlowBlock);
+		const bool bCoarsest = (L == Levels.Num() - 1);
+		const int32 Radius = bCoarsest ? CoarseSearchRadius : RefineSearchRadius;
+
+		TArray<FIntPoint> Vectors;
+		Vectors.Init(FIntPoint::ZeroValue, BlocksX * BlocksY);
+		ParallelFor(BlocksY, [&](int32 BY)
+		{
+			for (int32 BX = 0; BX < BlocksX; ++BX)
+			{
+				// A level-L block spans 2^L x 2^L level-0 blocks
+				bool bActive = false;
+				for (int32 Y0 = BY << L; Y0 < FMath::Min(BlocksY0, (BY + 1) << L) && !bActive; ++Y0)
+				{
+					for (int32 X0 = BX << L; X0 < FMath::Min(BlocksX0, (BX + 1) << L); ++X0)
+					{
+						if (Active0[Y0 * BlocksX0 + X0]) { bActive = true; break; }
+					}
+				}
+				if (!bActive)
+					continue;
+
+				const FIntPoint Predicted = bCoarsest ? FIntPoint::ZeroValue :
+					Parent[FMath::Min(BY / 2, ParentBY - 1) * ParentBX + FMath::Min(BX / 2, ParentBX - 1)] * 2;
+
+				// Edge blocks are shifted inside the image
+				const int32 SX = FMath::Min(BX * FlowBlock, LW - FlowBlock);
+				const int32 SY = FMath::Min(BY * FlowBlock, LH - FlowBlock);
+				const uint8* Src = Level.From.GetData() + SY * LW + SX;
+				auto Cost = [&](const FIntPoint& V) -> uint32
+				{
+					const int32 TX = SX + V.X;
+					const int32 TY = SY + V.Y;
+					if (TX < 0 || TY < 0 || TX + FlowBlock > LW || TY + FlowBlock > LH)
+						return MAX_uint32;
+					const uint32 Deviation = FMath::Abs(V.X - Predicted.X) + FMath::Abs(V.Y - Predicted.Y);
+					return BlockSAD(Src, Level.To.GetData() + TY * LW + TX, LW) + MotionPenalty * Deviation;
+				};
+
+				FIntPoint Best = FIntPoint::ZeroValue;
+				uint32 BestCost = Cost(Best);
+				for (int32 DY = -Radius; DY <= Radius; ++DY)
+				{
+					for (int32 DX = -Radius; DX <= Radius; ++DX)
+					{
+						const FIntPoint Candidate = Predicted + FIntPoint(DX, DY);
+						const uint32 CandidateCost = Cost(Candidate);
+						if (CandidateCost < BestCost)
+						{
+							BestCost = CandidateCost;
+							Best = Candidate;
+						}
+					}
+				}
+				Vectors[BY * BlocksX + BX] = Best;
+			}
+		});
+
+		Parent = MoveTemp(Vectors);
+		ParentBX = BlocksX;
+		ParentBY = BlocksY;
+	}
+
+	// 3x3 component-wise median removes isolated mismatches (textureless blocks)
+	OutFlow.Width = W;
+	OutFlow.Height = H;
+	OutFlow.BlockSize = FlowBlock;
+	OutFlow.BlocksX = ParentBX;
+	OutFlow.BlocksY = ParentBY;
+	OutFlow.Vectors.SetNumUninitialized(ParentBX * ParentBY);
+	ParallelFor(ParentBY, [&](int32 BY)
+	{
+		for (int32 BX = 0; BX < ParentBX; ++BX)
+		{
+			TArray<int32, TInlineAllocator<9>> Xs;
+			TArray<int32, TInlineAllocator<9>> Ys;
+			for (int32 NY = FMath::Max(0, BY - 1); NY <= FMath::Min(ParentBY - 1, BY + 1); ++NY)
+			{
+				for (int32 NX = FMath::Max(0, BX - 1); NX <= FMath::Min(ParentBX - 1, BX + 1); ++NX)
+				{
+					Xs.Add(Parent[NY * ParentBX + NX].X);
+					Ys.Add(Parent[NY * ParentBX + NX].Y);
+				}
+			}
+			Xs.Sort();
+			Ys.Sort();
+			const bool bActive = Active0[BY * BlocksX0 + BX] != 0;
+			OutFlow.Vectors[BY * ParentBX + BX] = bActive ? FVector2f(Xs[Xs.Num() / 2], Ys[Ys.Num() / 2]) : FVector2f::ZeroVector;
+		}
+	});
+
+	if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyMotionFlow] Flow %dx%d blocks over %d levels in %.2f ms"),
+		ParentBX, ParentBY, Levels.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return true;
+}
+
+void FComfyMotionFlow::ComputeLuma(const FComfyDecodedImage& Image, TArray<uint8>& OutLuma)
+{
+	const int32 NumPixels = Image.Width * Image.Height;
+	OutLuma.SetNumUninitialized(NumPixels);
+	const uint8* Src = Image.Pixels.GetData();
+	switch (Image.Format)
+	{
+	case PF_G8:
+		FMemory::Memcpy(OutLuma.GetData(), Src, NumPixels);
+		break;
+	case PF_G16:
+		for (int32 i = 0; i < NumPixels; ++i) OutLuma[i] = Src[i * 2 + 1];
+		break;
+	case PF_R8G8B8A8:
+		// BT.601 weights in 8.8 fixed point
+		for (int32 i = 0; i < NumPixels; ++i) OutLuma[i] = uint8((Src[i * 4 + 0] * 77 + Src[i * 4 + 1] * 150 + Src[i * 4 + 2] * 29) >> 8);
+		break;
+	default:
+		{
+			const int32 Bpp = Image.GetBytesPerPixel();
+			for (int32 i = 0; i < NumPixels; ++i) OutLuma[i] = Src[i * Bpp];
+		}
+		break;
+	}
+}
+
+void FComfyMotionFlow::ComputeCoverage(const FComfyDecodedImage& Mask, int32 Width, int32 Height, TArray<uint8>& OutCoverage)
+{
+	// Masks of another size are sampled nearest
+	OutCoverage.SetNumUninitialized(Width * Height);
+	const int32 Bpp = Mask.GetBytesPerPixel();
+	const int32 Channel = (Mask.Format == PF_G16) ? 1 : (Bpp == 4 ? 3 : 0);
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		const int32 MY = FMath::Min(Y * Mask.Height / Height, Mask.Height - 1);
+		for (int32 X = 0; X < Width; ++X)
+		{
+			const int32 MX = FMath::Min(X * Mask.Width / Width, Mask.Width - 1);
+			OutCoverage[Y * Width + X] = Mask.Pixels[(MY * Mask.Width + MX) * Bpp + Channel];
+		}
+	}
+}
+
+// ============================================================
+// Warp
+// ============================================================
+
+void FComfyMotionFlow::WarpBlend(const FComfyDecodedImage& From, const FComfyDecodedImage& To, const FComfyFlowField& Flow, float T, uint8* Dst)
+{
+	const int32 W = From.Width;
+	const int32 H = From.Height;
+	const bool b16 = (From.Format == PF_G16);
+	const int32 C = b16 ? 1 : From.GetBytesPerPixel();
+	T = FMath::Clamp(T, 0.0f, 1.0f);
+
+	// Flow may come from a channel of another resolution
+	const float ToFlowX = float(Flow.Width) / float(W);
+	const float ToFlowY = float(Flow.Height) / float(H);
+
+	// Bilinear sample of all channels at (X, Y), clamped to the image
+	auto SampleBilinear = [W, H, C, b16](const FComfyDecodedImage& Image, float X, float Y, float* Out)
+	{
+		X = FMath::Clamp(X, 0.0f, float(W - 1));
+		Y = FMath::Clamp(Y, 0.0f, float(H - 1));
+		const int32 X0 = FMath::FloorToInt32(X);
+		const int32 Y0 = FMath::FloorToInt32(Y);
+		const int32 X1 = FMath::Min(X0 + 1, W - 1);
+		const int32 Y1 = FMath::Min(Y0 + 1, H - 1);
+		const float FX = X - X0;
+		const float FY = Y - Y0;
+		const float W00 = (1.0f - FX) * (1.0f - FY), W10 = FX * (1.0f - FY), W01 = (1.0f - FX) * FY, W11 = FX * FY;
+		const int32 I00 = Y0 * W + X0, I10 = Y0 * W + X1, I01 = Y1 * W + X0, I11 = Y1 * W + X1;
+		if (b16)
+		{
+			const uint16* P = reinterpret_cast<const uint16*>(Image.Pixels.GetData());
+			Out[0] = P[I00] * W00 + P[I10] * W10 + P[I01] * W01 + P[I11] * W11;
+			return;
+		}
+		const uint8* P = Image.Pixels.GetData();
+		for (int32 Ch = 0; Ch < C; ++Ch)
+		{
+			Out[Ch] = P[I00 * C + Ch] * W00 + P[I10 * C + Ch] * W10 + P[I01 * C + Ch] * W01 + P[I11 * C + Ch] * W11;
+		}
+	};
+
+	constexpr int32 BandRows = 32;
+	ParallelFor(FMath::DivideAndRoundUp(H, BandRows), [&](int32 Band)
+	{
+		float A[4];
+		float B[4];
+		const int32 YEnd = FMath::Min(H, (Band + 1) * BandRows);
+		for (int32 Y = Band * BandRows; Y < YEnd; ++Y)
+		{
+			for (int32 X = 0; X < W; ++X)
+			{
+				// Content at P in the in-between was at P - T*V in From and arrives at P + (1-T)*V in To
+				const FVector2f FlowV = Flow.Sample((X + 0.5f) * ToFlowX, (Y + 0.5f) * ToFlowY);
+				const float VX = FlowV.X / ToFlowX;
+				const float VY = FlowV.Y / ToFlowY;
+				SampleBilinear(From, X - T * VX, Y - T * VY, A);
+				SampleBilinear(To, X + (1.0f - T) * VX, Y + (1.0f - T) * VY, B);
+
+				const int32 Index = Y * W + X;
+				if (b16)
+				{
+					reinterpret_cast<uint16*>(Dst)[Index] = (uint16)FMath::Clamp(FMath::RoundToInt32(FMath::Lerp(A[0], B[0], T)), 0, 65535);
+					continue;
+				}
+				for (int32 Ch = 0; Ch < C; ++Ch)
+				{
+					Dst[Index * C + Ch] = (uint8)FMath::Clamp(FMath::RoundToInt32(FMath::Lerp(A[Ch], B[Ch], T)), 0, 255);
+				}
+			}
+		}
+	});
+}
@@ -4,128 +4,373 @@
 #include "Engine/Texture2D.h"
 #include "Modules/ModuleManager.h"
 
+#if PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#endif
+
+// PNG colour types (IHDR byte 25)
+static constexpr uint8 PngColorGray      = 0;
+static constexpr uint8 PngColorGrayAlpha = 4;
+
 // Decodes PNG images into UTexture2D
 UTexture2D* UComfyPngDecoder::DecodePNGToTexture(const TArray<uint8>& PNGData)
 {
-	return DecodePNGToTextureWithFormat(PNGData, PF_R8G8B8A8);
+	FComfyDecodedImage Image;
+	if (!DecodePNGToImage(PNGData, Image))
+		return nullptr;
+
+	DownscaleImageHalf(Image);
+	return CreateTextureFromImage(Image);
+}
+
+UTexture2D* UComfyPngDecoder::DecodePNGToTextureWithFormat(const TArray<uint8>& PNGData, TEnumAsByte<EPixelFormat> PixelFormat)
+{
+	FComfyDecodedImage Image;
+	if (!DecodePNGToImage(PNGData, Image))
+		return nullptr;
+
+	// Explicit format requested - expand single-channel sources back to RGBA so the byte layout matches
+	if (Image.IsSingleChannel() && FComfyDecodedImage::GetBytesPerPixel(PixelFormat) == 4)
+	{
+		IImageWrapperModule& ImageWrapperModule =
+			FModuleManager::LoadModuleChecked<IImageWrapperModule>("ImageWrapper");
+		TSharedPtr<IImageWrapper> Wrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+		if (!Wrapper.IsValid() || !Wrapper->SetCompressed(PNGData.GetData(), PNGData.Num()))
+			return nullptr;
+		if (!Wrapper->GetRaw(ERGBFormat::RGBA, 8, Image.Pixels))
+			return nullptr;
+	}
+	Image.Format = PixelFormat;
+
+	DownscaleImageHalf(Image);
+	return CreateTextureFromImage(Image);
 }
 
 // ============================================================
 // Decoder
 // ============================================================
 
-UTexture2D* UComfyPngDecoder::DecodePNGToTextureWithFormat(const TArray<uint8>& PNGData, TEnumAsByte<EPixelFormat> PixelFormat)
-{	
-	//use UE's built-in image wrapper 
-	IImageWrapperModule& ImageWrapperModule = 
-		FModuleManager::LoadModuleChecked<IImageWrapperModule>("ImageWrapper");
+bool UComfyPngDecoder::ReadPNGHeader(const TArray<uint8>& Data, uint8& OutBitDepth, uint8& OutColorType)
+{
+	// [sig:8][len:4][IHDR:4][width:4][height:4][bit_depth:1][color_type:1]...
+	if (!IsValidPNGData(Data) || Data.Num() < 26)
+		return false;
+	if (Data[12] != 'I' || Data[13] != 'H' || Data[14] != 'D' || Data[15] != 'R')
+		return false;
 
-	if (!IsValidPNGData(PNGData))
-		return nullptr;
-	EImageFormat Format = EImageFormat::PNG;
+	OutBitDepth = Data[24];
+	OutColorType = Data[25];
+	return true;
+}
 
-	//create wrapper for format then parse data 
-	TSharedPtr<IImageWrapper> Wrapper = ImageWrapperModule.CreateImageWrapper(Format);
+bool UComfyPngDecoder::DecodePNGToImage(const TArray<uint8>& PNGData, FComfyDecodedImage& OutImage)
+{
+	uint8 BitDepth = 8;
+	uint8 ColorType = 6;
+	if (!ReadPNGHeader(PNGData, BitDepth, ColorType))
+		return false;
+
+	//use UE's built-in image wrapper (module is loaded with the plugin, so GetModulePtr is safe on worker threads)
+	IImageWrapperModule* ImageWrapperModule = FModuleManager::GetModulePtr<IImageWrapperModule>("ImageWrapper");
+	if (!ImageWrapperModule)
+		return false;
+
+	//create wrapper for format then parse data
+	TSharedPtr<IImageWrapper> Wrapper = ImageWrapperModule->CreateImageWrapper(EImageFormat::PNG);
 	if (!Wrapper.IsValid() || !Wrapper->SetCompressed(PNGData.GetData(), PNGData.Num()))
-		return nullptr;
+		return false;
 
-	int32 W = Wrapper->GetWidth();
-	int32 H = Wrapper->GetHeight();
+	OutImage.Width = Wrapper->GetWidth();
+	OutImage.Height = Wrapper->GetHeight();
 
-	TArray<uint8> Raw;
-	if (!Wrapper->GetRaw(ERGBFormat::RGBA, 8, Raw)) return nullptr;
-	
-	return CreateTextureFromData(Raw, W, H, PixelFormat);
+	// Grayscale sources (depth, mask) stay single channel and keep 16-bit precision when present
+	const bool bGraySource = (ColorType == PngColorGray || ColorType == PngColorGrayAlpha);
+	if (bGraySource)
+	{
+		const int32 RawBitDepth = (BitDepth == 16) ? 16 : 8;
+		if (!Wrapper->GetRaw(ERGBFormat::Gray, RawBitDepth, OutImage.Pixels))
+			return false;
+		OutImage.Format = (RawBitDepth == 16) ? PF_G16 : PF_G8;
+	}
+	else
+	{
+		if (!Wrapper->GetRaw(ERGBFormat::RGBA, 8, OutImage.Pixels))
+			return false;
+		OutImage.Format = PF_R8G8B8A8;
+	}
+
+	return OutImage.IsValid();
 }
 
 // ============================================================
-// Texture Creator
+// Pixel helpers
 // ============================================================
 
-UTexture2D* UComfyPngDecoder::CreateTextureFromData(const TArray<uint8>& Data, int32 W, int32 H, EPixelFormat Format)
+void UComfyPngDecoder::DownsampleHalf(const uint8* Src, int32 W, int32 H, EPixelFormat Format, uint8* Dst)
 {
-	// Downscale by half
-	int32 ScaledW = W / 2;
-	int32 ScaledH = H / 2;
-	
-	// Ensure minimum size
-	if (ScaledW < 1) ScaledW = 1;
-	if (ScaledH < 1) ScaledH = 1;
-	
-	TArray<uint8> ScaledData;
-	
-	// Only downscale if the image is large enough and we have RGBA format (4 bytes per pixel)
-	if (W > 1 && H > 1 && Format == PF_R8G8B8A8)
+	const int32 Bpp = FComfyDecodedImage::GetBytesPerPixel(Format);
+	const int32 DstW = FMath::Max(1, W / 2);
+	const int32 DstH = FMath::Max(1, H / 2);
+
+	// Average of 2x2 pixels as avg(avg(top, bottom), avg(left, right)) with round-half-up,
+	// which is exactly what _mm_avg_epu8/_mm_avg_epu16 compute, so SIMD and scalar paths match
+	auto Avg = [](uint32 A, uint32 B) { return (A + B + 1) >> 1; };
+
+	for (int32 Y = 0; Y < DstH; Y++)
 	{
-		const int32 BytesPerPixel = 4;
-		ScaledData.SetNum(ScaledW * ScaledH * BytesPerPixel);
-		
-		// Simple box filter downsampling (average of 2x2 pixels)
-		for (int32 Y = 0; Y < ScaledH; Y++)
+		const int32 SrcY0 = FMath::Min(Y * 2, H - 1);
+		const int32 SrcY1 = FMath::Min(Y * 2 + 1, H - 1);
+		const uint8* Row0 = Src + SrcY0 * W * Bpp;
+		const uint8* Row1 = Src + SrcY1 * W * Bpp;
+		uint8* DstRow = Dst + Y * DstW * Bpp;
+		int32 X = 0;
+
+#if PLATFORM_CPU_X86_FAMILY
+		if (W >= 2 && Format == PF_R8G8B8A8)
+		{
+			// 4 output pixels per iteration: vertical average, then pair even/odd source pixels
+			for (; X + 4 <= DstW; X += 4)
+			{
+				const __m128i V0 = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(Row0 + X * 8)), _mm_loadu_si128((const __m128i*)(Row1 + X * 8)));
+				const __m128i V1 = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(Row0 + X * 8 + 16)), _mm_loadu_si128((const __m128i*)(Row1 + X * 8 + 16)));
+				const __m128 F0 = _mm_castsi128_ps(V0);
+				const __m128 F1 = _mm_castsi128_ps(V1);
+				const __m128i Even = _mm_castps_si128(_mm_shuffle_ps(F0, F1, _MM_SHUFFLE(2, 0, 2, 0)));
+				const __m128i Odd  = _mm_castps_si128(_mm_shuffle_ps(F0, F1, _MM_SHUFFLE(3, 1, 3, 1)));
+				_mm_storeu_si128((__m128i*)(DstRow + X * 4), _mm_avg_epu8(Even, Odd));
+			}
+		}
+		else if (W >= 2 && Format == PF_G8)
 		{
-			for (int32 X = 0; X < ScaledW; X++)
+			// 16 output pixels per iteration: split even/odd bytes into 16-bit lanes, average, pack back
+			const __m128i LowByte = _mm_set1_epi16(0x00FF);
+			for (; X + 16 <= DstW; X += 16)
+			{
+				const __m128i V0 = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(Row0 + X * 2)), _mm_loadu_si128((const __m128i*)(Row1 + X * 2)));
+				const __m128i V1 = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(Row0 + X * 2 + 16)), _mm_loadu_si128((const __m128i*)(Row1 + X * 2 + 16)));
+				const __m128i H0 = _mm_avg_epu16(_mm_and_si128(V0, LowByte), _mm_srli_epi16(V0, 8));
+				const __m128i H1 = _mm_avg_epu16(_mm_and_si128(V1, LowByte), _mm_srli_epi16(V1, 8));
+				_mm_storeu_si128((__m128i*)(DstRow + X), _mm_packus_epi16(H0, H1));
+			}
+		}
+#endif
+
+		// Scalar remainder (and G16/R8G8 or non-x86)
+		for (; X < DstW; X++)
+		{
+			const int32 SrcX0 = FMath::Min(X * 2, W - 1);
+			const int32 SrcX1 = FMath::Min(X * 2 + 1, W - 1);
+
+			if (Format == PF_G16)
 			{
-				// Source pixel coordinates (top-left of 2x2 block)
-				int32 SrcX = X * 2;
-				int32 SrcY = Y * 2;
-				
-				// Clamp to source image bounds
-				SrcX = FMath::Min(SrcX, W - 1);
-				SrcY = FMath::Min(SrcY, H - 1);
-				
-				// Get 2x2 block (clamped to image bounds)
-				int32 X1 = FMath::Min(SrcX + 1, W - 1);
-				int32 Y1 = FMath::Min(SrcY + 1, H - 1);
-				
-				// Sample 4 pixels and average
-				uint32 R = 0, G = 0, B = 0, A = 0;
-				for (int32 Dy = 0; Dy <= 1; Dy++)
+				// 16-bit formats average whole uint16 samples
+				const uint16* R0 = reinterpret_cast<const uint16*>(Row0);
+				const uint16* R1 = reinterpret_cast<const uint16*>(Row1);
+				reinterpret_cast<uint16*>(DstRow)[X] = static_cast<uint16>(Avg(Avg(R0[SrcX0], R1[SrcX0]), Avg(R0[SrcX1], R1[SrcX1])));
+			}
+			else
+			{
+				// 8-bit formats average each byte
+				for (int32 C = 0; C < Bpp; C++)
 				{
-					for (int32 Dx = 0; Dx <= 1; Dx++)
-					{
-						int32 Px = FMath::Min(SrcX + Dx, W - 1);
-						int32 Py = FMath::Min(SrcY + Dy, H - 1);
-						int32 SrcIdx = (Py * W + Px) * BytesPerPixel;
-						
-						if (SrcIdx + 3 < Data.Num())
-						{
-							R += Data[SrcIdx + 0];
-							G += Data[SrcIdx + 1];
-							B += Data[SrcIdx + 2];
-							A += Data[SrcIdx + 3];
-						}
-					}
+					DstRow[X * Bpp + C] = static_cast<uint8>(Avg(Avg(Row0[SrcX0 * Bpp + C], Row1[SrcX0 * Bpp + C]),
+					                                             Avg(Row0[SrcX1 * Bpp + C], Row1[SrcX1 * Bpp + C])));
 				}
-				
-				// Average and write to scaled data
-				int32 DstIdx = (Y * ScaledW + X) * BytesPerPixel;
-				ScaledData[DstIdx + 0] = R / 4;
-				ScaledData[DstIdx + 1] = G / 4;
-				ScaledData[DstIdx + 2] = B / 4;
-				ScaledData[DstIdx + 3] = A / 4;
 			}
 		}
 	}
-	else
+}
+
+void UComfyPngDecoder::DownscaleImageHalf(FComfyDecodedImage& Image)
+{
+	const int32 W = Image.Width;
+	const int32 H = Image.Height;
+	const int32 Bpp = Image.GetBytesPerPixel();
+
+	// No downscaling for tiny images or unknown formats
+	if (W <= 1 || H <= 1 || Bpp == 0 || !Image.IsValid())
+		return;
+
+	const int32 ScaledW = W / 2;
+	const int32 ScaledH = H / 2;
+
+	TArray<uint8> ScaledData;
+	ScaledData.SetNumUninitialized(ScaledW * ScaledH * Bpp);
+	DownsampleHalf(Image.Pixels.GetData(), W, H, Image.Format, ScaledData.GetData());
+
+	Image.Pixels = MoveTemp(ScaledData);
+	Image.Width = ScaledW;
+	Image.Height = ScaledH;
+	Image.Mips.Reset();
+}
+
+void UComfyPngDecoder::BuildMipChain(FComfyDecodedImage& Image)
+{
+	Image.Mips.Reset();
+	if (!Image.IsValid())
+		return;
+
+	const int32 Bpp = Image.GetBytesPerPixel();
+	int32 W = Image.Width;
+	int32 H = Image.Height;
+	const uint8* Src = Image.Pixels.GetData();
+
+	// Each level reads the previous one (Mips is reserved up front so Src stays valid)
+	Image.Mips.Reserve(FMath::FloorLog2(FMath::Max(W, H)));
+	while (W > 1 || H > 1)
+	{
+		const int32 MipW = FMath::Max(1, W / 2);
+		const int32 MipH = FMath::Max(1, H / 2);
+
+		TArray<uint8>& Mip = Image.Mips.AddDefaulted_GetRef();
+		Mip.SetNumUninitialized(MipW * MipH * Bpp);
+		DownsampleHalf(Src, W, H, Image.Format, Mip.GetData());
+
+		Src = Mip.GetData();
+		W = MipW;
+		H = MipH;
+	}
+}
+
+bool UComfyPngDecoder::IsImageGrayscale(const FComfyDecodedImage& Image)
+{
+	if (Image.IsSingleChannel())
+		return true;
+	if (Image.Format != PF_R8G8B8A8 || !Image.IsValid())
+		return false;
+
+	const int32 Width = Image.Width;
+	const int32 Height = Image.Height;
+	const FColor* Pixels = reinterpret_cast<const FColor*>(Image.Pixels.GetData());
+
+	// Sample a grid of pixels (every Nth pixel) to avoid checking all pixels
+	const int32 SampleStep = FMath::Max(1, FMath::Min(Width, Height) / 20); // Sample ~20x20 grid
+	const int32 MaxSamples = 400;
+	const int32 Tolerance = 2; // Allow 2 levels of difference for compression artifacts
+	int32 GrayscaleCount = 0;
+	int32 TotalSamples = 0;
+
+	for (int32 Y = 0; Y < Height && TotalSamples < MaxSamples; Y += SampleStep)
+	{
+		for (int32 X = 0; X < Width && TotalSamples < MaxSamples; X += SampleStep)
+		{
+			// Byte order in memory is R,G,B,A; FColor reads it as B,G,R,A which is fine for an R=G=B test
+			const FColor& Pixel = Pixels[Y * Width + X];
+			if (FMath::Abs((int32)Pixel.R - (int32)Pixel.G) <= Tolerance &&
+			    FMath::Abs((int32)Pixel.G - (int32)Pixel.B) <= Tolerance)
+			{
+				GrayscaleCount++;
+			}
+			TotalSamples++;
+		}
+	}
+
+	// If 95%+ of sampled pixels are grayscale, consider it grayscale
+	return TotalSamples > 0 && (GrayscaleCount * 100 / TotalSamples) >= 95;
+}
+
+void UComfyPngDecoder::CropImage(FComfyDecodedImage& Image, const FIntRect& Rect)
+{
+	if (!Image.IsValid())
+		return;
+
+	const FIntRect Clamped(
+		FMath::Clamp(Rect.Min.X, 0, Image.Width), FMath::Clamp(Rect.Min.Y, 0, Image.Height),
+		FMath::Clamp(Rect.Max.X, 0, Image.Width), FMath::Clamp(Rect.Max.Y, 0, Image.Height));
+	const int32 CropW = Clamped.Width();
+	const int32 CropH = Clamped.Height();
+	if (CropW <= 0 || CropH <= 0 || (CropW == Image.Width && CropH == Image.Height))
+		return;
+
+	const int32 Bpp = Image.GetBytesPerPixel();
+	TArray<uint8> Cropped;
+	Cropped.SetNumUninitialized(CropW * CropH * Bpp);
+	for (int32 Y = 0; Y < CropH; Y++)
+	{
+		FMemory::Memcpy(Cropped.GetData() + Y * CropW * Bpp,
+		                Image.Pixels.GetData() + ((Clamped.Min.Y + Y) * Image.Width + Clamped.Min.X) * Bpp,
+		                CropW * Bpp);
+	}
+
+	Image.Pixels = MoveTemp(Cropped);
+	Image.Width = CropW;
+	Image.Height = CropH;
+	Image.Mips.Reset();
+}
+
+void UComfyPngDecoder::ConvertToSingleChannel(FComfyDecodedImage& Image)
+{
+	if (Image.Format != PF_R8G8B8A8 || !Image.IsValid())
+		return;
+
+	const int32 NumPixels = Image.Width * Image.Height;
+	TArray<uint8> Gray;
+	Gray.SetNumUninitialized(NumPixels);
+
+	const uint8* Src = Image.Pixels.GetData();
+	for (int32 i = 0; i < NumPixels; i++)
 	{
-		// No downscaling for small images or non-RGBA formats
-		ScaledData = Data;
-		ScaledW = W;
-		ScaledH = H;
+		Gray[i] = Src[i * 4]; // R channel (R=G=B for gray content)
 	}
-	
-	UTexture2D* Texture = UTexture2D::CreateTransient(ScaledW, ScaledH, Format);
+
+	Image.Pixels = MoveTemp(Gray);
+	Image.Format = PF_G8;
+	Image.Mips.Reset();
+}
+
+// ============================================================
+// Texture Creator
+// ============================================================
+
+UTexture2D* UComfyPngDecoder::CreateTextureFromImage(const FComfyDecodedImage& Image)
+{
+	if (!Image.IsValid())
+		return nullptr;
+
+	UTexture2D* Texture = UTexture2D::CreateTransient(Image.Width, Image.Height, Image.Format);
 	if (!Texture) return nullptr;
 
-	//for depth maps to attain full color fidelity 
-	Texture->CompressionSettings = TC_VectorDisplacementmap; //prevent color compression 
-	Texture->SRGB = true; //DepthAnything mask uses grayscale but RGB should be gamma
-	Texture->Filter = TF_Bilinear;
+	if (Image.IsSingleChannel())
+	{
+		// Depth and mask are linear data - sample the R channel in the material
+		Texture->CompressionSettings = TC_Grayscale;
+		Texture->SRGB = false;
+	}
+	else if (Image.Format == PF_R8G8)
+	{
+		// Encoded normals (X, Y) - linear, decoded in the material
+		Texture->CompressionSettings = TC_Masks;
+		Texture->SRGB = false;
+	}
+	else
+	{
+		//for depth maps to attain full color fidelity
+		Texture->CompressionSettings = TC_VectorDisplacementmap; //prevent color compression
+		Texture->SRGB = true; //RGB should be gamma
+	}
+	Texture->Filter = Image.Mips.Num() > 0 ? TF_Trilinear : TF_Bilinear;
+
+	//copy pixels into texture
+	FTexturePlatformData* PlatformData = Texture->GetPlatformData();
+	void* TexData = PlatformData->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
+	FMemory::Memcpy(TexData, Image.Pixels.GetData(), Image.Pixels.Num());
+	PlatformData->Mips[0].BulkData.Unlock();
 
-	//copy scaled data into texture
-	void* TexData = Texture->GetPlatformData()->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
-	FMemory::Memcpy(TexData, ScaledData.GetData(), ScaledData.Num());
-	Texture->GetPlatformData()->Mips[0].BulkData.Unlock();
+	//append precomputed mips (uploaded together with mip 0 by UpdateResource)
+	int32 MipW = Image.Width;
+	int32 MipH = Image.Height;
+	for (const TArray<uint8>& MipPixels : Image.Mips)
+	{
+		MipW = FMath::Max(1, MipW / 2);
+		MipH = FMath::Max(1, MipH / 2);
+
+		FTexture2DMipMap* Mip = new FTexture2DMipMap(MipW, MipH);
+		PlatformData->Mips.Add(Mip);
+		Mip->BulkData.Lock(LOCK_READ_WRITE);
+		void* MipData = Mip->BulkData.Realloc(MipPixels.Num());
+		FMemory::Memcpy(MipData, MipPixels.GetData(), MipPixels.Num());
+		Mip->BulkData.Unlock();
+	}
 
 	Texture->UpdateResource();
 	return Texture;
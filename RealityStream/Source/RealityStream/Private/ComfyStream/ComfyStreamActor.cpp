@@ -1,19 +1,31 @@
 #include "ComfyStream/ComfyStreamActor.h"
+#include "ComfyStream/ComfyPngDecoder.h"
+#include "ComfyStream/ComfyStreamHubSubsystem.h"
 #include "SplatCreator/SplatCreatorSubsystem.h"
 #include "Async/Async.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Engine/World.h"
+#include "Engine/GameInstance.h"
 #include "Engine/StaticMesh.h"
 #include "TimerManager.h"
 #include "Engine/Texture2D.h"
+#include "ProceduralMeshComponent.h"
 #include "Math/UnrealMathUtility.h"
 
 static bool debug = false;
 //Actor that receives 3 texture maps from ComfyUI and applies to to a material 
 
+// Arrival gaps longer than this (stream paused or reconnected) restart the interval statistics
+static constexpr double MaxTrackedArrivalInterval = 5.0;
+
+// Shortest adapted transition
+static constexpr float MinTransitionSeconds = 0.05f;
+
 AComfyStreamActor::AComfyStreamActor()
 {
 	PrimaryActorTick.bCanEverTick = true;
+	// Woken by incoming frames (UpdateTickState), idle otherwise
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
 
@@ -29,31 +41,44 @@ AComfyStreamActor::AComfyStreamActor()
 
 void AComfyStreamActor::BeginPlay()
 {
-	Super::BeginPlay();
+	// Hub mode: the component must not open its own connection
+	if (bUseStreamHub && ComfyStreamComponent)
+	{
+		ComfyStreamComponent->StreamConfig.bAutoReconnect = false;
+	}
 
-	//Create external helpers for pairing and placement 
-	FrameBuffer   = NewObject<UComfyFrameBuffer>(this);
+	Super::BeginPlay();
 
 	//Create material
 	if (BaseMaterial)
 	{
 		DynMat = UMaterialInstanceDynamic::Create(BaseMaterial, this);
 		if (DynMat)
+		{
 			DisplayMesh->SetMaterial(0, DynMat);
-	}
+			DynMatSlots.Resolve(DynMat);
+		}
 
-	//Bind buffer completion
-	if (FrameBuffer)
-	{
-		FrameBuffer->OnFullFrameReady.AddDynamic(this, &AComfyStreamActor::HandleFullFrame);
+		// Material crossfade needs LerpAlpha (and the *_New texture slots next to it)
+		float LerpParam = 0.0f;
+		bMaterialHasLerpAlpha = BaseMaterial->GetScalarParameterValue(FHashedMaterialParameterInfo(TEXT("LerpAlpha")), LerpParam);
+		if (bEnableInterpolation && InterpolationMode == EComfyInterpolationMode::MaterialCrossfade && !bMaterialHasLerpAlpha)
+		{
+			if (debug) UE_LOG(LogTemp, Warning, TEXT("[ComfyStreamActor] BaseMaterial has no LerpAlpha parameter - using CPU blend interpolation"));
+		}
 	}
 
 	//Bind component events 
 	if (ComfyStreamComponent)
 	{
 		ComfyStreamComponent->StreamConfig = SegmentationChannelConfig;
+		if (bUseStreamHub)
+		{
+			ComfyStreamComponent->StreamConfig.bAutoReconnect = false;
+		}
 
 		ComfyStreamComponent->OnTextureReceived.AddDynamic(this, &AComfyStreamActor::HandleStreamTexture);
+		ComfyStreamComponent->OnFullFrameReadyNative.AddUObject(this, &AComfyStreamActor::HandleFullFrame);
 		ComfyStreamComponent->OnConnectionStatusChanged.AddDynamic(this, &AComfyStreamActor::HandleConnectionChanged);
 		ComfyStreamComponent->OnError.AddDynamic(this, &AComfyStreamActor::HandleStreamError);
 
@@ -68,48 +93,52 @@ void AComfyStreamActor::BeginPlay()
 	{
 		DisplayMesh->SetVisibility(false);
 	}
+
+	// Hidden display actors with their material instances, so new locations reuse instead of spawning
+	for (int32 i = 0; i < ActorPoolSize; i++)
+	{
+		FActorLerpData Entry;
+		Entry.Actor = CreateDisplayActor(GetActorLocation());
+		if (!Entry.Actor)
+		{
+			break;
+		}
+		Entry.Actor->SetActorHiddenInGame(true);
+		CreateDisplayMaterial(Entry);
+		ActorPool.Add(MoveTemp(Entry));
+	}
+
+	// Reconstruction mesh sits where the display plane is (its own scale: vertices are in world units)
+	if (bReconstructDepthMesh && DisplayMesh)
+	{
+		DepthMeshComponent = NewObject<UProceduralMeshComponent>(this, TEXT("DepthMesh"));
+		DepthMeshComponent->bUseAsyncCooking = true;
+		DepthMeshComponent->SetupAttachment(RootComponent);
+		DepthMeshComponent->SetRelativeLocationAndRotation(DisplayMesh->GetRelativeLocation(), DisplayMesh->GetRelativeRotation());
+		DepthMeshComponent->RegisterComponent();
+		DepthMeshBuffers = MakeShared<FComfyDepthMeshBuffers, ESPMode::ThreadSafe>();
+	}
+
+	bAlwaysTick = GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AComfyStreamActor, ReceiveTick));
+	UpdateTickState();
 }
 
 void AComfyStreamActor::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	// Process interpolation queue
-	if (bEnableInterpolation && InterpolationQueue.Num() > 0)
-	{
-		InterpolationTimer += DeltaTime;
-		
-		// Apply interpolated frames based on timing
-		for (int32 i = InterpolationQueue.Num() - 1; i >= 0; --i)
-		{
-			FInterpolatedFrame& InterpFrame = InterpolationQueue[i];
-			InterpFrame.TimeRemaining -= DeltaTime;
-			
-			if (InterpFrame.TimeRemaining <= 0.0f)
-			{
-				// Time to apply this interpolated frame
-				ApplyInterpolatedFrame(InterpFrame.Frame);
-				InterpolationQueue.RemoveAt(i);
-			}
-		}
-		
-		// If queue is empty, interpolation is complete
-		// The final frame should have already been applied via the queue
-	}
-	else
+	// Queued frames whose presentation time has come
+	PresentDueFrames();
+
+	// CPU blend in progress - blend only what is displayed this tick
+	// (frames without interpolation are applied once, when they are presented)
+	if (bCpuBlending)
 	{
-		// No interpolation - apply latest frame directly if available
-		// When FrameApplyDelaySeconds > 0, don't apply LatestFrame until the delay timer has fired (avoid bypassing delay)
-		bool bDelayPending = FrameApplyDelaySeconds > 0.0f && GetWorld() && GetWorld()->GetTimerManager().IsTimerActive(DelayedApplyTimer);
-		if (LatestFrame.IsComplete() && !bDelayPending)
-		{
-			ApplyTexturesToMaterial(LatestFrame);
-			FVector FixedPosition = GetActorLocation();
-			SpawnTextureActor(LatestFrame, FixedPosition);
-		}
+		UpdateCpuBlend(DeltaTime);
 	}
 
 	//Update lerp and opacity fade for all actors
+	bool bActorsRemoved = false;
 	for (int32 i = ActorData.Num() - 1; i >= 0; i--)
 	{
 		FActorLerpData& Data = ActorData[i];
@@ -120,6 +149,7 @@ void AComfyStreamActor::Tick(float DeltaTime)
 			GetWorld()->GetTimerManager().ClearTimer(Data.DestroyTimer);
 			GetWorld()->GetTimerManager().ClearTimer(Data.LerpTimer);
 			ActorData.RemoveAt(i);
+			bActorsRemoved = true;
 			continue;
 		}
 		
@@ -132,19 +162,31 @@ void AComfyStreamActor::Tick(float DeltaTime)
 		// Opacity fade-out disabled - actors stay up permanently until replaced by new frame
 		// (Removed fade-out logic so images persist)
 	}
+	if (bActorsRemoved)
+	{
+		RebuildActorCells();
+	}
+
+	UpdateTickState();
 }
 
 void AComfyStreamActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	if (UWorld* World = GetWorld())
-	{
-		World->GetTimerManager().ClearTimer(DelayedApplyTimer);
-	}
+	FrameQueue.Empty();
+	++DepthMeshGeneration;
+	bDepthMeshInFlight = false;
+	PendingDepthMeshFrame = FComfyFrame();
 	for (AActor* Actor : SpawnedTextureActors)
 	{
-		Actor->Destroy();
+		if (IsValid(Actor))
+		{
+			Actor->Destroy();
+		}
 	}
 	SpawnedTextureActors.Empty();
+	ActorData.Empty();
+	ActorPool.Empty();
+	ActorCells.Reset();
 	
 	DisconnectAll();
 	Super::EndPlay(EndPlayReason);
@@ -152,69 +194,55 @@ void AComfyStreamActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 void AComfyStreamActor::ConnectSegmentationChannel()
 {
+	if (bUseStreamHub)
+	{
+		UGameInstance* GameInstance = GetGameInstance();
+		UComfyStreamHubSubsystem* Hub = GameInstance ? GameInstance->GetSubsystem<UComfyStreamHubSubsystem>() : nullptr;
+		if (Hub && HubSubscription == 0)
+		{
+			// The hub's own fetcher decodes with the component's ingest settings
+			FComfyIngestSettings Ingest = ComfyStreamComponent ? ComfyStreamComponent->IngestSettings : FComfyIngestSettings();
+			if (ComfyStreamComponent)
+			{
+				Ingest.NormalDepthScale = ComfyStreamComponent->DepthScaleUnits;
+			}
+			// FrameApplyDelaySeconds is applied by the presentation clock (it counts from ArrivalTime)
+			HubSubscription = Hub->Subscribe(SegmentationChannelConfig, Ingest, 0.0f,
+				FComfyHubFrameDelegate::CreateUObject(this, &AComfyStreamActor::HandleFullFrame));
+		}
+		return;
+	}
+
 	if (ComfyStreamComponent)
 		ComfyStreamComponent->Connect();
 }
 
 void AComfyStreamActor::DisconnectAll()
 {
+	if (HubSubscription != 0)
+	{
+		UGameInstance* GameInstance = GetGameInstance();
+		if (UComfyStreamHubSubsystem* Hub = GameInstance ? GameInstance->GetSubsystem<UComfyStreamHubSubsystem>() : nullptr)
+		{
+			Hub->Unsubscribe(HubSubscription);
+		}
+		HubSubscription = 0;
+	}
+
 	if (ComfyStreamComponent)
 		ComfyStreamComponent->Disconnect();
 }
 
 void AComfyStreamActor::HandleStreamTexture(UTexture2D* Texture)
 {
-	if (!Texture || !FrameBuffer)
-		return;
-
-	// ComfyImageFetcher broadcasts textures in order: RGB (0), Depth (1), Mask (2)
-	// Assign to first available slot based on what we've received
-	// This handles out-of-order arrival gracefully
-	
-	int32 Index = INDEX_NONE;
-	FString ChannelName;
-	
-	if (!bHasRGB)
-	{
-		// First texture received - always RGB
-		Index = 0;
-		ChannelName = TEXT("RGB");
-		bHasRGB = true;
-	}
-	else if (!bHasDepth)
-	{
-		// Second texture - assign to Depth slot
-		Index = 1;
-		ChannelName = TEXT("Depth");
-		bHasDepth = true;
-	}
-	else if (!bHasMask)
-	{
-		// Third texture - assign to Mask slot
-		Index = 2;
-		ChannelName = TEXT("Mask");
-		bHasMask = true;
-	}
-	else
-	{
-		// All slots filled - shouldn't happen, skip
-		if(debug) UE_LOG(LogTemp, Warning, TEXT("[ComfyStreamActor] Received texture but all slots already filled (SeqIndex=%d)"), SeqIndex);
+	if (!Texture)
 		return;
-	}
-	
-	int32 CurrentSeqIndex = SeqIndex; // Log before incrementing
-	FrameBuffer->PushTexture(Texture, Index);
-	SeqIndex++;
-	
-	if(debug) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamActor] Received %s texture (SeqIndex=%d, FrameBuffer index=%d, HasRGB=%d, HasDepth=%d, HasMask=%d)"), 
-		*ChannelName, CurrentSeqIndex, Index, bHasRGB ? 1 : 0, bHasDepth ? 1 : 0, bHasMask ? 1 : 0);
 
-	//Notify blueprint
+	// Frames are assembled by the ingest stage and arrive through HandleFullFrame;
+	// individual textures are only forwarded to Blueprint
 	OnTextureReceived(Texture);
 }
 
-
-
 void AComfyStreamActor::HandleConnectionChanged(bool bConnected)
 {
 	OnConnectionStatusChanged(bConnected);
@@ -235,91 +263,174 @@ static bool IsTextureSafeForMaterial(UTexture2D* Tex)
 	return true;
 }
 
-void AComfyStreamActor::ApplyTexturesToMaterial(const FComfyFrame& Frame)
+// ============================================================
+// Material parameter slots
+// ============================================================
+
+// [RGB, Mask, Depth, Normal][base, crossfade target]
+static const FMaterialParameterInfo& GetTextureParamInfo(int32 Param, int32 Slot)
 {
-	static const FName RGBParam  = TEXT("RGB_Map");
-	static const FName DepthParam= TEXT("Depth_Map_Object");
-	static const FName MaskParam = TEXT("Mask_Map");
+	static const FMaterialParameterInfo Infos[4][2] =
+	{
+		{ FMaterialParameterInfo(TEXT("RGB_Map")), FMaterialParameterInfo(TEXT("RGB_Map_New")) },
+		{ FMaterialParameterInfo(TEXT("Mask_Map")), FMaterialParameterInfo(TEXT("Mask_Map_New")) },
+		{ FMaterialParameterInfo(TEXT("Depth_Map_Object")), FMaterialParameterInfo(TEXT("Depth_Map_New")) },
+		{ FMaterialParameterInfo(TEXT("Normal_Map")), FMaterialParameterInfo(TEXT("Normal_Map_New")) }
+	};
+	return Infos[Param][Slot];
+}
 
-	if (!DynMat)
+void FComfyMaterialSlots::Resolve(UMaterialInstanceDynamic* Material)
+{
+	*this = FComfyMaterialSlots();
+	if (!Material)
 	{
 		return;
 	}
 
-	// Set required textures (RGB and Mask) - both must be valid and safe (avoid corrupt PlatformData crash)
-	if (!IsValid(Frame.RGB) || !IsValid(Frame.Mask) ||
-	    !IsTextureSafeForMaterial(Frame.RGB) || !IsTextureSafeForMaterial(Frame.Mask))
+	// Overrides start at the parent's values, so resolving changes nothing visible
+	auto ResolveScalar = [Material](const TCHAR* Name, int32& OutIndex)
+	{
+		float Value = 0.0f;
+		Material->GetScalarParameterValue(FHashedMaterialParameterInfo(Name), Value);
+		Material->InitializeScalarParameterAndGetIndex(Name, Value, OutIndex);
+	};
+	ResolveScalar(TEXT("LerpAlpha"), LerpAlphaIndex);
+	ResolveScalar(TEXT("MaskInRGBAlpha"), MaskPackedIndex);
+	ResolveScalar(TEXT("Opacity"), OpacityIndex);
+
+	FLinearColor Roi(0.0f, 0.0f, 1.0f, 1.0f);
+	Material->GetVectorParameterValue(FHashedMaterialParameterInfo(TEXT("ROI_Rect")), Roi);
+	Material->InitializeVectorParameterAndGetIndex(TEXT("ROI_Rect"), Roi, RoiIndex);
+}
+
+void FComfyMaterialSlots::SetTexture(UMaterialInstanceDynamic* Material, int32 Param, int32 Slot, UTexture* Texture)
+{
+	const int32 Entry = Param * 2 + Slot;
+	if ((BoundMask & (1 << Entry)) && Bound[Entry] == Texture)
 	{
-		if (debug) UE_LOG(LogTemp, Warning, TEXT("[ComfyStreamActor] ApplyTexturesToMaterial skipping - frame textures invalid or unsafe"));
 		return;
 	}
-	
-	DynMat->SetTextureParameterValue(RGBParam, Frame.RGB);
-	DynMat->SetTextureParameterValue(MaskParam, Frame.Mask);
-	
-	// Set Depth if available (optional)
-	if (IsValid(Frame.Depth) && IsTextureSafeForMaterial(Frame.Depth))
+	Material->SetTextureParameterValueByInfo(GetTextureParamInfo(Param, Slot), Texture);
+	Bound[Entry] = Texture;
+	BoundMask |= (1 << Entry);
+}
+
+void FComfyMaterialSlots::SetTextures(UMaterialInstanceDynamic* Material, const FComfyFrame& Frame, int32 Slot)
+{
+	SetTexture(Material, 0, Slot, Frame.RGB);
+	SetTexture(Material, 1, Slot, Frame.Mask);
+	SetTexture(Material, 2, Slot, IsTextureSafeForMaterial(Frame.Depth) ? Frame.Depth : nullptr);
+	// Precomputed normals (optional) - replaces MF_DepthToNormal's depth differences when bound
+	SetTexture(Material, 3, Slot, Frame.HasNormal() ? Frame.Normal : nullptr);
+	Leases[Slot] = Frame.TextureLeases;
+}
+
+bool FComfyMaterialSlots::IsBound(const FComfyFrame& Frame, int32 Slot) const
+{
+	auto Holds = [this, Slot](int32 Param, UTexture* Texture)
 	{
-		DynMat->SetTextureParameterValue(DepthParam, Frame.Depth);
+		const int32 Entry = Param * 2 + Slot;
+		return (BoundMask & (1 << Entry)) && Bound[Entry] == Texture;
+	};
+	return Holds(0, Frame.RGB) && Holds(1, Frame.Mask) && (!IsValid(Frame.Depth) || Holds(2, Frame.Depth));
+}
+
+void FComfyMaterialSlots::PromoteNewSlot(UMaterialInstanceDynamic* Material)
+{
+	for (int32 Param = 0; Param < 4; ++Param)
+	{
+		if (BoundMask & (1 << (Param * 2 + 1)))
+		{
+			SetTexture(Material, Param, 0, Bound[Param * 2 + 1]);
+		}
 	}
-	else
+	Leases[0] = Leases[1];
+}
+
+void FComfyMaterialSlots::SetLayout(UMaterialInstanceDynamic* Material, const FComfyFrame& Frame)
+{
+	// Packed frames bind the RGB texture as Mask_Map too; the material reads RGB_Map.A when MaskInRGBAlpha is 1
+	if (MaskPackedIndex != INDEX_NONE)
+	{
+		Material->SetScalarParameterByIndex(MaskPackedIndex, Frame.IsMaskPacked() ? 1.0f : 0.0f);
+	}
+	// Cropped frames: (offset U, offset V, scale U, scale V) of the full ComfyUI frame
+	if (RoiIndex != INDEX_NONE)
+	{
+		Material->SetVectorParameterByIndex(RoiIndex, FLinearColor(Frame.RoiOffset.X, Frame.RoiOffset.Y, Frame.RoiScale.X, Frame.RoiScale.Y));
+	}
+}
+
+void FComfyMaterialSlots::SetLerpAlpha(UMaterialInstanceDynamic* Material, float Value)
+{
+	if (LerpAlphaIndex != INDEX_NONE)
 	{
-		DynMat->SetTextureParameterValue(DepthParam, nullptr);
+		Material->SetScalarParameterByIndex(LerpAlphaIndex, Value);
 	}
 }
 
-void AComfyStreamActor::SpawnTextureActor(const FComfyFrame& Frame, const FVector& WorldPosition)
+void FComfyMaterialSlots::SetOpacity(UMaterialInstanceDynamic* Material, float Value)
 {
-	AActor* Actor = FindOrSpawnActorAtLocation(WorldPosition);
-	if (!Actor) return;
+	if (OpacityIndex != INDEX_NONE)
+	{
+		Material->SetScalarParameterByIndex(OpacityIndex, Value);
+	}
+}
+
+// ============================================================
 
-	//Find or create actor data entry
-	FActorLerpData* ActorDataPtr = nullptr;
-	for (FActorLerpData& Data : ActorData)
+void AComfyStreamActor::ApplyTexturesToMaterial(const FComfyFrame& Frame)
+{
+	if (!DynMat)
 	{
-		if (Data.Actor == Actor)
-		{
-			ActorDataPtr = &Data;
-			break;
-		}
+		return;
 	}
 
-	bool bIsNewActor = false;
-	if (!ActorDataPtr)
+	// Set required textures (RGB and Mask) - both must be valid and safe (avoid corrupt PlatformData crash)
+	if (!IsValid(Frame.RGB) || !IsValid(Frame.Mask) ||
+	    !IsTextureSafeForMaterial(Frame.RGB) || !IsTextureSafeForMaterial(Frame.Mask))
 	{
-		FActorLerpData NewData;
-		NewData.Actor = Actor;
-		NewData.Position = WorldPosition;
-		ActorData.Add(NewData);
-		ActorDataPtr = &ActorData[ActorData.Num() - 1];
-		bIsNewActor = true;
+		if (debug) UE_LOG(LogTemp, Warning, TEXT("[ComfyStreamActor] ApplyTexturesToMaterial skipping - frame textures invalid or unsafe"));
+		return;
 	}
-	
-	// Scale actor to match texture size (only for new actors)
-	if (bIsNewActor)
+
+	DynMatSlots.SetLayout(DynMat, Frame);
+	DynMatSlots.SetTextures(DynMat, Frame, 0);
+}
+
+FActorLerpData* AComfyStreamActor::SpawnTextureActor(const FComfyFrame& Frame, const FVector& WorldPosition)
+{
+	// The reconstructed mesh replaces the display actors (DynMat already holds the frame's textures;
+	// the *_New slots get the same frame so any LerpAlpha shows it)
+	if (DepthMeshComponent)
 	{
-		ScaleActorToTextureSize(Actor, Frame);
+		if (DynMat && bMaterialHasLerpAlpha && Frame.IsComplete())
+		{
+			DynMatSlots.SetTextures(DynMat, Frame, 1);
+		}
+		UpdateDepthMesh(Frame);
+		return nullptr;
 	}
 
+	FActorLerpData* ActorDataPtr = FindOrAcquireActorAtLocation(WorldPosition);
+	if (!ActorDataPtr) return nullptr;
+	AActor* Actor = ActorDataPtr->Actor;
+	ActorDataPtr->LastUsedTime = FPlatformTime::Seconds();
+	
+	// Scale actor to match texture size (new actors, and every frame so cropped frames fit their ROI)
+	ScaleActorToTextureSize(Actor, Frame);
+
 	//Update textures with lerp if material exists
 	// Always update textures - the frame comparison in HandleFullFrame ensures we only get new frames
 	if (ActorDataPtr->Material)
 	{
-		// Check if textures are different from what's currently set (for logging)
-		UTexture* CurrentRGB = nullptr;
-		UTexture* CurrentDepth = nullptr;
-		UTexture* CurrentMask = nullptr;
-		bool bMaterialHasRGB = ActorDataPtr->Material->GetTextureParameterValue(TEXT("RGB_Map"), CurrentRGB);
-		bool bMaterialHasDepth = ActorDataPtr->Material->GetTextureParameterValue(TEXT("Depth_Map_Object"), CurrentDepth);
-		bool bMaterialHasMask = ActorDataPtr->Material->GetTextureParameterValue(TEXT("Mask_Map"), CurrentMask);
-		
-		// Check if textures changed (RGB and Mask are required, Depth is optional)
-		bool bTexturesChanged = !bMaterialHasRGB || !bMaterialHasMask || 
-		                        (CurrentRGB != Frame.RGB || CurrentMask != Frame.Mask);
-		// Also check if Depth changed (if it exists)
-		if (IsValid(Frame.Depth) && (!bMaterialHasDepth || CurrentDepth != Frame.Depth))
+		// Compared with what this actor last bound (no parameter read-back). A crossfade towards this frame
+		// already has it in the *_New slots.
+		bool bTexturesChanged = !ActorDataPtr->Slots.IsBound(Frame, 0);
+		if (bTexturesChanged && ActorDataPtr->bIsLerping)
 		{
-			bTexturesChanged = true;
+			bTexturesChanged = !ActorDataPtr->Slots.IsBound(Frame, 1);
 		}
 		
 		if (bTexturesChanged)
@@ -328,49 +439,17 @@ void AComfyStreamActor::SpawnTextureActor(const FComfyFrame& Frame, const FVecto
 			if (IsValid(Frame.RGB) && IsValid(Frame.Mask) &&
 			    IsTextureSafeForMaterial(Frame.RGB) && IsTextureSafeForMaterial(Frame.Mask))
 			{
-				//Set required textures
-				ActorDataPtr->Material->SetTextureParameterValue(TEXT("RGB_Map"), Frame.RGB);
-				ActorDataPtr->Material->SetTextureParameterValue(TEXT("Mask_Map"), Frame.Mask);
-				
-				//Set Depth if available (optional)
-				if (IsValid(Frame.Depth) && IsTextureSafeForMaterial(Frame.Depth))
-				{
-					ActorDataPtr->Material->SetTextureParameterValue(TEXT("Depth_Map_Object"), Frame.Depth);
-				}
-				else
-				{
-					// Clear depth texture if not present
-					ActorDataPtr->Material->SetTextureParameterValue(TEXT("Depth_Map_Object"), nullptr);
-				}
+				ActorDataPtr->Slots.SetLayout(ActorDataPtr->Material, Frame);
+				ActorDataPtr->Slots.SetTextures(ActorDataPtr->Material, Frame, 0);
 
-				//If material supports lerp alpha parameter, enable lerping
-				// Only use material lerp if interpolation is disabled (interpolation handles blending itself)
-				if (!bEnableInterpolation)
-				{
-					float LerpParam = 0.0f;
-					if (ActorDataPtr->Material->GetScalarParameterValue(TEXT("LerpAlpha"), LerpParam))
-					{
-						ActorDataPtr->LerpAlpha = 0.0f;
-						ActorDataPtr->bIsLerping = true;
-						//Set new textures as target for lerp
-						ActorDataPtr->Material->SetTextureParameterValue(TEXT("RGB_Map_New"), Frame.RGB);
-						ActorDataPtr->Material->SetTextureParameterValue(TEXT("Mask_Map_New"), Frame.Mask);
-						if (IsValid(Frame.Depth))
-						{
-							ActorDataPtr->Material->SetTextureParameterValue(TEXT("Depth_Map_New"), Frame.Depth);
-						}
-						else
-						{
-							ActorDataPtr->Material->SetTextureParameterValue(TEXT("Depth_Map_New"), nullptr);
-						}
-					}
-				}
-				else
+				// Shown directly - the *_New slots get the same frame so any LerpAlpha shows it.
+				// Crossfades are set up afterwards by StartMaterialCrossfade.
+				if (bMaterialHasLerpAlpha)
 				{
-					// When interpolation is enabled, disable material lerp to avoid conflicts
-					ActorDataPtr->bIsLerping = false;
-					ActorDataPtr->LerpAlpha = 1.0f;
+					ActorDataPtr->Slots.SetTextures(ActorDataPtr->Material, Frame, 1);
 				}
+				ActorDataPtr->bIsLerping = false;
+				ActorDataPtr->LerpAlpha = 1.0f;
 				
 				if(debug) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamActor] Updated textures on actor: RGB=%s, Depth=%s, Mask=%s"), 
 					IsValid(Frame.RGB) ? *Frame.RGB->GetName() : TEXT("NULL"),
@@ -399,24 +478,19 @@ void AComfyStreamActor::SpawnTextureActor(const FComfyFrame& Frame, const FVecto
 			ActorDataPtr->Material = UMaterialInstanceDynamic::Create(BaseMaterial, Actor);
 			if (ActorDataPtr->Material)
 			{
+				ActorDataPtr->Slots.Resolve(ActorDataPtr->Material);
+
 				// Ensure required textures (RGB and Mask) are valid and safe before setting
 				if (IsValid(Frame.RGB) && IsValid(Frame.Mask) &&
 				    IsTextureSafeForMaterial(Frame.RGB) && IsTextureSafeForMaterial(Frame.Mask))
 				{
-					ActorDataPtr->Material->SetTextureParameterValue(TEXT("RGB_Map"), Frame.RGB);
-					ActorDataPtr->Material->SetTextureParameterValue(TEXT("Mask_Map"), Frame.Mask);
-					
-					// Set Depth if available (optional)
-					if (IsValid(Frame.Depth) && IsTextureSafeForMaterial(Frame.Depth))
+					ActorDataPtr->Slots.SetLayout(ActorDataPtr->Material, Frame);
+					ActorDataPtr->Slots.SetTextures(ActorDataPtr->Material, Frame, 0);
+					if (bMaterialHasLerpAlpha)
 					{
-						ActorDataPtr->Material->SetTextureParameterValue(TEXT("Depth_Map_Object"), Frame.Depth);
+						ActorDataPtr->Slots.SetTextures(ActorDataPtr->Material, Frame, 1);
 					}
-					else
-					{
-						ActorDataPtr->Material->SetTextureParameterValue(TEXT("Depth_Map_Object"), nullptr);
-					}
-					
-					ActorDataPtr->Material->SetScalarParameterValue(TEXT("Opacity"), 1.0f);
+					ActorDataPtr->Slots.SetOpacity(ActorDataPtr->Material, 1.0f);
 					MeshComp->SetMaterial(0, ActorDataPtr->Material);
 					ActorDataPtr->LerpAlpha = 1.0f;
 					ActorDataPtr->OpacityAlpha = 1.0f;
@@ -451,373 +525,473 @@ void AComfyStreamActor::SpawnTextureActor(const FComfyFrame& Frame, const FVecto
 	ActorDataPtr->bIsFadingOut = false;
 	if (ActorDataPtr->Material)
 	{
-		ActorDataPtr->Material->SetScalarParameterValue(TEXT("Opacity"), 1.0f);
+		ActorDataPtr->Slots.SetOpacity(ActorDataPtr->Material, 1.0f);
 	}
 	// Clear any existing destroy timer (actors should not auto-destroy)
 	GetWorld()->GetTimerManager().ClearTimer(ActorDataPtr->DestroyTimer);
+	return ActorDataPtr;
 }
 
-AActor* AComfyStreamActor::FindOrSpawnActorAtLocation(const FVector& WorldPosition)
+bool AComfyStreamActor::StartMaterialCrossfade(const FComfyFrame& From, const FComfyFrame& To)
 {
-	UWorld* World = GetWorld();
-
-	//Check for existing actor at same location
-	for (FActorLerpData& Data : ActorData)
+	if (!bMaterialHasLerpAlpha)
 	{
-		if (Data.Actor && IsValid(Data.Actor))
-		{
-			// Check distance from stored position
-			float Distance = FVector::Dist(Data.Position, WorldPosition);
-			if (Distance < LocationThreshold)
-			{
-				// Update position smoothly to prevent drift
-				// Only update if there's a significant change to avoid micro-movements
-				if (Distance > 1.0f)
-				{
-					// Smoothly lerp to new position
-					FVector CurrentActorPos = Data.Actor->GetActorLocation();
-					FVector LerpedPosition = FMath::Lerp(CurrentActorPos, WorldPosition, 0.1f);
-					Data.Actor->SetActorLocation(LerpedPosition);
-					Data.Position = LerpedPosition;
-				}
-				return Data.Actor;
-			}
-		}
+		return false;
 	}
 
-	//No existing actor - spawn new one
-	FRotator DisplayRotation = DisplayMesh ? DisplayMesh->GetComponentRotation() : FRotator(90, 0, -90);
-	AActor* SpawnedActor = World->SpawnActor<AActor>(AActor::StaticClass(), WorldPosition, DisplayRotation);
-
-	UStaticMeshComponent* MeshComp = NewObject<UStaticMeshComponent>(SpawnedActor);
-	MeshComp->SetStaticMesh(DisplayMesh->GetStaticMesh());
-	
-	MeshComp->RegisterComponent();
-	SpawnedActor->SetRootComponent(MeshComp);
-	SpawnedActor->SetActorLocation(WorldPosition);
-	SpawnedActor->SetActorRotation(DisplayRotation);
-	MeshComp->SetVisibility(true);
+	// The new frame is bound as current first (also spawns/finds the actor and fits it to the ROI)
+	ApplyTexturesToMaterial(To);
+	FActorLerpData* Data = SpawnTextureActor(To, GetDisplayActorLocation(To));
+	if (!Data || !IsValid(Data->Material))
+	{
+		return true;
+	}
 
-	SpawnedTextureActors.Add(SpawnedActor);
-	return SpawnedActor;
-}
+	// One ROI_Rect and one MaskInRGBAlpha per material - such frame pairs switch instantly (as the CPU blend does)
+	if (From.IsMaskPacked() != To.IsMaskPacked() || From.RoiOffset != To.RoiOffset || From.RoiScale != To.RoiScale ||
+	    !IsTextureSafeForMaterial(From.RGB) || !IsTextureSafeForMaterial(From.Mask))
+	{
+		if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamActor] Frames can't be crossfaded (layout changed) - instant transition"));
+		return true;
+	}
 
-void AComfyStreamActor::ScaleActorToTextureSize(AActor* Actor, const FComfyFrame& Frame)
-{
-	if (!Actor || !DisplayMesh) return;
-	
-	UStaticMeshComponent* MeshComp = Actor->FindComponentByClass<UStaticMeshComponent>();
-	if (!MeshComp) return;
-	
-	// Get the DisplayMesh's scale
-	FVector DisplayMeshScale = DisplayMesh->GetComponentScale();
-	
-	// Apply the same scale to the spawned actor's mesh component
-	MeshComp->SetWorldScale3D(DisplayMeshScale);
-	
-	if(debug) UE_LOG(LogTemp, Verbose, TEXT("[ComfyStreamActor] Scaled actor to match DisplayMesh scale: (%.2f, %.2f, %.2f)"), 
-		DisplayMeshScale.X, DisplayMeshScale.Y, DisplayMeshScale.Z);
+	// Previous frame in the base slots, new one in *_New; from here on only LerpAlpha changes
+	Data->Slots.SetTextures(Data->Material, From, 0);
+	Data->Slots.SetTextures(Data->Material, To, 1);
+	Data->Slots.SetLerpAlpha(Data->Material, 0.0f);
+	Data->LerpAlpha = 0.0f;
+	Data->LerpElapsed = 0.0f;
+	Data->LerpDuration = bEnableInterpolation ? GetTransitionDuration() : 1.0f / FMath::Max(LerpSpeed, KINDA_SMALL_NUMBER);
+	PresentationStats.TransitionMs = Data->LerpDuration * 1000.0f;
+	Data->bEaseLerp = bEnableInterpolation && bUseSmoothEasing;
+	Data->bIsLerping = true;
+
+	if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamActor] Material crossfade started (%.2f s)"), Data->LerpDuration);
+	return true;
 }
 
-void AComfyStreamActor::UpdateActorLerp(FActorLerpData& Data, const FComfyFrame& Frame, float DeltaTime)
+float AComfyStreamActor::EaseInterpolation(float LinearAlpha) const
 {
-	if (!Data.bIsLerping || !IsValid(Data.Material)) return;
-	UMaterialInstanceDynamic* material = Cast<UMaterialInstanceDynamic>(Data.Material);
-	if (!material) return;
-	
-	Data.LerpAlpha = FMath::Clamp(Data.LerpAlpha + (DeltaTime * LerpSpeed), 0.0f, 1.0f);
-	material->SetScalarParameterValue(TEXT("LerpAlpha"), Data.LerpAlpha);
-
-		if (Data.LerpAlpha >= 1.0f)
-		{
-			//Lerp complete - swap textures
-			UTexture* NewRGB = nullptr;
-			UTexture* NewDepth = nullptr;
-			UTexture* NewMask = nullptr;
-			material->GetTextureParameterValue(TEXT("RGB_Map_New"), NewRGB);
-			material->GetTextureParameterValue(TEXT("Depth_Map_New"), NewDepth);
-			material->GetTextureParameterValue(TEXT("Mask_Map_New"), NewMask);
-
-			// Swap required textures (RGB and Mask)
-			if (IsValid(NewRGB)) material->SetTextureParameterValue(TEXT("RGB_Map"), NewRGB);
-			if (IsValid(NewMask)) material->SetTextureParameterValue(TEXT("Mask_Map"), NewMask);
-			
-			// Swap Depth if available (optional)
-			if (IsValid(NewDepth))
-			{
-				material->SetTextureParameterValue(TEXT("Depth_Map_Object"), NewDepth);
-			}
-			else
-			{
-				material->SetTextureParameterValue(TEXT("Depth_Map_Object"), nullptr);
-			}
-
-			Data.bIsLerping = false;
-		}
+	// Smooth step (ease-in-out cubic): 3t^2 - 2t^3
+	return bUseSmoothEasing ? LinearAlpha * LinearAlpha * (3.0f - 2.0f * LinearAlpha) : LinearAlpha;
 }
 
-void AComfyStreamActor::DestroyActorDelayed(AActor* Actor)
+FIntVector AComfyStreamActor::GetActorCell(const FVector& Position) const
 {
-	// Actors now persist permanently - no auto-destruction
-	// This function is kept for compatibility but does nothing
-	// Actors will only be replaced when a new frame arrives
+	const double CellSize = FMath::Max(LocationThreshold, 1.0f);
+	return FIntVector(FMath::FloorToInt32(Position.X / CellSize), FMath::FloorToInt32(Position.Y / CellSize), FMath::FloorToInt32(Position.Z / CellSize));
 }
 
-// Helper: returns true if texture can be safely used for pixel blending (has valid PlatformData + Mips)
-static bool CanSafelyBlendTexture(UTexture2D* Tex)
+void AComfyStreamActor::RebuildActorCells()
 {
-	if (!Tex || !IsValid(Tex)) return false;
-	FTexturePlatformData* PD = Tex->GetPlatformData();
-	// Reject null or common invalid sentinel (0xFFFFFFFFFFFFFFFF) that can cause access violations
-	if (!PD || reinterpret_cast<uintptr_t>(PD) == static_cast<uintptr_t>(-1)) return false;
-	if (PD->Mips.Num() <= 0) return false;
-	return true;
+	ActorCells.Reset();
+	for (int32 i = 0; i < ActorData.Num(); i++)
+	{
+		ActorCells.Add(GetActorCell(ActorData[i].Position), i);
+	}
 }
 
-void AComfyStreamActor::GenerateInterpolatedFrames(const FComfyFrame& FromFrame, const FComfyFrame& ToFrame)
+FActorLerpData* AComfyStreamActor::FindOrAcquireActorAtLocation(const FVector& WorldPosition)
 {
-	if (!bEnableInterpolation || NumInterpolatedFrames <= 0)
+	// Cells are LocationThreshold wide, so an actor within the threshold sits in one of the 27 surrounding cells
+	const FIntVector Cell = GetActorCell(WorldPosition);
+	TArray<int32, TInlineAllocator<8>> Candidates;
+	for (int32 DZ = -1; DZ <= 1; DZ++)
 	{
-		return;
+		for (int32 DY = -1; DY <= 1; DY++)
+		{
+			for (int32 DX = -1; DX <= 1; DX++)
+			{
+				ActorCells.MultiFind(Cell + FIntVector(DX, DY, DZ), Candidates);
+			}
+		}
 	}
 
-	// If RGB textures can't be safely blended (runtime/ComfyUI textures often lack valid PlatformData),
-	// skip interpolation and apply the new frame directly to avoid crashes in BlendTextures
-	if (!CanSafelyBlendTexture(FromFrame.RGB) || !CanSafelyBlendTexture(ToFrame.RGB) ||
-	    !CanSafelyBlendTexture(FromFrame.Mask) || !CanSafelyBlendTexture(ToFrame.Mask))
+	int32 Found = INDEX_NONE;
+	float Distance = LocationThreshold;
+	for (int32 Index : Candidates)
 	{
-		InterpolationQueue.Empty();
-		if (ToFrame.IsComplete())
+		const FActorLerpData& Data = ActorData[Index];
+		const float CandidateDistance = FVector::Dist(Data.Position, WorldPosition);
+		if (IsValid(Data.Actor) && CandidateDistance < Distance)
 		{
-			FInterpolatedFrame FinalFrame;
-			FinalFrame.Frame = ToFrame;
-			FinalFrame.TimeRemaining = 0.0f;
-			InterpolationQueue.Add(FinalFrame);
+			Found = Index;
+			Distance = CandidateDistance;
 		}
-		if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamActor] Skipping interpolation - textures not blendable (using instant transition)"));
-		return;
 	}
 
-	// Clear existing interpolation queue
-	InterpolationQueue.Empty();
-
-	// Generate interpolated frames with smooth easing
-	for (int32 i = 1; i <= NumInterpolatedFrames; ++i)
+	if (Found != INDEX_NONE)
 	{
-		// Calculate linear alpha (0.0 to 1.0)
-		float LinearAlpha = float(i) / float(NumInterpolatedFrames + 1);
-		
-		// Apply smooth easing function (ease-in-out cubic) for more natural transitions
-		float Alpha = LinearAlpha;
-		if (bUseSmoothEasing)
+		FActorLerpData& Data = ActorData[Found];
+		// Update position smoothly to prevent drift
+		// Only update if there's a significant change to avoid micro-movements
+		if (Distance > 1.0f)
 		{
-			// Smooth step (ease-in-out cubic): 3t^2 - 2t^3
-			Alpha = LinearAlpha * LinearAlpha * (3.0f - 2.0f * LinearAlpha);
-			// Alternative: ease-in-out cubic (even smoother)
-			// Alpha = LinearAlpha < 0.5f ? 4.0f * LinearAlpha * LinearAlpha * LinearAlpha : 1.0f - FMath::Pow(-2.0f * LinearAlpha + 2.0f, 3.0f) / 2.0f;
-		}
-		
-		FComfyFrame InterpolatedFrame;
-		
-		// Blend RGB textures
-		if (IsValid(FromFrame.RGB) && IsValid(ToFrame.RGB))
-		{
-			InterpolatedFrame.RGB = BlendTextures(FromFrame.RGB, ToFrame.RGB, Alpha);
-		}
-		else if (IsValid(ToFrame.RGB))
-		{
-			InterpolatedFrame.RGB = ToFrame.RGB;
-		}
-		else if (IsValid(FromFrame.RGB))
-		{
-			InterpolatedFrame.RGB = FromFrame.RGB;
+			// Smoothly lerp to new position
+			FVector CurrentActorPos = Data.Actor->GetActorLocation();
+			FVector LerpedPosition = FMath::Lerp(CurrentActorPos, WorldPosition, 0.1f);
+			Data.Actor->SetActorLocation(LerpedPosition);
+			if (GetActorCell(LerpedPosition) != GetActorCell(Data.Position))
+			{
+				ActorCells.RemoveSingle(GetActorCell(Data.Position), Found);
+				ActorCells.Add(GetActorCell(LerpedPosition), Found);
+			}
+			Data.Position = LerpedPosition;
 		}
+		return &Data;
+	}
 
-		// Blend Mask textures
-		if (IsValid(FromFrame.Mask) && IsValid(ToFrame.Mask))
-		{
-			InterpolatedFrame.Mask = BlendTextures(FromFrame.Mask, ToFrame.Mask, Alpha);
-		}
-		else if (IsValid(ToFrame.Mask))
-		{
-			InterpolatedFrame.Mask = ToFrame.Mask;
-		}
-		else if (IsValid(FromFrame.Mask))
-		{
-			InterpolatedFrame.Mask = FromFrame.Mask;
-		}
+	const FRotator DisplayRotation = DisplayMesh ? DisplayMesh->GetComponentRotation() : FRotator(90, 0, -90);
 
-		// Blend Depth textures (optional)
-		if (IsValid(FromFrame.Depth) && IsValid(ToFrame.Depth))
+	// At the cap the least recently used actor moves here (keeps its material instance)
+	if (MaxDisplayActors > 0 && ActorData.Num() >= MaxDisplayActors)
+	{
+		// Entries whose actor was destroyed elsewhere are taken first and get a new actor
+		int32 Oldest = 0;
+		for (int32 i = 0; i < ActorData.Num(); i++)
 		{
-			InterpolatedFrame.Depth = BlendTextures(FromFrame.Depth, ToFrame.Depth, Alpha);
+			if (!IsValid(ActorData[i].Actor))
+			{
+				Oldest = i;
+				break;
+			}
+			if (ActorData[i].LastUsedTime < ActorData[Oldest].LastUsedTime)
+			{
+				Oldest = i;
+			}
 		}
-		else if (IsValid(ToFrame.Depth))
+		FActorLerpData& Data = ActorData[Oldest];
+		ActorCells.RemoveSingle(GetActorCell(Data.Position), Oldest);
+		if (UWorld* World = GetWorld())
 		{
-			InterpolatedFrame.Depth = ToFrame.Depth;
+			World->GetTimerManager().ClearTimer(Data.DestroyTimer);
+			World->GetTimerManager().ClearTimer(Data.LerpTimer);
 		}
-		else if (IsValid(FromFrame.Depth))
+		if (!IsValid(Data.Actor))
 		{
-			InterpolatedFrame.Depth = FromFrame.Depth;
+			Data = FActorLerpData();
+			Data.Actor = CreateDisplayActor(WorldPosition);
+			if (!Data.Actor)
+			{
+				ActorData.RemoveAtSwap(Oldest);
+				RebuildActorCells();
+				return nullptr;
+			}
 		}
+		ActorCells.Add(Cell, Oldest);
+		Data.Position = WorldPosition;
+		Data.bIsLerping = false;
+		Data.Actor->SetActorLocationAndRotation(WorldPosition, DisplayRotation);
+		if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamActor] Display actor cap (%d) reached - moving least recently used actor"), MaxDisplayActors);
+		return &Data;
+	}
 
-		// Only add if frame is complete
-		if (InterpolatedFrame.IsComplete())
+	// Pooled actor (skipping ones destroyed elsewhere), or a new one when the pool is empty
+	FActorLerpData Entry;
+	while (ActorPool.Num() > 0 && !IsValid(ActorPool.Last().Actor))
+	{
+		ActorPool.Pop(EAllowShrinking::No);
+	}
+	if (ActorPool.Num() > 0)
+	{
+		Entry = ActorPool.Pop(EAllowShrinking::No);
+		Entry.Actor->SetActorLocationAndRotation(WorldPosition, DisplayRotation);
+		Entry.Actor->SetActorHiddenInGame(false);
+	}
+	else
+	{
+		Entry.Actor = CreateDisplayActor(WorldPosition);
+		if (!Entry.Actor)
 		{
-			FInterpolatedFrame QueueEntry;
-			QueueEntry.Frame = InterpolatedFrame;
-			QueueEntry.TimeRemaining = InterpolationDuration / float(NumInterpolatedFrames + 1); // +1 to include final frame timing
-			InterpolationQueue.Add(QueueEntry);
+			return nullptr;
 		}
 	}
-	
-	// Add the final frame (ToFrame) at the end of interpolation
-	if (ToFrame.IsComplete())
+	Entry.Position = WorldPosition;
+
+	const int32 Index = ActorData.Add(MoveTemp(Entry));
+	ActorCells.Add(Cell, Index);
+	return &ActorData[Index];
+}
+
+AActor* AComfyStreamActor::CreateDisplayActor(const FVector& WorldPosition)
+{
+	UWorld* World = GetWorld();
+	if (!World || !DisplayMesh)
 	{
-		FInterpolatedFrame FinalFrame;
-		FinalFrame.Frame = ToFrame;
-		FinalFrame.TimeRemaining = InterpolationDuration / float(NumInterpolatedFrames + 1);
-		InterpolationQueue.Add(FinalFrame);
+		return nullptr;
 	}
 
-	if(debug) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamActor] Generated %d interpolated frames"), InterpolationQueue.Num());
+	FRotator DisplayRotation = DisplayMesh->GetComponentRotation();
+	AActor* SpawnedActor = World->SpawnActor<AActor>(AActor::StaticClass(), WorldPosition, DisplayRotation);
+	if (!SpawnedActor)
+	{
+		return nullptr;
+	}
+
+	// Scene root at the frame centre; the mesh is a child so it can be offset to a cropped ROI
+	USceneComponent* Root = NewObject<USceneComponent>(SpawnedActor);
+	Root->RegisterComponent();
+	SpawnedActor->SetRootComponent(Root);
+
+	UStaticMeshComponent* MeshComp = NewObject<UStaticMeshComponent>(SpawnedActor);
+	MeshComp->SetStaticMesh(DisplayMesh->GetStaticMesh());
+	MeshComp->SetupAttachment(Root);
+	MeshComp->RegisterComponent();
+
+	SpawnedActor->SetActorLocation(WorldPosition);
+	SpawnedActor->SetActorRotation(DisplayRotation);
+	MeshComp->SetVisibility(true);
+
+	SpawnedTextureActors.Add(SpawnedActor);
+	return SpawnedActor;
 }
 
-UTexture2D* AComfyStreamActor::BlendTextures(UTexture2D* TextureA, UTexture2D* TextureB, float Alpha)
+void AComfyStreamActor::CreateDisplayMaterial(FActorLerpData& Entry)
 {
-	if (!TextureA || !TextureB || !IsValid(TextureA) || !IsValid(TextureB))
+	UStaticMeshComponent* MeshComp = IsValid(Entry.Actor) ? Entry.Actor->FindComponentByClass<UStaticMeshComponent>() : nullptr;
+	if (!MeshComp || !BaseMaterial)
 	{
-		return Alpha >= 0.5f ? TextureB : TextureA;
+		return;
 	}
+	Entry.Material = UMaterialInstanceDynamic::Create(BaseMaterial, Entry.Actor);
+	if (Entry.Material)
+	{
+		Entry.Slots.Resolve(Entry.Material);
+		MeshComp->SetMaterial(0, Entry.Material);
+	}
+}
 
-	// Runtime/dynamic textures may not have PlatformData - skip pixel blend and fallback to source
-	// Also reject invalid sentinel pointer (0xFFFFFFFFFFFFFFFF) that causes access violations
-	FTexturePlatformData* PDA = TextureA->GetPlatformData();
-	FTexturePlatformData* PDB = TextureB->GetPlatformData();
-	if (!PDA || !PDB ||
-	    reinterpret_cast<uintptr_t>(PDA) == static_cast<uintptr_t>(-1) ||
-	    reinterpret_cast<uintptr_t>(PDB) == static_cast<uintptr_t>(-1))
+void AComfyStreamActor::ReleaseDisplayActor(int32 Index)
+{
+	if (!ActorData.IsValidIndex(Index))
 	{
-		return Alpha >= 0.5f ? TextureB : TextureA;
+		return;
 	}
 
-	// Clamp alpha
-	Alpha = FMath::Clamp(Alpha, 0.0f, 1.0f);
+	FActorLerpData Entry = MoveTemp(ActorData[Index]);
+	ActorData.RemoveAtSwap(Index);
+	RebuildActorCells();
+	if (!IsValid(Entry.Actor))
+	{
+		return;
+	}
+
+	Entry.Actor->SetActorHiddenInGame(true);
+	Entry.bIsLerping = false;
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(Entry.DestroyTimer);
+		World->GetTimerManager().ClearTimer(Entry.LerpTimer);
+	}
+	ActorPool.Add(MoveTemp(Entry));
+}
 
-	// Get texture dimensions - use the smaller dimensions
-	int32 WidthA = TextureA->GetSizeX();
-	int32 HeightA = TextureA->GetSizeY();
-	int32 WidthB = TextureB->GetSizeX();
-	int32 HeightB = TextureB->GetSizeY();
+void AComfyStreamActor::ScaleActorToTextureSize(AActor* Actor, const FComfyFrame& Frame)
+{
+	if (!Actor || !DisplayMesh) return;
+	
+	UStaticMeshComponent* MeshComp = Actor->FindComponentByClass<UStaticMeshComponent>();
+	if (!MeshComp) return;
+	
+	// Get the DisplayMesh's scale
+	FVector DisplayMeshScale = DisplayMesh->GetComponentScale();
 
-	int32 Width = FMath::Min(WidthA, WidthB);
-	int32 Height = FMath::Min(HeightA, HeightB);
+	// Cropped frames cover only part of the full frame: shrink the plane to the ROI and move it
+	// to where the ROI sits in the full frame (plane local X follows U, local Y follows V)
+	FVector RoiScale(Frame.RoiScale.X, Frame.RoiScale.Y, 1.0);
+	FVector RoiOffset = FVector::ZeroVector;
+	if (Frame.HasRoi() && DisplayMesh->GetStaticMesh())
+	{
+		const FVector MeshSize = DisplayMesh->GetStaticMesh()->GetBounds().BoxExtent * 2.0;
+		const FVector2D RoiCenter = Frame.RoiOffset + Frame.RoiScale * 0.5;
+		RoiOffset = FVector((RoiCenter.X - 0.5) * MeshSize.X * DisplayMeshScale.X,
+		                    (RoiCenter.Y - 0.5) * MeshSize.Y * DisplayMeshScale.Y,
+		                    0.0);
+	}
 
-	if (Width <= 0 || Height <= 0)
+	// Actors placed at the subject keep the image at the frame centre (this actor's location)
+	if (bPlaceActorsAtSubject)
 	{
-		return Alpha >= 0.5f ? TextureB : TextureA;
+		RoiOffset += Actor->GetActorRotation().UnrotateVector(GetActorLocation() - Actor->GetActorLocation());
 	}
 
-	// Read pixel data from both textures
-	TArray<FColor> PixelsA;
-	TArray<FColor> PixelsB;
+	// Apply the same scale to the spawned actor's mesh component
+	MeshComp->SetWorldScale3D(DisplayMeshScale * RoiScale);
+	MeshComp->SetRelativeLocation(RoiOffset);
 	
-	bool bReadA = false;
-	bool bReadB = false;
+	if(debug) UE_LOG(LogTemp, Verbose, TEXT("[ComfyStreamActor] Scaled actor to match DisplayMesh scale: (%.2f, %.2f, %.2f), ROI offset (%.3f, %.3f) scale (%.3f, %.3f)"), 
+		DisplayMeshScale.X, DisplayMeshScale.Y, DisplayMeshScale.Z,
+		Frame.RoiOffset.X, Frame.RoiOffset.Y, Frame.RoiScale.X, Frame.RoiScale.Y);
+}
 
-	// Try to read TextureA
-	if (TextureA->GetPlatformData() && TextureA->GetPlatformData()->Mips.Num() > 0)
+void AComfyStreamActor::UpdateActorLerp(FActorLerpData& Data, const FComfyFrame& Frame, float DeltaTime)
+{
+	if (!Data.bIsLerping || !IsValid(Data.Material)) return;
+	UMaterialInstanceDynamic* material = Cast<UMaterialInstanceDynamic>(Data.Material);
+	if (!material) return;
+	
+	// Crossfades run for a fixed duration with easing; untimed lerps advance by LerpSpeed
+	if (Data.LerpDuration > 0.0f)
 	{
-		FTexture2DMipMap& MipA = TextureA->GetPlatformData()->Mips[0];
-		if (MipA.BulkData.GetBulkDataSize() > 0)
+		Data.LerpElapsed += DeltaTime;
+		Data.LerpAlpha = FMath::Clamp(Data.LerpElapsed / Data.LerpDuration, 0.0f, 1.0f);
+	}
+	else
+	{
+		Data.LerpAlpha = FMath::Clamp(Data.LerpAlpha + (DeltaTime * LerpSpeed), 0.0f, 1.0f);
+	}
+	Data.Slots.SetLerpAlpha(material, Data.bEaseLerp ? EaseInterpolation(Data.LerpAlpha) : Data.LerpAlpha);
+
+	if (Data.LerpAlpha >= 1.0f)
+	{
+		//Lerp complete - the *_New textures become current
+		Data.Slots.PromoteNewSlot(material);
+		Data.bIsLerping = false;
+	}
+}
+
+void AComfyStreamActor::DestroyActorDelayed(AActor* Actor)
+{
+	// Actors persist until EndPlay; a released actor is hidden and reused for the next new location
+	for (int32 i = 0; i < ActorData.Num(); i++)
+	{
+		if (ActorData[i].Actor == Actor)
 		{
-			const FColor* PixelsA_Raw = static_cast<const FColor*>(MipA.BulkData.LockReadOnly());
-			if (PixelsA_Raw)
-			{
-				PixelsA.SetNumUninitialized(WidthA * HeightA);
-				FMemory::Memcpy(PixelsA.GetData(), PixelsA_Raw, WidthA * HeightA * sizeof(FColor));
-				MipA.BulkData.Unlock();
-				bReadA = true;
-			}
+			ReleaseDisplayActor(i);
+			return;
 		}
 	}
+}
 
-	// Try to read TextureB
-	if (TextureB->GetPlatformData() && TextureB->GetPlatformData()->Mips.Num() > 0)
+void AComfyStreamActor::StartCpuBlend(const FComfyFrame& FromFrame, const FComfyFrame& ToFrame)
+{
+	// Blending works on the frames' CPU pixels; frames without them (or with a different packing/ROI) switch instantly
+	const bool bBlendable = FromFrame.RGBPixels.IsValid() && ToFrame.RGBPixels.IsValid() &&
+	                        FromFrame.MaskPixels.IsValid() && ToFrame.MaskPixels.IsValid() &&
+	                        FromFrame.IsMaskPacked() == ToFrame.IsMaskPacked() &&
+	                        FromFrame.RoiOffset == ToFrame.RoiOffset && FromFrame.RoiScale == ToFrame.RoiScale;
+	if (!bBlendable)
 	{
-		FTexture2DMipMap& MipB = TextureB->GetPlatformData()->Mips[0];
-		if (MipB.BulkData.GetBulkDataSize() > 0)
+		ApplyInterpolatedFrame(ToFrame, GetDisplayActorLocation(ToFrame));
+		if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamActor] Skipping interpolation - frames not blendable (using instant transition)"));
+		return;
+	}
+
+	// Nothing is rendered up front - UpdateCpuBlend blends only the step that is displayed.
+	// Every step goes to the same display actor, so only that actor ever binds the ping-pong textures.
+	BlendFromFrame = FromFrame;
+	BlendToFrame = ToFrame;
+	BlendLocation = GetDisplayActorLocation(ToFrame);
+	InterpolationTimer = 0.0f;
+	BlendDuration = GetTransitionDuration();
+	PresentationStats.TransitionMs = BlendDuration * 1000.0f;
+	LastBlendStep = INDEX_NONE;
+	bCpuBlending = true;
+
+	BlendFlow.Reset();
+	const uint32 Generation = ++FlowGeneration;
+	if (InterpolationMode == EComfyInterpolationMode::MotionCompensated)
+	{
+		// Flow on RGB luma, guided by both masks; plain blend steps are shown until it arrives
+		TWeakObjectPtr<AComfyStreamActor> WeakThis(this);
+		FComfyImageRef FromRGB = FromFrame.RGBPixels, ToRGB = ToFrame.RGBPixels;
+		FComfyImageRef FromMask = FromFrame.MaskPixels, ToMask = ToFrame.MaskPixels;
+		Async(EAsyncExecution::ThreadPool, [WeakThis, Generation, FromRGB, ToRGB, FromMask, ToMask]()
 		{
-			const FColor* PixelsB_Raw = static_cast<const FColor*>(MipB.BulkData.LockReadOnly());
-			if (PixelsB_Raw)
+			TSharedPtr<FComfyFlowField, ESPMode::ThreadSafe> Flow = MakeShared<FComfyFlowField, ESPMode::ThreadSafe>();
+			if (!FComfyMotionFlow::EstimateFlow(*FromRGB, *ToRGB, FromMask.Get(), ToMask.Get(), *Flow))
 			{
-				PixelsB.SetNumUninitialized(WidthB * HeightB);
-				FMemory::Memcpy(PixelsB.GetData(), PixelsB_Raw, WidthB * HeightB * sizeof(FColor));
-				MipB.BulkData.Unlock();
-				bReadB = true;
+				return;
 			}
-		}
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, Generation, Flow]()
+			{
+				AComfyStreamActor* This = WeakThis.Get();
+				if (!This || Generation != This->FlowGeneration || !This->bCpuBlending)
+				{
+					return;
+				}
+				This->BlendFlow = Flow;
+				// Redo the current step with motion compensation
+				This->LastBlendStep = INDEX_NONE;
+			});
+		});
 	}
+}
 
-	if (!bReadA || !bReadB)
+void AComfyStreamActor::UpdateCpuBlend(float DeltaTime)
+{
+	InterpolationTimer += DeltaTime;
+	const float Progress = FMath::Clamp(InterpolationTimer / FMath::Max(BlendDuration, KINDA_SMALL_NUMBER), 0.0f, 1.0f);
+	if (Progress >= 1.0f)
 	{
-		return Alpha >= 0.5f ? TextureB : TextureA;
+		FinishCpuBlend();
+		return;
 	}
 
-	// Create blended texture
-	UTexture2D* BlendedTexture = UTexture2D::CreateTransient(Width, Height, PF_B8G8R8A8);
-	if (!BlendedTexture)
+	// NumInterpolatedFrames steps per transition: a blend is only computed when the displayed step changes
+	const int32 Steps = NumInterpolatedFrames + 1;
+	const int32 Step = FMath::Clamp(FMath::FloorToInt32(Progress * Steps), 0, Steps - 1);
+	if (Step == LastBlendStep)
 	{
-		return Alpha >= 0.5f ? TextureB : TextureA;
+		return;
 	}
-
-	BlendedTexture->SRGB = TextureA->SRGB;
-	BlendedTexture->CompressionSettings = TextureA->CompressionSettings;
-	BlendedTexture->Filter = TF_Bilinear;
-
-	// Blend pixels
-	TArray<FColor> BlendedPixels;
-	BlendedPixels.SetNumUninitialized(Width * Height);
-
-	for (int32 Y = 0; Y < Height; ++Y)
+	LastBlendStep = Step;
+	const float Alpha = EaseInterpolation(float(Step) / float(Steps));
+	const int32 Weight = FMath::RoundToInt32(Alpha * 256.0f);
+	const FComfyFlowField* Flow = BlendFlow.IsValid() ? BlendFlow.Get() : nullptr;
+
+	// Blend one channel into its ping-pong textures (warped along the flow when there is one),
+	// or show the target's texture when the pair can't be blended
+	auto BlendChannel = [Weight, Alpha, Flow](FComfyBlendTexture& Channel, const FComfyImageRef& From, const FComfyImageRef& To, UTexture2D* ToTexture) -> UTexture2D*
 	{
-		for (int32 X = 0; X < Width; ++X)
+		if (!From.IsValid() || !To.IsValid())
 		{
-			int32 IdxA = Y * WidthA + X;
-			int32 IdxB = Y * WidthB + X;
-			int32 IdxBlended = Y * Width + X;
-
-			if (IdxA < PixelsA.Num() && IdxB < PixelsB.Num())
+			return ToTexture;
+		}
+		UTexture2D* Blended = nullptr;
+		if (Flow && From->IsValid() && To->IsValid() && From->Width == To->Width && From->Height == To->Height && From->Format == To->Format)
+		{
+			Blended = Channel.Write(To->Width, To->Height, To->Format, [&](uint8* Dst)
 			{
-				FColor PixelA = PixelsA[IdxA];
-				FColor PixelB = PixelsB[IdxB];
-
-				// Linear interpolation
-				FColor Blended;
-				Blended.R = FMath::Lerp(PixelA.R, PixelB.R, Alpha);
-				Blended.G = FMath::Lerp(PixelA.G, PixelB.G, Alpha);
-				Blended.B = FMath::Lerp(PixelA.B, PixelB.B, Alpha);
-				Blended.A = FMath::Lerp(PixelA.A, PixelB.A, Alpha);
-
-				BlendedPixels[IdxBlended] = Blended;
-			}
+				FComfyMotionFlow::WarpBlend(*From, *To, *Flow, Alpha, Dst);
+			});
 		}
-	}
+		else
+		{
+			Blended = Channel.Blend(*From, *To, Weight);
+		}
+		return Blended ? Blended : ToTexture;
+	};
+
+	FComfyFrame Frame;
+	Frame.RoiOffset = BlendToFrame.RoiOffset;
+	Frame.RoiScale = BlendToFrame.RoiScale;
+	Frame.Analytics = BlendToFrame.Analytics;
+	Frame.RGB = BlendChannel(RGBBlend, BlendFromFrame.RGBPixels, BlendToFrame.RGBPixels, BlendToFrame.RGB);
+	// Packed masks are blended with RGB alpha
+	Frame.Mask = BlendToFrame.IsMaskPacked() ? Frame.RGB : BlendChannel(MaskBlend, BlendFromFrame.MaskPixels, BlendToFrame.MaskPixels, BlendToFrame.Mask);
+	Frame.Depth = BlendChannel(DepthBlend, BlendFromFrame.DepthPixels, BlendToFrame.DepthPixels, BlendToFrame.Depth);
+	// Normals: blended encoded XY, the material renormalizes
+	Frame.Normal = BlendChannel(NormalBlend, BlendFromFrame.NormalPixels, BlendToFrame.NormalPixels, BlendToFrame.Normal);
+
+	ApplyInterpolatedFrame(Frame, BlendLocation);
+}
 
-	// Write blended pixels to texture
-	if (BlendedTexture->GetPlatformData() && BlendedTexture->GetPlatformData()->Mips.Num() > 0)
+void AComfyStreamActor::FinishCpuBlend()
+{
+	if (!bCpuBlending)
 	{
-		FTexture2DMipMap& Mip = BlendedTexture->GetPlatformData()->Mips[0];
-		void* TextureData = Mip.BulkData.Lock(LOCK_READ_WRITE);
-		FMemory::Memcpy(TextureData, BlendedPixels.GetData(), Width * Height * sizeof(FColor));
-		Mip.BulkData.Unlock();
-		BlendedTexture->UpdateResource();
+		return;
 	}
 
-	return BlendedTexture;
+	// Final frame shows the real textures - the ping-pong textures are rewritten by the next blend
+	bCpuBlending = false;
+	ApplyInterpolatedFrame(BlendToFrame, BlendLocation);
+	BlendFromFrame = FComfyFrame();
+	BlendFlow.Reset();
 }
 
-void AComfyStreamActor::ApplyInterpolatedFrame(const FComfyFrame& Frame)
+void AComfyStreamActor::ApplyInterpolatedFrame(const FComfyFrame& Frame, const FVector& WorldPosition)
 {
 	if (!Frame.IsComplete())
 	{
@@ -825,8 +999,7 @@ void AComfyStreamActor::ApplyInterpolatedFrame(const FComfyFrame& Frame)
 	}
 
 	ApplyTexturesToMaterial(Frame);
-	FVector FixedPosition = GetActorLocation();
-	SpawnTextureActor(Frame, FixedPosition);
+	SpawnTextureActor(Frame, WorldPosition);
 }
 
 void AComfyStreamActor::HandleFullFrame(const FComfyFrame& Frame)
@@ -841,13 +1014,6 @@ void AComfyStreamActor::HandleFullFrame(const FComfyFrame& Frame)
 		return;
 	}
 	
-	// Reset sequence index and channel flags FIRST, before processing frame
-	// This ensures next frame's textures start with clean state
-	SeqIndex = 0;
-	bHasRGB = false;
-	bHasDepth = false;
-	bHasMask = false;
-	
 	LatestFrame = Frame;
 	
 	if(debug) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamActor] Received complete frame - RGB=%s, Mask=%s, Depth=%s"), 
@@ -855,22 +1021,29 @@ void AComfyStreamActor::HandleFullFrame(const FComfyFrame& Frame)
 		IsValid(Frame.Mask) ? *Frame.Mask->GetName() : TEXT("NULL"),
 		IsValid(Frame.Depth) ? *Frame.Depth->GetName() : TEXT("NULL"));
 	
-	// Check if this is actually a new frame (textures are different from last applied frame)
+	// Check if this is actually a new frame (textures are different from the newest queued or last applied frame)
 	// Only update if we have a new complete frame ready to replace the current one
+	const FComfyFrame& ReferenceFrame = FrameQueue.Num() > 0 ? FrameQueue.Last() : LastAppliedFrame;
 	bool bIsNewFrame = false;
-	if (!LastAppliedFrame.IsComplete())
+	if (!ReferenceFrame.IsComplete())
 	{
 		// First frame - always apply
 		bIsNewFrame = true;
 		if(debug) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamActor] First frame received, applying to actor"));
 	}
+	else if (Frame.FrameNumber > 0 || LastAppliedFrame.FrameNumber > 0)
+	{
+		// Ingest frames are numbered; delta uploads reuse ring textures, so texture identity is not enough
+		bIsNewFrame = Frame.FrameNumber != LastAppliedFrame.FrameNumber;
+		if(debug && bIsNewFrame) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamActor] New frame %d detected, applying to actor"), Frame.FrameNumber);
+	}
 	else
 	{
 		// Compare textures to see if this is a new frame
 		// RGB and Mask are required, Depth is optional
-		if (Frame.RGB != LastAppliedFrame.RGB ||
-			Frame.Mask != LastAppliedFrame.Mask ||
-			Frame.Depth != LastAppliedFrame.Depth)  // Compare depth even if null
+		if (Frame.RGB != ReferenceFrame.RGB ||
+			Frame.Mask != ReferenceFrame.Mask ||
+			Frame.Depth != ReferenceFrame.Depth)  // Compare depth even if null
 		{
 			bIsNewFrame = true;
 			if(debug) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamActor] New frame detected (textures changed), applying to actor"));
@@ -896,61 +1069,174 @@ void AComfyStreamActor::HandleFullFrame(const FComfyFrame& Frame)
 			}
 		}
 
-		if (FrameApplyDelaySeconds > 0.0f)
+		// Shown when due (immediately when neither the jitter buffer nor FrameApplyDelaySeconds hold it)
+		ScheduleFrame(Frame);
+	}
+	else
+	{
+		if(debug) UE_LOG(LogTemp, Verbose, TEXT("[ComfyStreamActor] Frame unchanged, skipping update"));
+	}
+}
+
+void AComfyStreamActor::ScheduleFrame(FComfyFrame Frame)
+{
+	const double Now = FPlatformTime::Seconds();
+	const double Arrival = Frame.ArrivalTime > 0.0 ? Frame.ArrivalTime : Now;
+
+	// Smoothed interval (1/8) and interarrival jitter (1/16, RFC 3550)
+	const double Interval = LastArrivalTime > 0.0 ? Arrival - LastArrivalTime : 0.0;
+	LastArrivalTime = Arrival;
+	if (Interval >= MaxTrackedArrivalInterval)
+	{
+		MeanArrivalInterval = 0.0;
+		ArrivalJitter = 0.0;
+	}
+	else if (Interval > 0.0)
+	{
+		if (MeanArrivalInterval <= 0.0)
 		{
-			// Delayed apply: store frame and set timer (for 2nd/3rd actor staggered display)
-			UWorld* World = GetWorld();
-			if (World)
-			{
-				World->GetTimerManager().ClearTimer(DelayedApplyTimer);
-				PendingDelayedFrame = Frame;
-				World->GetTimerManager().SetTimer(
-					DelayedApplyTimer,
-					this,
-					&AComfyStreamActor::ApplyDelayedFrame,
-					FrameApplyDelaySeconds,
-					false);
-			}
+			MeanArrivalInterval = Interval;
 		}
 		else
 		{
-			// Immediate apply
-			ApplyNewFrame(Frame);
+			ArrivalJitter += (FMath::Abs(Interval - MeanArrivalInterval) - ArrivalJitter) / 16.0;
+			MeanArrivalInterval += (Interval - MeanArrivalInterval) / 8.0;
 		}
 	}
-	else
+
+	// Held for the jitter delay and kept one mean interval after the previous frame, so bursts are spread
+	// out again - but never later than MaxJitterBufferSeconds after the frame could have been shown
+	const double Earliest = Arrival + FrameApplyDelaySeconds;
+	double Presentation = Earliest;
+	double BufferDelay = 0.0;
+	if (bUseJitterBuffer && MeanArrivalInterval > 0.0)
 	{
-		if(debug) UE_LOG(LogTemp, Verbose, TEXT("[ComfyStreamActor] Frame unchanged, skipping update"));
+		BufferDelay = FMath::Min(double(JitterBufferScale) * ArrivalJitter, double(MaxJitterBufferSeconds));
+		const double Previous = FrameQueue.Num() > 0 ? FrameQueue.Last().PresentationTime : LastPresentationTime;
+		Presentation = FMath::Clamp(FMath::Max(Earliest + BufferDelay, Previous + MeanArrivalInterval), Earliest, Earliest + MaxJitterBufferSeconds);
 	}
+	Frame.ArrivalTime = Arrival;
+	Frame.PresentationTime = Presentation;
+	FrameQueue.Add(Frame);
+
+	PresentationStats.MeanIntervalMs = float(MeanArrivalInterval * 1000.0);
+	PresentationStats.JitterMs = float(ArrivalJitter * 1000.0);
+	PresentationStats.BufferDelayMs = float(BufferDelay * 1000.0);
+	PresentationStats.QueuedFrames = FrameQueue.Num();
+
+	if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamActor] Frame scheduled in %.1f ms (interval %.1f ms, jitter %.1f ms, queued %d)"),
+		(Presentation - Now) * 1000.0, MeanArrivalInterval * 1000.0, ArrivalJitter * 1000.0, FrameQueue.Num());
+
+	PresentDueFrames();
+	UpdateTickState();
 }
 
-void AComfyStreamActor::ApplyDelayedFrame()
+void AComfyStreamActor::PresentDueFrames()
 {
-	if (UWorld* World = GetWorld())
+	const double Now = FPlatformTime::Seconds();
+	int32 Due = INDEX_NONE;
+	while (Due + 1 < FrameQueue.Num() && FrameQueue[Due + 1].PresentationTime <= Now)
 	{
-		World->GetTimerManager().ClearTimer(DelayedApplyTimer);
+		++Due;
 	}
-	if (!PendingDelayedFrame.IsComplete())
+	if (Due == INDEX_NONE)
 	{
 		return;
 	}
-	ApplyNewFrame(PendingDelayedFrame);
+
+	// Only the newest due frame is shown
+	const FComfyFrame Frame = FrameQueue[Due];
+	FrameQueue.RemoveAt(0, Due + 1);
+	PresentationStats.FramesSkipped += Due;
+	PresentationStats.QueuedFrames = FrameQueue.Num();
+	LastPresentationTime = Frame.PresentationTime;
+	ApplyNewFrame(Frame);
+}
+
+float AComfyStreamActor::GetTransitionDuration() const
+{
+	if (!bAdaptInterpolationDuration || MeanArrivalInterval <= 0.0)
+	{
+		return InterpolationDuration;
+	}
+
+	// Until the next frame is due: the queued one, or one mean input interval after the frame just shown
+	const double NextDue = FrameQueue.Num() > 0 ? FrameQueue[0].PresentationTime : LastPresentationTime + MeanArrivalInterval;
+	return FMath::Max(float(NextDue - FPlatformTime::Seconds()), MinTransitionSeconds);
+}
+
+void AComfyStreamActor::UpdateTickState()
+{
+	bool bNeedsTick = bAlwaysTick || bCpuBlending || FrameQueue.Num() > 0;
+	for (int32 i = 0; i < ActorData.Num() && !bNeedsTick; ++i)
+	{
+		bNeedsTick = ActorData[i].bIsLerping;
+	}
+	if (IsActorTickEnabled() != bNeedsTick)
+	{
+		SetActorTickEnabled(bNeedsTick);
+	}
+}
+
+FComfyPresentationStats AComfyStreamActor::GetPresentationStats() const
+{
+	return PresentationStats;
+}
+
+FComfyMaskAnalytics AComfyStreamActor::GetMaskAnalytics() const
+{
+	return LastAppliedFrame.Analytics;
+}
+
+FVector AComfyStreamActor::GetSubjectLocation() const
+{
+	return LastAppliedFrame.Analytics.bHasSubject ? GetFrameWorldLocation(LastAppliedFrame.Analytics.Centroid) : GetActorLocation();
+}
+
+FVector AComfyStreamActor::GetFrameWorldLocation(const FVector2D& UV) const
+{
+	if (!DisplayMesh || !DisplayMesh->GetStaticMesh())
+	{
+		return GetActorLocation();
+	}
+	// Same plane layout as ScaleActorToTextureSize: the full frame is centred on the actor
+	const FVector MeshSize = DisplayMesh->GetStaticMesh()->GetBounds().BoxExtent * 2.0;
+	const FVector Scale = DisplayMesh->GetComponentScale();
+	const FVector Local((UV.X - 0.5) * MeshSize.X * Scale.X, (UV.Y - 0.5) * MeshSize.Y * Scale.Y, 0.0);
+	return GetActorLocation() + DisplayMesh->GetComponentRotation().RotateVector(Local);
+}
+
+FVector AComfyStreamActor::GetDisplayActorLocation(const FComfyFrame& Frame) const
+{
+	if (bPlaceActorsAtSubject && Frame.Analytics.bHasSubject)
+	{
+		return GetFrameWorldLocation(Frame.Analytics.Centroid);
+	}
+	return GetActorLocation();
 }
 
 void AComfyStreamActor::ApplyNewFrame(const FComfyFrame& Frame)
 {
-	// Generate interpolated frames if interpolation is enabled and we have a previous frame
-	if (bEnableInterpolation && PreviousFrame.IsComplete() && NumInterpolatedFrames > 0)
+	// A transition still running ends on its real target first, so no actor is left holding blend textures
+	FinishCpuBlend();
+
+	// Material crossfade: previous and new frame bound once, no pixel work or new textures per frame.
+	// Also used for the untimed LerpSpeed fade when interpolation is disabled.
+	const bool bMaterialCrossfade = !bEnableInterpolation || InterpolationMode == EComfyInterpolationMode::MaterialCrossfade;
+	if (PreviousFrame.IsComplete() && bMaterialCrossfade && StartMaterialCrossfade(PreviousFrame, Frame))
+	{
+		// The material blends between the two bound frames over InterpolationDuration
+	}
+	// CPU blend towards the new frame if interpolation is enabled and we have a previous frame
+	else if (bEnableInterpolation && PreviousFrame.IsComplete() && NumInterpolatedFrames > 0)
 	{
-		GenerateInterpolatedFrames(PreviousFrame, Frame);
-		InterpolationTimer = 0.0f;
+		StartCpuBlend(PreviousFrame, Frame);
 	}
 	else
 	{
 		// No interpolation - apply frame directly
 		ApplyTexturesToMaterial(Frame);
-		FVector FixedPosition = GetActorLocation();
-		SpawnTextureActor(Frame, FixedPosition);
+		SpawnTextureActor(Frame, GetDisplayActorLocation(Frame));
 	}
 
 	// Update previous frame for next interpolation
@@ -959,3 +1245,88 @@ void AComfyStreamActor::ApplyNewFrame(const FComfyFrame& Frame)
 	// Update last applied frame
 	LastAppliedFrame = Frame;
 }
+
+// ============================================================
+// Depth reconstruction
+// ============================================================
+
+void AComfyStreamActor::UpdateDepthMesh(const FComfyFrame& Frame)
+{
+	// Interpolated steps have no CPU depth - the mesh follows real frames
+	if (!Frame.DepthPixels.IsValid() || !DepthMeshBuffers.IsValid())
+	{
+		return;
+	}
+	if (bDepthMeshInFlight)
+	{
+		PendingDepthMeshFrame = Frame;
+		return;
+	}
+
+	FComfyDepthMeshSettings Settings;
+	if (ComfyStreamComponent)
+	{
+		Settings.FocalScale = ComfyStreamComponent->FocalScale;
+		Settings.DepthScaleUnits = ComfyStreamComponent->DepthScaleUnits;
+		Settings.MaskThreshold = (uint8)FMath::Clamp(ComfyStreamComponent->IngestSettings.CropMaskThreshold, 0, 254);
+	}
+	Settings.NearDistance = ReconstructionNearDistance;
+	Settings.GridStep = ReconstructionGridStep;
+	Settings.DepthEdgeThreshold = ReconstructionEdgeThreshold;
+	Settings.RoiOffset = Frame.RoiOffset;
+	Settings.RoiScale = Frame.RoiScale;
+
+	bDepthMeshInFlight = true;
+	const uint32 Generation = DepthMeshGeneration;
+	TWeakObjectPtr<AComfyStreamActor> WeakThis(this);
+	TSharedPtr<FComfyDepthMeshBuffers, ESPMode::ThreadSafe> Buffers = DepthMeshBuffers;
+	FComfyPixelView Depth = Frame.GetDepthView();
+	FComfyPixelView Mask = Frame.GetMaskView();
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Generation, Buffers, Depth, Mask, Settings]()
+	{
+		const bool bBuilt = FComfyDepthMesh::Build(Depth, Mask, Settings, *Buffers);
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Generation, bBuilt]()
+		{
+			AComfyStreamActor* This = WeakThis.Get();
+			if (!This || Generation != This->DepthMeshGeneration)
+			{
+				return;
+			}
+			This->OnDepthMeshBuilt(bBuilt);
+		});
+	});
+}
+
+void AComfyStreamActor::OnDepthMeshBuilt(bool bBuilt)
+{
+	bDepthMeshInFlight = false;
+
+	if (DepthMeshComponent)
+	{
+		FComfyDepthMeshBuffers& Buffers = *DepthMeshBuffers;
+		if (bBuilt && (Buffers.bTopologyChanged || DepthMeshComponent->GetNumSections() == 0))
+		{
+			// New grid size: the only time the index buffer is uploaded
+			DepthMeshComponent->CreateMeshSection(0, Buffers.Vertices, Buffers.Triangles, Buffers.Normals, Buffers.UV0,
+				TArray<FColor>(), TArray<FProcMeshTangent>(), bReconstructionCollision);
+			DepthMeshComponent->SetMaterial(0, DynMat);
+			Buffers.bTopologyChanged = false;
+		}
+		else if (bBuilt)
+		{
+			DepthMeshComponent->UpdateMeshSection(0, Buffers.Vertices, Buffers.Normals, Buffers.UV0, TArray<FColor>(), TArray<FProcMeshTangent>());
+		}
+		if (DepthMeshComponent->GetNumSections() > 0)
+		{
+			DepthMeshComponent->SetMeshSectionVisible(0, bBuilt);
+		}
+	}
+
+	// Newest frame that arrived during the build
+	if (PendingDepthMeshFrame.DepthPixels.IsValid())
+	{
+		const FComfyFrame Next = MoveTemp(PendingDepthMeshFrame);
+		PendingDepthMeshFrame = FComfyFrame();
+		UpdateDepthMesh(Next);
+	}
+}
@@ -1,6 +1,7 @@
 #include "ComfyStream/ComfyStreamComponent.h"
 #include "ComfyStream/ComfyImageFetcher.h"
 #include "ComfyStream/ComfyPngDecoder.h"
+#include "ComfyStream/ComfyFrameIngest.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
 
@@ -19,9 +20,12 @@ void UComfyStreamComponent::BeginPlay()
 	PngDecoder   = NewObject<UComfyPngDecoder>(this);
 	ImageFetcher = NewObject<UComfyImageFetcher>(this);
 	ImageFetcher->Config = StreamConfig;
+	ImageFetcher->IngestSettings = IngestSettings;
+	ImageFetcher->IngestSettings.NormalDepthScale = DepthScaleUnits;
 
 	//bind textures to internal handlers
 	ImageFetcher->OnTextureReceived.AddDynamic(this, &UComfyStreamComponent::OnTextureReceivedInternal);
+	ImageFetcher->OnFullFrameReadyNative.AddUObject(this, &UComfyStreamComponent::OnFullFrameReadyInternal);
 	ImageFetcher->OnConnectionStatusChanged.AddDynamic(this, &UComfyStreamComponent::OnConnectionStatusChangedInternal);
 	ImageFetcher->OnError.AddDynamic(this, &UComfyStreamComponent::OnErrorInternal);
 
@@ -66,6 +70,24 @@ EComfyConnectionStatus UComfyStreamComponent::GetConnectionStatus() const
 	return ConnectionStatus;
 }
 
+FComfyIngestStats UComfyStreamComponent::GetIngestStats() const
+{
+	return ImageFetcher ? ImageFetcher->GetIngestStats() : FComfyIngestStats();
+}
+
+FComfyUpscaleBenchmark UComfyStreamComponent::BenchmarkUpscale(int32 Width, int32 Height, float Factor, int32 Iterations, float GenerationMs) const
+{
+	if (GenerationMs <= 0.0f)
+	{
+		GenerationMs = GetIngestStats().FrameIntervalMs;
+	}
+	const FComfyUpscaleBenchmark Result = FComfyFrameIngest::BenchmarkUpscale(Width, Height, Factor, Iterations, GenerationMs);
+	UE_LOG(LogTemp, Display, TEXT("[ComfyStreamComponent] Upscale %dx%d -> %dx%d: %.2f ms/frame, generation %.1f ms, saved %.1f ms, est. speedup %.2fx"),
+		Result.SourceSize.X, Result.SourceSize.Y, Result.OutputSize.X, Result.OutputSize.Y,
+		Result.UpscaleMs, Result.GenerationMs, Result.GenerationMsSaved, Result.EstimatedSpeedup);
+	return Result;
+}
+
 void UComfyStreamComponent::OnTextureReceivedInternal(UTexture2D* Texture)
 {
 	// If lerp smoothing is disabled, broadcast immediately
@@ -80,6 +102,12 @@ void UComfyStreamComponent::OnTextureReceivedInternal(UTexture2D* Texture)
 	}
 }
 
+void UComfyStreamComponent::OnFullFrameReadyInternal(const FComfyFrame& Frame)
+{
+	OnFullFrameReadyNative.Broadcast(Frame);
+	OnFullFrameReady.Broadcast(Frame);
+}
+
 void UComfyStreamComponent::OnConnectionStatusChangedInternal(bool bConnected)
 {
 	ConnectionStatus = bConnected ? EComfyConnectionStatus::Connected : EComfyConnectionStatus::Disconnected;
@@ -0,0 +1,272 @@
+#include "ComfyStream/ComfyStreamHubSubsystem.h"
+#include "ComfyStream/ComfyImageFetcher.h"
+#include "Algo/BinarySearch.h"
+
+static bool debug = false;
+//Shared ComfyUI connections: one decode per server/channel, frame history for delayed consumers
+
+// ============================================================
+// UComfyHubStream
+// ============================================================
+
+void UComfyHubStream::Start(const FComfyStreamConfig& InConfig, const FComfyIngestSettings& InIngestSettings)
+{
+	Config = InConfig;
+
+	FComfyIngestSettings Ingest = InIngestSettings;
+	// History keeps seconds of frames alive, far more than a delta upload ring holds (they would all get full uploads)
+	Ingest.bDeltaUploads = false;
+
+	Fetcher = NewObject<UComfyImageFetcher>(this);
+	Fetcher->Config = Config;
+	Fetcher->IngestSettings = Ingest;
+	Fetcher->OnFullFrameReadyNative.AddUObject(this, &UComfyHubStream::HandleFrame);
+	Fetcher->OnConnectionStatusChanged.AddDynamic(this, &UComfyHubStream::HandleConnectionChanged);
+	Fetcher->StartPolling(Config.ServerURL, Config.ChannelNumber);
+}
+
+void UComfyHubStream::Stop()
+{
+	if (Fetcher)
+	{
+		Fetcher->StopPolling();
+	}
+	ReconnectTime = 0.0;
+	History.Empty();
+	FrameBytes.Empty();
+	HistoryBytes = 0;
+}
+
+void UComfyHubStream::HandleFrame(const FComfyFrame& Frame)
+{
+	if (!Frame.IsComplete())
+	{
+		return;
+	}
+
+	FComfyFrame Stored = Frame;
+	if (Stored.ArrivalTime <= 0.0)
+	{
+		Stored.ArrivalTime = FPlatformTime::Seconds();
+	}
+	History.Add(Stored);
+	FrameBytes.Add(GetFrameBytes(Stored));
+	HistoryBytes += FrameBytes.Last();
+
+	// Undelayed subscribers get the frame right away (callbacks may unsubscribe, so collect first)
+	TArray<FComfyHubFrameDelegate, TInlineAllocator<4>> Due;
+	for (FComfyHubSubscriber& Subscriber : Subscribers)
+	{
+		if (Subscriber.DelaySeconds <= 0.0f)
+		{
+			Subscriber.Cursor = Stored.ArrivalTime;
+			Due.Add(Subscriber.OnFrame);
+		}
+	}
+	for (const FComfyHubFrameDelegate& OnFrame : Due)
+	{
+		OnFrame.ExecuteIfBound(Stored);
+	}
+}
+
+void UComfyHubStream::HandleConnectionChanged(bool bConnected)
+{
+	if (!bConnected && Config.bAutoReconnect)
+	{
+		ReconnectTime = FPlatformTime::Seconds() + Config.ReconnectDelay;
+	}
+}
+
+void UComfyHubStream::Tick(double Now, int64 MemoryBudgetBytes, double MaxHistorySeconds)
+{
+	if (ReconnectTime > 0.0 && Now >= ReconnectTime)
+	{
+		ReconnectTime = 0.0;
+		if (Fetcher && !Fetcher->IsPolling())
+		{
+			Fetcher->StartPolling(Config.ServerURL, Config.ChannelNumber);
+		}
+	}
+
+	// Delayed subscribers: every frame whose arrival + delay has passed, in order
+	TArray<TPair<FComfyHubFrameDelegate, FComfyFrame>, TInlineAllocator<4>> Due;
+	float MaxDelay = 0.0f;
+	for (FComfyHubSubscriber& Subscriber : Subscribers)
+	{
+		if (Subscriber.DelaySeconds <= 0.0f)
+		{
+			continue;
+		}
+		MaxDelay = FMath::Max(MaxDelay, Subscriber.DelaySeconds);
+		for (int32 i = Algo::UpperBoundBy(History, Subscriber.Cursor, &FComfyFrame::ArrivalTime);
+		     i < History.Num() && History[i].ArrivalTime + Subscriber.DelaySeconds <= Now; i++)
+		{
+			Subscriber.Cursor = History[i].ArrivalTime;
+			Due.Emplace(Subscriber.OnFrame, History[i]);
+		}
+	}
+	for (const TPair<FComfyHubFrameDelegate, FComfyFrame>& Entry : Due)
+	{
+		Entry.Key.ExecuteIfBound(Entry.Value);
+	}
+
+	// Frames are kept at least as long as the longest subscriber delay; the memory budget wins over that
+	const double KeepSeconds = FMath::Max(MaxHistorySeconds, double(MaxDelay) + 1.0);
+	int32 NumDropped = 0;
+	while (NumDropped < History.Num() - 1 &&
+	       (HistoryBytes > MemoryBudgetBytes || Now - History[NumDropped].ArrivalTime > KeepSeconds))
+	{
+		HistoryBytes -= FrameBytes[NumDropped];
+		NumDropped++;
+	}
+	if (NumDropped > 0)
+	{
+		History.RemoveAt(0, NumDropped, EAllowShrinking::No);
+		FrameBytes.RemoveAt(0, NumDropped, EAllowShrinking::No);
+		if (debug) UE_LOG(LogTemp, Verbose, TEXT("[ComfyStreamHub] Dropped %d history frames (%d kept, %.1f MB)"),
+			NumDropped, History.Num(), HistoryBytes / (1024.0 * 1024.0));
+	}
+}
+
+bool UComfyHubStream::GetFrameAtTime(double Time, FComfyFrame& OutFrame) const
+{
+	const int32 Index = Algo::UpperBoundBy(History, Time, &FComfyFrame::ArrivalTime) - 1;
+	if (!History.IsValidIndex(Index))
+	{
+		return false;
+	}
+	OutFrame = History[Index];
+	return true;
+}
+
+int64 UComfyHubStream::GetFrameBytes(const FComfyFrame& Frame)
+{
+	auto ImageBytes = [](const FComfyImageRef& Image) -> int64
+	{
+		if (!Image.IsValid())
+		{
+			return 0;
+		}
+		int64 Bytes = Image->Pixels.Num();
+		for (const TArray<uint8>& Mip : Image->Mips)
+		{
+			Bytes += Mip.Num();
+		}
+		return Bytes;
+	};
+	// Packed masks share the RGB image
+	const int64 CpuBytes = ImageBytes(Frame.RGBPixels) + ImageBytes(Frame.DepthPixels) + ImageBytes(Frame.NormalPixels) +
+	                       (Frame.IsMaskPacked() ? 0 : ImageBytes(Frame.MaskPixels));
+	return CpuBytes * 2;
+}
+
+// ============================================================
+// UComfyStreamHubSubsystem
+// ============================================================
+
+void UComfyStreamHubSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UComfyStreamHubSubsystem::Tick));
+}
+
+void UComfyStreamHubSubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	for (TPair<FString, TObjectPtr<UComfyHubStream>>& Pair : Streams)
+	{
+		if (Pair.Value)
+		{
+			Pair.Value->Stop();
+		}
+	}
+	Streams.Empty();
+	Super::Deinitialize();
+}
+
+FString UComfyStreamHubSubsystem::MakeStreamKey(const FString& ServerURL, int32 ChannelNumber)
+{
+	return FString::Printf(TEXT("%s#%d"), *ServerURL, ChannelNumber);
+}
+
+int32 UComfyStreamHubSubsystem::Subscribe(const FComfyStreamConfig& Config, const FComfyIngestSettings& IngestSettings, float DelaySeconds, FComfyHubFrameDelegate OnFrame)
+{
+	const FString Key = MakeStreamKey(Config.ServerURL, Config.ChannelNumber);
+	TObjectPtr<UComfyHubStream>& Stream = Streams.FindOrAdd(Key);
+	if (!Stream)
+	{
+		Stream = NewObject<UComfyHubStream>(this);
+		Stream->Start(Config, IngestSettings);
+		if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamHub] Opened shared stream %s"), *Key);
+	}
+
+	// A delayed subscriber starts with what arrived within its delay
+	FComfyHubSubscriber Subscriber;
+	Subscriber.Id = NextSubscriptionId++;
+	Subscriber.DelaySeconds = FMath::Max(DelaySeconds, 0.0f);
+	Subscriber.Cursor = FPlatformTime::Seconds() - Subscriber.DelaySeconds;
+	Subscriber.OnFrame = MoveTemp(OnFrame);
+	Stream->Subscribers.Add(MoveTemp(Subscriber));
+
+	if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamHub] Subscriber %d on %s (delay %.2f s, %d subscribers)"),
+		NextSubscriptionId - 1, *Key, DelaySeconds, Stream->Subscribers.Num());
+	return NextSubscriptionId - 1;
+}
+
+void UComfyStreamHubSubsystem::Unsubscribe(int32 SubscriptionId)
+{
+	for (auto It = Streams.CreateIterator(); It; ++It)
+	{
+		UComfyHubStream* Stream = It.Value();
+		if (!Stream || Stream->Subscribers.RemoveAll([SubscriptionId](const FComfyHubSubscriber& S) { return S.Id == SubscriptionId; }) == 0)
+		{
+			continue;
+		}
+		if (Stream->Subscribers.Num() == 0)
+		{
+			Stream->Stop();
+			if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyStreamHub] Closed shared stream %s"), *It.Key());
+			It.RemoveCurrent();
+		}
+		return;
+	}
+}
+
+bool UComfyStreamHubSubsystem::GetFrameAtTime(const FString& ServerURL, int32 ChannelNumber, float SecondsAgo, FComfyFrame& OutFrame) const
+{
+	const TObjectPtr<UComfyHubStream>* Stream = Streams.Find(MakeStreamKey(ServerURL, ChannelNumber));
+	return Stream && *Stream && (*Stream)->GetFrameAtTime(FPlatformTime::Seconds() - SecondsAgo, OutFrame);
+}
+
+void UComfyStreamHubSubsystem::SetHistoryBudget(int32 MemoryBudgetMB, float MaxSeconds)
+{
+	MemoryBudgetBytes = int64(FMath::Max(MemoryBudgetMB, 0)) * 1024 * 1024;
+	MaxHistorySeconds = FMath::Max(MaxSeconds, 0.0f);
+}
+
+int64 UComfyStreamHubSubsystem::GetHistoryBytes() const
+{
+	int64 Bytes = 0;
+	for (const TPair<FString, TObjectPtr<UComfyHubStream>>& Pair : Streams)
+	{
+		Bytes += Pair.Value ? Pair.Value->GetHistoryBytes() : 0;
+	}
+	return Bytes;
+}
+
+bool UComfyStreamHubSubsystem::Tick(float DeltaTime)
+{
+	// Subscriber callbacks may unsubscribe and close streams
+	TArray<TObjectPtr<UComfyHubStream>> Active;
+	Streams.GenerateValueArray(Active);
+
+	const double Now = FPlatformTime::Seconds();
+	for (UComfyHubStream* Stream : Active)
+	{
+		if (Stream)
+		{
+			Stream->Tick(Now, MemoryBudgetBytes, MaxHistorySeconds);
+		}
+	}
+	return true;
+}
@@ -0,0 +1,204 @@
+#include "ComfyStream/ComfyVoxelFusion.h"
+#include "Async/ParallelFor.h"
+
+static bool debug = false;
+//Fuses streamed RGB-D frames into a sparse voxel hash
+
+bool FComfyVoxelFusion::Integrate(const FComfyPixelView& RGB, const FComfyPixelView& Depth, const FComfyPixelView& Mask,
+                                  const FComfyVoxelFusionSettings& Settings, TArray<FComfyVoxelUpdate>& OutUpdates)
+{
+	OutUpdates.Reset();
+	if (!FComfyDepthMesh::UnprojectGrid(Depth, Mask, Settings.Unproject, Grid))
+		return false;
+
+	++FrameCounter;
+	const int32 GX = Grid.GridX;
+	const int32 GY = Grid.GridY;
+	const int32 NumPoints = GX * GY;
+	PointKeys.SetNumUninitialized(NumPoints);
+	PointColors.SetNumUninitialized(NumPoints);
+	PointValid.SetNumUninitialized(NumPoints);
+
+	const float InvVoxel = 1.0f / FMath::Max(Settings.VoxelSize, KINDA_SMALL_NUMBER);
+	const float EdgeThreshold = Settings.Unproject.DepthEdgeThreshold;
+	const bool bColor = RGB.IsValid();
+	const float ColorScaleX = bColor ? float(RGB.GetWidth()) / Depth.GetWidth() : 0.0f;
+	const float ColorScaleY = bColor ? float(RGB.GetHeight()) / Depth.GetHeight() : 0.0f;
+
+	// Voxel keys and colours per grid point; points next to a depth edge are dropped (flying pixels)
+	ParallelFor(GY, [&](int32 Row)
+	{
+		for (int32 Col = 0; Col < GX; ++Col)
+		{
+			const int32 P = Row * GX + Col;
+			const float D = Grid.Depth[P];
+			const bool bEdge = (Col + 1 < GX && FMath::Abs(Grid.Depth[P + 1] - D) > EdgeThreshold) ||
+			                   (Row + 1 < GY && FMath::Abs(Grid.Depth[P + GX] - D) > EdgeThreshold) ||
+			                   (Col > 0 && FMath::Abs(Grid.Depth[P - 1] - D) > EdgeThreshold) ||
+			                   (Row > 0 && FMath::Abs(Grid.Depth[P - GX] - D) > EdgeThreshold);
+			PointValid[P] = Grid.Inside[P] && !bEdge;
+			if (!PointValid[P])
+			{
+				continue;
+			}
+
+			PointKeys[P] = FIntVector(FMath::FloorToInt32(Grid.PointX[P] * InvVoxel),
+			                          FMath::FloorToInt32(Grid.PointY[P] * InvVoxel),
+			                          FMath::FloorToInt32(Grid.PointZ[P] * InvVoxel));
+			const int32 X = Col * Grid.Step;
+			const int32 Y = Row * Grid.Step;
+			const FLinearColor C = bColor ? RGB.GetColor(int32((X + 0.5f) * ColorScaleX), int32((Y + 0.5f) * ColorScaleY)) : FLinearColor::White;
+			PointColors[P] = FVector3f(C.R, C.G, C.B) * 255.0f;
+		}
+	});
+
+	// Gather this frame's points per voxel (sequential: the map and the observation log are shared)
+	const int32 MaxVoxels = FMath::Max(1, Settings.MaxVoxels);
+	int32 NumMerged = 0;
+	FrameSlots.Reset();
+	for (int32 P = 0; P < NumPoints; ++P)
+	{
+		if (!PointValid[P])
+		{
+			continue;
+		}
+
+		const FIntVector Key = PointKeys[P];
+		const FVector3f Position(Grid.PointX[P], Grid.PointY[P], Grid.PointZ[P]);
+		int32 Slot;
+		if (const int32* Found = VoxelIndex.Find(Key))
+		{
+			Slot = *Found;
+		}
+		else
+		{
+			if (VoxelIndex.Num() >= MaxVoxels && !EvictOldest(0))
+			{
+				continue;
+			}
+			Slot = FreeSlots.Num() > 0 ? FreeSlots.Pop(EAllowShrinking::No) : Voxels.AddDefaulted();
+			FVoxel& New = Voxels[Slot];
+			New.Key = Key;
+			New.Position = Position;
+			New.Color = PointColors[P];
+			New.Weight = 0.0f;
+			VoxelIndex.Add(Key, Slot);
+		}
+
+		FVoxel& Voxel = Voxels[Slot];
+		if (Voxel.LastSeen != FrameCounter)
+		{
+			Voxel.LastSeen = FrameCounter;
+			Voxel.FramePosition = FVector3f::ZeroVector;
+			Voxel.FrameColor = FVector3f::ZeroVector;
+			Voxel.FramePoints = 0;
+			Touches.Add({ Slot, FrameCounter });
+			FrameSlots.Add(Slot);
+		}
+		Voxel.FramePosition += Position;
+		Voxel.FrameColor += PointColors[P];
+		Voxel.FramePoints++;
+		NumMerged++;
+	}
+
+	// One observation per voxel and frame: running averages of the frame means with a capped weight
+	const float MaxWeight = FMath::Max(Settings.MaxWeight, 1.0f);
+	for (int32 Slot : FrameSlots)
+	{
+		FVoxel& Voxel = Voxels[Slot];
+		if (Voxel.LastSeen != FrameCounter || Voxel.FramePoints == 0)
+		{
+			// Evicted for the budget later this frame, or already merged after the slot was reused
+			continue;
+		}
+		const float InvPoints = 1.0f / Voxel.FramePoints;
+		Voxel.FramePoints = 0;
+		Voxel.Weight = FMath::Min(Voxel.Weight + 1.0f, MaxWeight);
+		const float Blend = 1.0f / Voxel.Weight;
+		Voxel.Position += (Voxel.FramePosition * InvPoints - Voxel.Position) * Blend;
+		Voxel.Color += (Voxel.FrameColor * InvPoints - Voxel.Color) * Blend;
+		MarkDirty(Slot);
+	}
+
+	// Age eviction walks the log from the oldest entry, so it only visits what expires
+	int32 NumEvicted = 0;
+	if (Settings.MaxAgeFrames > 0)
+	{
+		while (EvictOldest(Settings.MaxAgeFrames))
+		{
+			NumEvicted++;
+		}
+	}
+	if (TouchHead > 1024 && TouchHead * 2 > Touches.Num())
+	{
+		Touches.RemoveAt(0, TouchHead, EAllowShrinking::No);
+		TouchHead = 0;
+	}
+
+	// Report changed slots; voxels that were never shown and still aren't need no instance update
+	for (int32 Slot : DirtySlots)
+	{
+		FVoxel& Voxel = Voxels[Slot];
+		Voxel.bDirty = false;
+		const bool bVisible = Voxel.LastSeen != INDEX_NONE && Voxel.Weight >= Settings.MinConfidence;
+		if (!bVisible && !Voxel.bShown)
+		{
+			continue;
+		}
+		Voxel.bShown = bVisible;
+
+		FComfyVoxelUpdate& Update = OutUpdates.AddDefaulted_GetRef();
+		Update.Slot = Slot;
+		Update.Position = Voxel.Position;
+		Update.Color = FColor(uint8(FMath::Clamp(Voxel.Color.X, 0.0f, 255.0f)), uint8(FMath::Clamp(Voxel.Color.Y, 0.0f, 255.0f)),
+		                      uint8(FMath::Clamp(Voxel.Color.Z, 0.0f, 255.0f)), 255);
+		Update.bVisible = bVisible;
+	}
+	DirtySlots.Reset();
+
+	if (debug) UE_LOG(LogTemp, Verbose, TEXT("[ComfyVoxelFusion] Frame %d: %d points merged, %d evicted, %d voxels, %d instance updates"),
+		FrameCounter, NumMerged, NumEvicted, VoxelIndex.Num(), OutUpdates.Num());
+	return NumMerged > 0;
+}
+
+bool FComfyVoxelFusion::EvictOldest(int32 MinAge)
+{
+	while (TouchHead < Touches.Num())
+	{
+		const FTouch Touch = Touches[TouchHead];
+		if (Voxels[Touch.Slot].LastSeen != Touch.Frame)
+		{
+			// Seen again later (or already evicted) - a newer entry covers it
+			TouchHead++;
+			continue;
+		}
+		if (FrameCounter - Touch.Frame < MinAge)
+		{
+			return false;
+		}
+		TouchHead++;
+		Evict(Touch.Slot);
+		return true;
+	}
+	return false;
+}
+
+void FComfyVoxelFusion::Evict(int32 Slot)
+{
+	FVoxel& Voxel = Voxels[Slot];
+	VoxelIndex.Remove(Voxel.Key);
+	Voxel.LastSeen = INDEX_NONE;
+	Voxel.Weight = 0.0f;
+	FreeSlots.Add(Slot);
+	MarkDirty(Slot);
+}
+
+void FComfyVoxelFusion::MarkDirty(int32 Slot)
+{
+	FVoxel& Voxel = Voxels[Slot];
+	if (!Voxel.bDirty)
+	{
+		Voxel.bDirty = true;
+		DirtySlots.Add(Slot);
+	}
+}
@@ -0,0 +1,212 @@
+#include "ComfyStream/ComfyVoxelFusionComponent.h"
+#include "ComfyStream/ComfyStreamComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInterface.h"
+#include "GameFramework/Actor.h"
+#include "Async/Async.h"
+
+static bool debug = false;
+//Fuses the stream's depth frames into a persistent instanced point cloud
+
+UComfyVoxelFusionComponent::UComfyVoxelFusionComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UComfyVoxelFusionComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Fusion = MakeShared<FComfyVoxelFusion, ESPMode::ThreadSafe>();
+	CreatePointCloud();
+
+	// Intrinsics always come from the stream component, even when frames are fed in by hand
+	StreamComponent = GetOwner() ? GetOwner()->FindComponentByClass<UComfyStreamComponent>() : nullptr;
+	if (StreamComponent && bAutoBindStream)
+	{
+		FrameHandle = StreamComponent->OnFullFrameReadyNative.AddUObject(this, &UComfyVoxelFusionComponent::HandleFrame);
+	}
+	if (debug) UE_LOG(LogTemp, Display, TEXT("[ComfyVoxelFusion] BeginPlay on %s (stream component %s)"),
+		*GetNameSafe(GetOwner()), StreamComponent ? TEXT("found") : TEXT("missing"));
+}
+
+void UComfyVoxelFusionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (StreamComponent && FrameHandle.IsValid())
+	{
+		StreamComponent->OnFullFrameReadyNative.Remove(FrameHandle);
+	}
+	FrameHandle.Reset();
+	Generation++;
+	PendingFrame = FComfyFrame();
+	Super::EndPlay(EndPlayReason);
+}
+
+void UComfyVoxelFusionComponent::CreatePointCloud()
+{
+	// Same instancing as USplatCreatorSubsystem::CreatePointCloud: spheres with RGBA in custom data 0-3
+	UStaticMesh* SphereMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Sphere.Sphere"));
+	if (!SphereMesh || !GetOwner())
+	{
+		return;
+	}
+
+	UMaterialInterface* Material = PointMaterial;
+	if (!Material) Material = LoadObject<UMaterialInterface>(nullptr, TEXT("/Game/_GENERATED/Materials/M_VertexColor.M_VertexColor"));
+	if (!Material) Material = LoadObject<UMaterialInterface>(nullptr, TEXT("/Engine/BasicShapes/BasicShapeMaterial.BasicShapeMaterial"));
+
+	PointCloud = NewObject<UInstancedStaticMeshComponent>(GetOwner());
+	PointCloud->SetStaticMesh(SphereMesh);
+	PointCloud->SetNumCustomDataFloats(4);
+	PointCloud->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	PointCloud->bDisableCollision = true;
+	PointCloud->SetCastShadow(false);
+	PointCloud->SetCanEverAffectNavigation(false);
+	PointCloud->SetReceivesDecals(false);
+	PointCloud->SetCullDistances(0, 0);
+	PointCloud->InstanceMinDrawDistance = 0;
+	PointCloud->bNeverDistanceCull = true;
+	PointCloud->bAllowCullDistanceVolume = false;
+	PointCloud->bUseAsOccluder = false;
+	if (Material) PointCloud->SetMaterial(0, Material);
+
+	// The cloud keeps growing and moving between bounds updates
+	PointCloud->SetBoundsScale(10.0f);
+	PointCloud->SetupAttachment(this);
+	PointCloud->RegisterComponent();
+}
+
+void UComfyVoxelFusionComponent::HandleFrame(const FComfyFrame& Frame)
+{
+	IntegrateFrame(Frame);
+}
+
+void UComfyVoxelFusionComponent::IntegrateFrame(const FComfyFrame& Frame)
+{
+	// Interpolated steps have no CPU depth - only real frames are fused
+	if (!Frame.DepthPixels.IsValid() || !Fusion.IsValid())
+	{
+		return;
+	}
+	if (bInFlight)
+	{
+		PendingFrame = Frame;
+		return;
+	}
+
+	FComfyVoxelFusionSettings Settings;
+	if (StreamComponent)
+	{
+		Settings.Unproject.FocalScale = StreamComponent->FocalScale;
+		Settings.Unproject.DepthScaleUnits = StreamComponent->DepthScaleUnits;
+		Settings.Unproject.MaskThreshold = (uint8)FMath::Clamp(StreamComponent->IngestSettings.CropMaskThreshold, 0, 254);
+	}
+	Settings.Unproject.NearDistance = NearDistance;
+	Settings.Unproject.GridStep = GridStep;
+	Settings.Unproject.DepthEdgeThreshold = EdgeThreshold;
+	Settings.Unproject.RoiOffset = Frame.RoiOffset;
+	Settings.Unproject.RoiScale = Frame.RoiScale;
+	Settings.VoxelSize = VoxelSize;
+	Settings.MinConfidence = MinConfidence;
+	Settings.MaxWeight = FMath::Max(MaxConfidence, MinConfidence);
+	Settings.MaxAgeFrames = MaxAgeFrames;
+	Settings.MaxVoxels = MaxVoxels;
+
+	bInFlight = true;
+	const uint32 JobGeneration = Generation;
+	TWeakObjectPtr<UComfyVoxelFusionComponent> WeakThis(this);
+	TSharedPtr<FComfyVoxelFusion, ESPMode::ThreadSafe> Target = Fusion;
+	FComfyPixelView RGB = Frame.GetRGBView();
+	FComfyPixelView Depth = Frame.GetDepthView();
+	FComfyPixelView Mask = Frame.GetMaskView();
+	Async(EAsyncExecution::ThreadPool, [WeakThis, JobGeneration, Target, RGB, Depth, Mask, Settings]()
+	{
+		TArray<FComfyVoxelUpdate> Updates;
+		Target->Integrate(RGB, Depth, Mask, Settings, Updates);
+		const int32 Voxels = Target->GetNumVoxels();
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, JobGeneration, Updates = MoveTemp(Updates), Voxels]()
+		{
+			UComfyVoxelFusionComponent* This = WeakThis.Get();
+			if (!This)
+			{
+				return;
+			}
+			This->bInFlight = false;
+			if (JobGeneration == This->Generation)
+			{
+				This->ApplyUpdates(Updates, Voxels);
+			}
+
+			// Newest frame that arrived during the integration
+			if (This->PendingFrame.DepthPixels.IsValid())
+			{
+				const FComfyFrame Next = MoveTemp(This->PendingFrame);
+				This->PendingFrame = FComfyFrame();
+				This->IntegrateFrame(Next);
+			}
+		});
+	});
+}
+
+void UComfyVoxelFusionComponent::ApplyUpdates(const TArray<FComfyVoxelUpdate>& Updates, int32 InNumVoxels)
+{
+	NumVoxels = InNumVoxels;
+	if (!PointCloud || Updates.Num() == 0)
+	{
+		return;
+	}
+
+	// Instance index = voxel slot. New slots are appended as hidden instances in one batch; evicted slots stay
+	// allocated (scaled to zero) and are reused, so the instance count is bounded by MaxVoxels.
+	int32 MaxSlot = INDEX_NONE;
+	for (const FComfyVoxelUpdate& Update : Updates)
+	{
+		MaxSlot = FMath::Max(MaxSlot, Update.Slot);
+	}
+	const int32 NumInstances = PointCloud->GetInstanceCount();
+	const bool bGrown = MaxSlot >= NumInstances;
+	if (bGrown)
+	{
+		TArray<FTransform> Hidden;
+		Hidden.Init(FTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector), MaxSlot + 1 - NumInstances);
+		PointCloud->AddInstances(Hidden, false, false);
+	}
+
+	const FVector Visible(PointScale);
+	for (const FComfyVoxelUpdate& Update : Updates)
+	{
+		const FTransform Transform(FQuat::Identity, FVector(Update.Position), Update.bVisible ? Visible : FVector::ZeroVector);
+		PointCloud->UpdateInstanceTransform(Update.Slot, Transform, false, false);
+		if (Update.bVisible)
+		{
+			PointCloud->SetCustomDataValue(Update.Slot, 0, Update.Color.R / 255.0f, false);
+			PointCloud->SetCustomDataValue(Update.Slot, 1, Update.Color.G / 255.0f, false);
+			PointCloud->SetCustomDataValue(Update.Slot, 2, Update.Color.B / 255.0f, false);
+			PointCloud->SetCustomDataValue(Update.Slot, 3, 1.0f, false);
+		}
+	}
+
+	// Bounds walk every instance, so they only follow growth; BoundsScale covers drift in between
+	if (bGrown)
+	{
+		PointCloud->UpdateBounds();
+	}
+	PointCloud->MarkRenderStateDirty();
+
+	if (debug) UE_LOG(LogTemp, Verbose, TEXT("[ComfyVoxelFusion] %d instance updates, %d voxels, %d instances"),
+		Updates.Num(), NumVoxels, PointCloud->GetInstanceCount());
+}
+
+void UComfyVoxelFusionComponent::ResetCloud()
+{
+	// A running integration finishes on the old state and its result is dropped by the generation check
+	Generation++;
+	Fusion = MakeShared<FComfyVoxelFusion, ESPMode::ThreadSafe>();
+	PendingFrame = FComfyFrame();
+	NumVoxels = 0;
+	if (PointCloud)
+	{
+		PointCloud->ClearInstances();
+	}
+}
@@ -768,6 +768,23 @@ void UHyper3DObjectsSubsystem::UpdateObjectLayout()
 		return;
 	}
 
+	// Splat exclusion queries (looked up once, not per attempt)
+	USplatCreatorSubsystem* SplatSubsystem = nullptr;
+	if (UWorld* World = GetWorld())
+	{
+		if (UGameInstance* GameInstance = World->GetGameInstance())
+		{
+			SplatSubsystem = GameInstance->GetSubsystem<USplatCreatorSubsystem>();
+		}
+	}
+
+	// Splat points are not there to avoid until the first splat is shown; OnSplatBoundsUpdatedHandler lays the objects out then
+	if (SplatSubsystem && SplatSubsystem->IsFirstSplatPending())
+	{
+		if(debug) UE_LOG(LogTemp, Display, TEXT("[Hyper3DObjects] First splat still loading, deferring object layout"));
+		return;
+	}
+
 	// Use current time as seed so layout changes when parameters change
 	FRandomStream Stream(FDateTime::Now().GetTicks());
 	
@@ -836,24 +853,14 @@ void UHyper3DObjectsSubsystem::UpdateObjectLayout()
 				}
 				
 				// Check if this position is too close to any splat points
-				if (!bTooClose)
+				if (!bTooClose && SplatSubsystem)
 				{
-					UWorld* World = GetWorld();
-					if (World)
+					// Check horizontal (X,Y) distance only - splat points may be at different Z heights
+					// Use the actual object position (with random height); O(1) lookup in the splat's distance raster
+					FVector TestPosition3D = ReferenceLocation + FVector(NewPosition.X, NewPosition.Y, RandomHeight);
+					if (!SplatSubsystem->IsSplatPlacementFree(TestPosition3D, ScaledSplatExclusion))
 					{
-						if (UGameInstance* GameInstance = World->GetGameInstance())
-						{
-							if (USplatCreatorSubsystem* SplatSubsystem = GameInstance->GetSubsystem<USplatCreatorSubsystem>())
-							{
-								// Check horizontal (X,Y) distance only - splat points may be at different Z heights
-								// Use the actual object position (with random height)
-								FVector TestPosition3D = ReferenceLocation + FVector(NewPosition.X, NewPosition.Y, RandomHeight);
-								if (SplatSubsystem->IsPositionTooCloseToSplatPoints(TestPosition3D, ScaledSplatExclusion, true))
-								{
-									bTooClose = true;
-								}
-							}
-						}
+						bTooClose = true;
 					}
 				}
 				
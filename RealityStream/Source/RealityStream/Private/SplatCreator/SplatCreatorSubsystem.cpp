@@ -1,4 +1,8 @@
 #include "SplatCreator/SplatCreatorSubsystem.h"
+#include "SplatCreator/SplatPlyReader.h"
+#include "SplatCreator/SplatPointCache.h"
+#include "SplatCreator/SplatPointGrid.h"
+#include "SplatCreator/SplatPlacementField.h"
 #include "ComfyStream/ComfyImageSender.h"
 #include "ComfyStream/ComfyPngDecoder.h"
 #include "Components/PrimitiveComponent.h"
@@ -25,8 +29,19 @@
 #include "Math/RotationMatrix.h"
 #include "Math/RandomStream.h"
 #include "Math/Box.h"
+#include "Async/ParallelFor.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
 int debug = 0; // 0 = off, 1 = on
 
+// Splat preprocessing: point budget after sampling, PLY-to-world scale and neighbours for sphere sizing (part of the splat cache key)
+static constexpr int32 SplatMaxPoints = 100000;
+static constexpr float SplatPositionScale = 125.0f;
+static constexpr int32 SplatSizeNeighbours = 4;
+
+// Radius of /Engine/BasicShapes/Sphere at scale 1 (instance scale is the sphere size)
+static constexpr float SplatSphereMeshRadius = 50.0f;
+
 // ============================================================
 // Initialize
 // ============================================================
@@ -130,6 +145,12 @@ void USplatCreatorSubsystem::Deinitialize()
 	{
 		World->GetTimerManager().ClearTimer(ImagePreviewOpacityFadeTimer);
 	}
+	if (PrepareCancel.IsValid())
+	{
+		*PrepareCancel = true;
+	}
+	PreparedSplats.Empty();
+	CurrentSplat.Reset();
 	Super::Deinitialize();
 }
 
@@ -681,8 +702,27 @@ void USplatCreatorSubsystem::CycleToNextPLY()
 
 void USplatCreatorSubsystem::LoadPLYFile(const FString& PLYPath)
 {
-	CurrentLoadedPlyPath = FPaths::ConvertRelativePathToFull(PLYPath);
-	FPaths::NormalizeFilename(CurrentLoadedPlyPath);
+	FString FullPath = FPaths::ConvertRelativePathToFull(PLYPath);
+	FPaths::NormalizeFilename(FullPath);
+
+	// Prepared ahead of time (prefetch or revisit): only the instance build is left for the game thread
+	if (FSplatPreparedCloudPtr Cloud = FindPreparedSplat(FullPath))
+	{
+		PendingShowPath.Reset();
+		ShowPreparedSplat(FullPath, Cloud);
+		return;
+	}
+
+	// Shown when the background preparation finishes; the current splat stays up meanwhile.
+	// A newer load replaces this one and cancels its preparation.
+	PendingShowPath = FullPath;
+	PrepareSplatAsync(FullPath);
+}
+
+void USplatCreatorSubsystem::ShowPreparedSplat(const FString& PLYPath, FSplatPreparedCloudPtr Cloud)
+{
+	CurrentLoadedPlyPath = PLYPath;
+	CurrentSplat = Cloud;
 
 	// Clear any pending morph delay (new cycle supersedes it)
 	if (UWorld* World = GetWorld())
@@ -692,15 +732,6 @@ void USplatCreatorSubsystem::LoadPLYFile(const FString& PLYPath)
 
 	// Reset all transformations to normal when loading a new PLY file
 	ResetToNormal();
-	
-	TArray<FVector> Positions;
-	TArray<FColor> Colors;
-	
-	if (!ParsePLYFile(PLYPath, Positions, Colors))
-	{
-		if(debug) UE_LOG(LogTemp, Error, TEXT("[SplatCreator] Failed to parse PLY file: %s"), *PLYPath);
-            return;
-        }
 
 	// Display current splat's image on preview plane (the one we're loading now)
 	UpdateImagePreview(PLYPath);
@@ -721,205 +752,210 @@ void USplatCreatorSubsystem::LoadPLYFile(const FString& PLYPath)
 		TrySendImageToComfyUI(ImageToSendPath);
 	}
 
+	if(debug) UE_LOG(LogTemp, Display, TEXT("[SplatCreator] Showing %d points from %s"), Cloud->Positions.Num(), *PLYPath);
+
+	// Create new point cloud with plane morph (GPU-based flat->3D transition)
+	CreatePointCloud(*Cloud);
+
+	// The next splat is already chosen: prepare it while this one is on screen
+	if (PlyFiles.IsValidIndex(NextFileIndex))
+	{
+		FString NextPath = FPaths::ConvertRelativePathToFull(GetSplatCreatorFolder() / PlyFiles[NextFileIndex]);
+		FPaths::NormalizeFilename(NextPath);
+		if (NextPath != PLYPath && !FindPreparedSplat(NextPath))
+		{
+			PrepareSplatAsync(NextPath);
+		}
+	}
+}
+
+// ============================================================
+// BACKGROUND PREPARATION
+// ============================================================
+
+FSplatPreparedCloudPtr USplatCreatorSubsystem::PrepareSplat(const FString& PLYPath, const FThreadSafeBool& bCancel)
+{
+	TSharedPtr<FSplatPreparedCloud, ESPMode::ThreadSafe> Cloud = MakeShared<FSplatPreparedCloud, ESPMode::ThreadSafe>();
+	const FFileStatData Stat = IFileManager::Get().GetStatData(*PLYPath);
+	const uint32 ParamsHash = HashCombine(HashCombine(GetTypeHash(SplatMaxPoints), GetTypeHash(SplatPositionScale)), GetTypeHash(SplatSizeNeighbours));
+
+	// Preprocessed cache next to the PLY: mapping it replaces parse, sampling and sizing
+	if (Stat.bIsValid && FSplatPointCache::Load(PLYPath, Stat.FileSize, Stat.ModificationTime, ParamsHash, *Cloud))
+	{
+		if(debug) UE_LOG(LogTemp, Display, TEXT("[SplatCreator] Loaded %d points from cache for %s"), Cloud->Positions.Num(), *PLYPath);
+		Cloud->PlacementField.Build(Cloud->Positions, SplatPositionScale);
+		Cloud->SphereBVH.Build(Cloud->Positions, Cloud->SphereSizes, SplatPositionScale, SplatSphereMeshRadius);
+		return Cloud;
+	}
+	Cloud->SourceTimeStamp = Stat.ModificationTime;
+	Cloud->SourceSize = Stat.FileSize;
+
+	TArray<FVector> Positions;
+	TArray<FColor> Colors;
+	if (!ParsePLYFile(PLYPath, Positions, Colors))
+	{
+		if(debug) UE_LOG(LogTemp, Error, TEXT("[SplatCreator] Failed to parse PLY file: %s"), *PLYPath);
+		return nullptr;
+	}
 	if(debug) UE_LOG(LogTemp, Display, TEXT("[SplatCreator] Parsed %d points from %s"), Positions.Num(), *PLYPath);
-	
+	if (bCancel) return nullptr;
+
 	// Uniformly sample points to limit count for performance
-	TArray<FVector> FilteredPositions;
-	TArray<FColor> FilteredColors;
-	SamplePointsUniformly(Positions, Colors, FilteredPositions, FilteredColors);
-	
-	if (FilteredPositions.Num() > 0)
-	{
-		Positions = FilteredPositions;
-		Colors = FilteredColors;
-		if(debug) UE_LOG(LogTemp, Display, TEXT("[SplatCreator] After filtering: %d points"), Positions.Num());
-        }
-        else
-        {
+	SamplePointsUniformly(Positions, Colors, Cloud->Positions, Cloud->Colors);
+	if (Cloud->Positions.Num() == 0)
+	{
 		if(debug) UE_LOG(LogTemp, Warning, TEXT("[SplatCreator] Filtering removed all points, using original"));
+		Cloud->Positions = MoveTemp(Positions);
+		Cloud->Colors = MoveTemp(Colors);
 	}
+	if (bCancel) return nullptr;
 
-	// Create new point cloud with plane morph (GPU-based flat->3D transition)
-	CreatePointCloud(Positions, Colors);
+	TArray<FVector> ScaledPositions;
+	ScaledPositions.Reserve(Cloud->Positions.Num());
+	for (const FVector& Pos : Cloud->Positions) ScaledPositions.Add(Pos * SplatPositionScale);
+	CalculateAdaptiveSphereSizes(ScaledPositions, Cloud->SphereSizes);
+	Cloud->Bounds = FBox(ScaledPositions);
+	Cloud->PlacementField.Build(ScaledPositions);
+	Cloud->SphereBVH.Build(ScaledPositions, Cloud->SphereSizes, 1.0f, SplatSphereMeshRadius);
+
+	// Regenerated here (thread pool) whenever the cache was missing or stale
+	if (!bCancel && Stat.bIsValid)
+	{
+		FSplatPointCache::Save(PLYPath, ParamsHash, *Cloud);
+	}
+	return Cloud;
 }
 
-bool USplatCreatorSubsystem::ParsePLYFile(const FString& PLYPath, TArray<FVector>& OutPositions, TArray<FColor>& OutColors)
+void USplatCreatorSubsystem::PrepareSplatAsync(const FString& PLYPath)
 {
-	TArray<uint8> FileData;
-	if (!FFileHelper::LoadFileToArray(FileData, *PLYPath))
+	if (PreparingPath == PLYPath)
 	{
-		return false;
+		return;
 	}
-	
-	FString FileContent;
-	FFileHelper::BufferToString(FileContent, FileData.GetData(), FileData.Num());
-	
-	TArray<FString> Lines;
-	FileContent.ParseIntoArrayLines(Lines);
-	
-	OutPositions.Empty();
-	OutColors.Empty();
-	
-	bool bIsBinary = false;
-	int32 VertexCount = 0;
-	int32 HeaderEndOffset = 0;
-	TArray<FString> PropertyNames;
-	
-	// Parse header
-	for (int32 i = 0; i < Lines.Num(); i++)
+
+	// One preparation at a time: a newer request supersedes the running one
+	if (PrepareCancel.IsValid())
 	{
-		FString Line = Lines[i].TrimStartAndEnd();
-		
-		if (Line.StartsWith(TEXT("format")))
-		{
-			bIsBinary = Line.Contains(TEXT("binary"));
-		}
-		else if (Line.StartsWith(TEXT("element vertex")))
-		{
-			TArray<FString> Parts;
-			Line.ParseIntoArray(Parts, TEXT(" "));
-			if (Parts.Num() >= 3)
-			{
-				VertexCount = FCString::Atoi(*Parts[2]);
-			}
-		}
-		else if (Line.StartsWith(TEXT("property")))
+		*PrepareCancel = true;
+	}
+	PrepareCancel = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>(false);
+	PreparingPath = PLYPath;
+	const uint32 JobId = ++PrepareJobId;
+
+	TWeakObjectPtr<USplatCreatorSubsystem> WeakThis(this);
+	TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> Cancel = PrepareCancel;
+	Async(EAsyncExecution::ThreadPool, [WeakThis, PLYPath, JobId, Cancel]()
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		FSplatPreparedCloudPtr Cloud = PrepareSplat(PLYPath, *Cancel);
+		if (*Cancel)
 		{
-			TArray<FString> Parts;
-			Line.ParseIntoArray(Parts, TEXT(" "));
-			if (Parts.Num() >= 3)
-			{
-				PropertyNames.Add(Parts[2]);
-			}
+			Cloud.Reset();
 		}
-		else if (Line == TEXT("end_header"))
+		if(debug) UE_LOG(LogTemp, Display, TEXT("[SplatCreator] Prepared %s in %.1f ms%s"), *FPaths::GetCleanFilename(PLYPath),
+			(FPlatformTime::Seconds() - StartTime) * 1000.0, *Cancel ? TEXT(" (cancelled)") : TEXT(""));
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, PLYPath, JobId, Cloud]()
 		{
-			int32 HeaderEndStrPos = FileContent.Find(TEXT("end_header"));
-			if (HeaderEndStrPos != INDEX_NONE)
+			if (USplatCreatorSubsystem* This = WeakThis.Get())
 			{
-				int32 NewlinePos = FileContent.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromStart, HeaderEndStrPos);
-				HeaderEndOffset = NewlinePos != INDEX_NONE ? NewlinePos + 1 : HeaderEndStrPos + 10;
+				This->OnSplatPrepared(PLYPath, Cloud, JobId);
 			}
-			break;
-		}
+		});
+	});
+}
+
+void USplatCreatorSubsystem::OnSplatPrepared(const FString& PLYPath, FSplatPreparedCloudPtr Cloud, uint32 JobId)
+{
+	if (JobId == PrepareJobId)
+	{
+		PreparingPath.Reset();
+		PrepareCancel.Reset();
 	}
-	
-	if (bIsBinary)
+	if (!Cloud)
 	{
-		// Binary PLY parsing
-		const uint8* DataPtr = FileData.GetData() + HeaderEndOffset;
-		int32 DataOffset = 0;
-		
-		int32 XIdx = PropertyNames.IndexOfByKey(TEXT("x"));
-		int32 YIdx = PropertyNames.IndexOfByKey(TEXT("y"));
-		int32 ZIdx = PropertyNames.IndexOfByKey(TEXT("z"));
-		int32 RedIdx = PropertyNames.IndexOfByKey(TEXT("red"));
-		int32 GreenIdx = PropertyNames.IndexOfByKey(TEXT("green"));
-		int32 BlueIdx = PropertyNames.IndexOfByKey(TEXT("blue"));
-		// Gaussian splat spherical harmonics
-		int32 Fdc0Idx = PropertyNames.IndexOfByKey(TEXT("f_dc_0"));
-		int32 Fdc1Idx = PropertyNames.IndexOfByKey(TEXT("f_dc_1"));
-		int32 Fdc2Idx = PropertyNames.IndexOfByKey(TEXT("f_dc_2"));
-		
-		// Calculate vertex size (simplified - assume all floats)
-		int32 VertexSize = PropertyNames.Num() * 4;
-		
-		for (int32 i = 0; i < VertexCount && DataOffset + VertexSize <= FileData.Num() - HeaderEndOffset; i++)
+		// Failed (or superseded): a load waiting for this file gives up, as a failed synchronous parse did
+		if (PendingShowPath == PLYPath && JobId == PrepareJobId)
 		{
-			float X = 0, Y = 0, Z = 0;
-			uint8 R = 255, G = 255, B = 255;
-			
-			if (XIdx >= 0) X = *reinterpret_cast<const float*>(DataPtr + DataOffset + XIdx * 4);
-			if (YIdx >= 0) Y = *reinterpret_cast<const float*>(DataPtr + DataOffset + YIdx * 4);
-			if (ZIdx >= 0) Z = *reinterpret_cast<const float*>(DataPtr + DataOffset + ZIdx * 4);
-			
-			// Check for Gaussian splat spherical harmonics first, then fall back to RGB
-			if (Fdc0Idx >= 0 && Fdc1Idx >= 0 && Fdc2Idx >= 0)
-			{
-				// Convert spherical harmonics to RGB
-				float SH0 = *reinterpret_cast<const float*>(DataPtr + DataOffset + Fdc0Idx * 4);
-				float SH1 = *reinterpret_cast<const float*>(DataPtr + DataOffset + Fdc1Idx * 4);
-				float SH2 = *reinterpret_cast<const float*>(DataPtr + DataOffset + Fdc2Idx * 4);
-				
-				// Spherical harmonics to RGB conversion (simplified - using DC component)
-				// SH coefficients are typically in range, convert to [0, 1] then to [0, 255]
-				// Apply sigmoid activation: 0.5 + 0.28209479177387814 * SH (standard SH normalization)
-				float Rf = FMath::Clamp(0.5f + 0.28209479177387814f * SH0, 0.0f, 1.0f);
-				float Gf = FMath::Clamp(0.5f + 0.28209479177387814f * SH1, 0.0f, 1.0f);
-				float Bf = FMath::Clamp(0.5f + 0.28209479177387814f * SH2, 0.0f, 1.0f);
-				
-				R = FMath::RoundToInt(Rf * 255.0f);
-				G = FMath::RoundToInt(Gf * 255.0f);
-				B = FMath::RoundToInt(Bf * 255.0f);
-			}
-			else if (RedIdx >= 0 && GreenIdx >= 0 && BlueIdx >= 0)
-			{
-				// Standard RGB values - read as float (common in PLY)
-				float Rf = *reinterpret_cast<const float*>(DataPtr + DataOffset + RedIdx * 4);
-				float Gf = *reinterpret_cast<const float*>(DataPtr + DataOffset + GreenIdx * 4);
-				float Bf = *reinterpret_cast<const float*>(DataPtr + DataOffset + BlueIdx * 4);
-				
-				// If values are > 1, they're likely already in 0-255 range, otherwise 0-1 range
-				if (Rf > 1.0f || Gf > 1.0f || Bf > 1.0f)
-				{
-					R = FMath::Clamp(FMath::RoundToInt(Rf), 0, 255);
-					G = FMath::Clamp(FMath::RoundToInt(Gf), 0, 255);
-					B = FMath::Clamp(FMath::RoundToInt(Bf), 0, 255);
-				}
-				else
-				{
-					R = FMath::Clamp(FMath::RoundToInt(Rf * 255.0f), 0, 255);
-					G = FMath::Clamp(FMath::RoundToInt(Gf * 255.0f), 0, 255);
-					B = FMath::Clamp(FMath::RoundToInt(Bf * 255.0f), 0, 255);
-				}
-			}
-			
-			// Convert coordinates: PLY (X, Y, Z) -> Unreal (X, Z, -Y)
-			OutPositions.Add(FVector(X, Z, -Y));
-			OutColors.Add(FColor(R, G, B, 255));
-			
-			DataOffset += VertexSize;
+			PendingShowPath.Reset();
 		}
+		return;
 	}
-	else
+
+	AddPreparedSplat(PLYPath, Cloud);
+	if (PendingShowPath == PLYPath)
 	{
-		// ASCII PLY parsing
-		int32 LineIndex = 0;
-		for (int32 i = 0; i < Lines.Num(); i++)
-		{
-			if (Lines[i].TrimStartAndEnd() == TEXT("end_header"))
-			{
-				LineIndex = i + 1;
-				break;
-			}
-		}
-		
-		for (int32 i = 0; i < VertexCount && LineIndex < Lines.Num(); i++, LineIndex++)
+		PendingShowPath.Reset();
+		ShowPreparedSplat(PLYPath, Cloud);
+	}
+}
+
+FSplatPreparedCloudPtr USplatCreatorSubsystem::FindPreparedSplat(const FString& PLYPath)
+{
+	const int32 Index = PreparedSplats.IndexOfByPredicate([&PLYPath](const TPair<FString, FSplatPreparedCloudPtr>& Entry) { return Entry.Key == PLYPath; });
+	if (Index == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	// Rewritten files are prepared again
+	TPair<FString, FSplatPreparedCloudPtr> Entry = PreparedSplats[Index];
+	PreparedSplats.RemoveAt(Index, EAllowShrinking::No);
+	const FFileStatData Stat = IFileManager::Get().GetStatData(*PLYPath);
+	if (!Stat.bIsValid || Stat.ModificationTime != Entry.Value->SourceTimeStamp || Stat.FileSize != Entry.Value->SourceSize)
+	{
+		return nullptr;
+	}
+
+	// Most recently used last
+	PreparedSplats.Add(Entry);
+	return Entry.Value;
+}
+
+void USplatCreatorSubsystem::AddPreparedSplat(const FString& PLYPath, FSplatPreparedCloudPtr Cloud)
+{
+	PreparedSplats.RemoveAll([&PLYPath](const TPair<FString, FSplatPreparedCloudPtr>& Entry) { return Entry.Key == PLYPath; });
+	PreparedSplats.Emplace(PLYPath, Cloud);
+
+	// The newest entry always stays, even above the cap
+	const int64 Budget = int64(FMath::Max(PreparedSplatCacheMB, 0)) * 1024 * 1024;
+	int64 Bytes = 0;
+	for (const TPair<FString, FSplatPreparedCloudPtr>& Entry : PreparedSplats)
+	{
+		Bytes += Entry.Value->GetAllocatedSize();
+	}
+	while (PreparedSplats.Num() > 1 && Bytes > Budget)
+	{
+		Bytes -= PreparedSplats[0].Value->GetAllocatedSize();
+		if(debug) UE_LOG(LogTemp, Display, TEXT("[SplatCreator] Dropped prepared splat %s"), *FPaths::GetCleanFilename(PreparedSplats[0].Key));
+		PreparedSplats.RemoveAt(0, EAllowShrinking::No);
+	}
+}
+
+bool USplatCreatorSubsystem::ParsePLYFile(const FString& PLYPath, TArray<FVector>& OutPositions, TArray<FColor>& OutColors)
+{
+	OutPositions.Empty();
+	OutColors.Empty();
+
+	// Header parsed from bytes, vertex block memory-mapped and decoded in parallel (typed properties, any stride)
+	FSplatPlyPoints Points;
+	if (!FSplatPlyReader::Read(PLYPath, Points))
+	{
+		return false;
+	}
+
+	// Convert coordinates: PLY (X, Y, Z) -> Unreal (X, Z, -Y)
+	const int32 NumPoints = Points.Num();
+	constexpr int32 ChunkSize = 65536;
+	OutPositions.SetNumUninitialized(NumPoints);
+	ParallelFor(FMath::DivideAndRoundUp(NumPoints, ChunkSize), [&](int32 Chunk)
+	{
+		const int32 End = FMath::Min((Chunk + 1) * ChunkSize, NumPoints);
+		for (int32 i = Chunk * ChunkSize; i < End; i++)
 		{
-			FString Line = Lines[LineIndex].TrimStartAndEnd();
-			TArray<FString> Parts;
-			Line.ParseIntoArray(Parts, TEXT(" "));
-			
-			if (Parts.Num() >= 3)
-			{
-				float X = FCString::Atof(*Parts[0]);
-				float Y = FCString::Atof(*Parts[1]);
-				float Z = FCString::Atof(*Parts[2]);
-				
-				uint8 R = 255, G = 255, B = 255;
-				if (Parts.Num() >= 6)
-				{
-					R = FCString::Atoi(*Parts[3]);
-					G = FCString::Atoi(*Parts[4]);
-					B = FCString::Atoi(*Parts[5]);
-				}
-				
-				// Convert coordinates: PLY (X, Y, Z) -> Unreal (X, Z, -Y)
-				OutPositions.Add(FVector(X, Z, -Y));
-				OutColors.Add(FColor(R, G, B, 255));
-			}
+			OutPositions[i] = FVector(Points.X[i], Points.Z[i], -Points.Y[i]);
 		}
-	}
+	});
+	OutColors = MoveTemp(Points.Colors);
 	
 	return OutPositions.Num() > 0;
 }
@@ -939,7 +975,7 @@ void USplatCreatorSubsystem::SamplePointsUniformly(const TArray<FVector>& InPosi
 	// Uniformly sample points to limit total count for performance
 	// Use uniform sampling to reduce from large point counts to manageable number while maintaining mesh-like appearance
 	// Reduced significantly to avoid HISM internal culling issues
-	const int32 MaxPoints = 100000;
+	const int32 MaxPoints = SplatMaxPoints;
 	
 	if (InPositions.Num() <= MaxPoints)
 	{
@@ -987,53 +1023,42 @@ void USplatCreatorSubsystem::SamplePointsUniformly(const TArray<FVector>& InPosi
 void USplatCreatorSubsystem::CalculateAdaptiveSphereSizes(const TArray<FVector>& Positions, TArray<float>& OutSphereSizes)
 {
 	const int32 NumPoints = Positions.Num();
-	OutSphereSizes.Empty(NumPoints);
-	OutSphereSizes.Reserve(NumPoints);
 	
 		// Min and max cube sizes (in scale units)
 		// Increased sizes slightly to create visible radius while still minimizing z-fighting
 		const float MinCubeSize = 0.03f;   // Increased to create visible radius
 		const float MaxCubeSize = 0.10f;   // Increased to create visible radius (3.3x ratio maintained)
-		const float BaseCubeSize = 0.05f;  // Default size for dense clusters
 	
-	// Search radius for finding nearest neighbors (in scaled world units)
-	// Increased to account for scaled positions (125x scaling)
-	const float SearchRadius = 10.0f;
+	if (debug) UE_LOG(LogTemp, Display, TEXT("[SplatCreator] Calculating adaptive sphere sizes for %d points (%d neighbours)..."), NumPoints, SplatSizeNeighbours);
 	
-	if (debug) UE_LOG(LogTemp, Display, TEXT("[SplatCreator] Calculating adaptive sphere sizes for %d points (SearchRadius=%.1f)..."), NumPoints, SearchRadius);
+	// Local density: exact mean distance to the K nearest neighbours (spatial grid, parallel queries)
+	TArray<float> MeanDistances;
+	FSplatPointGrid::ComputeMeanNeighbourDistances(Positions, SplatSizeNeighbours, MeanDistances);
 	
-	// For each point, find nearest neighbor and calculate adaptive size
-	for (int32 i = 0; i < NumPoints; i++)
+	// The thresholds below were tuned on the nearest neighbour distance. On a locally flat scan the j-th
+	// neighbour lies (j - 0.5) / (j - 1) times further out than the (j - 1)-th, so scale them by the mean
+	// of those ratios (about 1.64 for 4 neighbours) to keep sphere sizes where they were
+	float NeighbourScale = 0.0f;
+	float Ratio = 1.0f;
+	for (int32 j = 1; j <= SplatSizeNeighbours; j++)
 	{
-		const FVector& CurrentPos = Positions[i];
-		float NearestDistance = MAX_flt;
-		
-		// Find nearest neighbor within search radius
-		// Use spatial search: check nearby points (within reasonable range)
-		const int32 SearchRange = FMath::Min(1000, NumPoints); // Check up to 1000 nearby points for performance
-		const int32 StartIdx = FMath::Max(0, i - SearchRange / 2);
-		const int32 EndIdx = FMath::Min(NumPoints, i + SearchRange / 2);
-		
-		for (int32 j = StartIdx; j < EndIdx; j++)
-		{
-			if (i == j) continue;
-			
-			const float Distance = FVector::Dist(CurrentPos, Positions[j]);
-			if (Distance < NearestDistance)
-			{
-				NearestDistance = Distance;
-			}
-		}
+		NeighbourScale += Ratio;
+		Ratio *= (j + 0.5f) / j;
+	}
+	NeighbourScale /= SplatSizeNeighbours;
+	
+	OutSphereSizes.SetNumUninitialized(NumPoints);
+	ParallelFor(NumPoints, [&](int32 i)
+	{
+		const float NeighbourDistance = MeanDistances[i];
 		
-		// Calculate adaptive size based on nearest neighbor distance
-		// High density (close neighbors) = smaller spheres (0.1)
-		// Sparse areas (far neighbors) = larger spheres (0.3)
-		// Small NearestDistance (high density) -> small sphere (0.1)
-		// Large NearestDistance (sparse) -> large sphere (0.3)
+		// Calculate adaptive size based on neighbour distance
+		// Small NeighbourDistance (high density) -> small sphere
+		// Large NeighbourDistance (sparse) -> large sphere
 		float SphereSize;
 		
-		// If no neighbor found or very far, use large sphere for sparse areas
-		if (NearestDistance == MAX_flt)
+		// If no neighbour found, use large sphere for isolated points
+		if (NeighbourDistance == MAX_flt)
 		{
 			SphereSize = MaxCubeSize; // Large sphere for isolated points
 		}
@@ -1041,21 +1066,21 @@ void USplatCreatorSubsystem::CalculateAdaptiveSphereSizes(const TArray<FVector>&
 		{
 			// Map distance: small distance (high density) -> small sphere, large distance (sparse) -> large sphere
 			// Adjusted thresholds for smoother blending
-			const float DenseThreshold = 40.0f;  // Below this = dense
-			const float SparseThreshold = 120.0f; // Above this = sparse
+			const float DenseThreshold = 40.0f * NeighbourScale;  // Below this = dense
+			const float SparseThreshold = 120.0f * NeighbourScale; // Above this = sparse
 			
-			if (NearestDistance <= DenseThreshold)
+			if (NeighbourDistance <= DenseThreshold)
 			{
 				SphereSize = MinCubeSize; // Dense area = small sphere
 			}
-			else if (NearestDistance >= SparseThreshold)
+			else if (NeighbourDistance >= SparseThreshold)
 			{
 				SphereSize = MaxCubeSize; // Sparse area = large sphere
 			}
 			else
 			{
 				// Smooth interpolation with ease-in-out curve for better blending
-				float T = (NearestDistance - DenseThreshold) / (SparseThreshold - DenseThreshold);
+				float T = (NeighbourDistance - DenseThreshold) / (SparseThreshold - DenseThreshold);
 				// Apply ease-in-out curve: smooth start and end, faster in middle
 				float EasedT = T < 0.5f 
 					? 2.0f * T * T 
@@ -1065,15 +1090,94 @@ void USplatCreatorSubsystem::CalculateAdaptiveSphereSizes(const TArray<FVector>&
 		}
 		
 		// No multiplier - use increased base sizes to avoid z-fighting while maintaining density illusion
-		OutSphereSizes.Add(FMath::Clamp(SphereSize, MinCubeSize, MaxCubeSize));
-	}
+		OutSphereSizes[i] = FMath::Clamp(SphereSize, MinCubeSize, MaxCubeSize);
+	});
 	
 	if (debug) UE_LOG(LogTemp, Display, TEXT("[SplatCreator] Calculated adaptive sphere sizes: min=%.3f, max=%.3f"), 
 		MinCubeSize, MaxCubeSize);
 }
 
-void USplatCreatorSubsystem::CreatePointCloud(const TArray<FVector>& Positions, const TArray<FColor>& Colors)
+FSplatDensityBenchmark USplatCreatorSubsystem::BenchmarkSphereSizing(int32 NumPoints, int32 Neighbours) const
 {
+	FSplatDensityBenchmark Result;
+	NumPoints = FMath::Max(NumPoints, 2);
+	Neighbours = FMath::Clamp(Neighbours, 1, FSplatPointGrid::MaxNeighbours);
+	Result.NumPoints = NumPoints;
+	Result.Neighbours = Neighbours;
+
+	// Synthetic scan: a noisy rippled surface with sparse outliers, in shuffled order like real PLY output (scaled units)
+	TArray<FVector> Positions;
+	Positions.SetNumUninitialized(NumPoints);
+	FRandomStream Random(1234);
+	const float Extent = 200.0f * FMath::Sqrt(float(NumPoints) / 1000.0f);
+	for (int32 i = 0; i < NumPoints; i++)
+	{
+		const float X = Random.FRandRange(-Extent, Extent);
+		const float Y = Random.FRandRange(-Extent, Extent);
+		const float Z = (i % 50 == 0) ? Random.FRandRange(-Extent, Extent) * 0.25f
+		                              : 60.0f * FMath::Sin(X * 0.01f) * FMath::Cos(Y * 0.013f) + Random.FRandRange(-5.0f, 5.0f);
+		Positions[i] = FVector(X, Y, Z);
+	}
+
+	// Grid build alone, then the full pass as sphere sizing runs it (build + parallel queries)
+	double Start = FPlatformTime::Seconds();
+	FSplatPointGrid Grid;
+	Grid.Build(Positions);
+	Result.GridBuildMs = float((FPlatformTime::Seconds() - Start) * 1000.0);
+
+	TArray<float> MeanDistances;
+	Start = FPlatformTime::Seconds();
+	FSplatPointGrid::ComputeMeanNeighbourDistances(Positions, Neighbours, MeanDistances);
+	Result.KnnMs = float((FPlatformTime::Seconds() - Start) * 1000.0);
+
+	// Previous sizing: nearest point within +-500 array indices, on a sample, extrapolated linearly
+	const int32 SampleCount = FMath::Min(NumPoints, 20000);
+	const int32 SampleStep = FMath::Max(1, NumPoints / SampleCount);
+	const int32 SearchRange = FMath::Min(1000, NumPoints);
+	TArray<float> LegacyDistSq;
+	LegacyDistSq.SetNumUninitialized(SampleCount);
+	Start = FPlatformTime::Seconds();
+	for (int32 Sample = 0; Sample < SampleCount; Sample++)
+	{
+		const int32 i = Sample * SampleStep;
+		float NearestDistSq = MAX_flt;
+		const int32 StartIdx = FMath::Max(0, i - SearchRange / 2);
+		const int32 EndIdx = FMath::Min(NumPoints, i + SearchRange / 2);
+		for (int32 j = StartIdx; j < EndIdx; j++)
+		{
+			if (i != j)
+			{
+				NearestDistSq = FMath::Min(NearestDistSq, float(FVector::DistSquared(Positions[i], Positions[j])));
+			}
+		}
+		LegacyDistSq[Sample] = NearestDistSq;
+	}
+	const double LegacySeconds = FPlatformTime::Seconds() - Start;
+
+	// How often the index window actually contained the true nearest neighbour
+	int32 ExactMatches = 0;
+	for (int32 Sample = 0; Sample < SampleCount; Sample++)
+	{
+		float ExactDistSq = MAX_flt;
+		Grid.FindKNearest(FVector3f(Positions[Sample * SampleStep]), 1, Sample * SampleStep, &ExactDistSq);
+		if (LegacyDistSq[Sample] <= ExactDistSq * 1.0001f)
+		{
+			ExactMatches++;
+		}
+	}
+	Result.LegacyMsEstimated = float(LegacySeconds * 1000.0 * NumPoints / SampleCount);
+	Result.LegacyNearestAccuracy = float(ExactMatches) / SampleCount;
+	Result.Speedup = Result.KnnMs > 0.0f ? Result.LegacyMsEstimated / Result.KnnMs : 0.0f;
+
+	UE_LOG(LogTemp, Display, TEXT("[SplatCreator] Sphere sizing %d points, k=%d: grid build %.1f ms, k-NN total %.1f ms; index-window scan ~%.1f ms (nearest correct %.1f%%), speedup %.1fx"),
+		NumPoints, Neighbours, Result.GridBuildMs, Result.KnnMs, Result.LegacyMsEstimated, Result.LegacyNearestAccuracy * 100.0f, Result.Speedup);
+	return Result;
+}
+
+void USplatCreatorSubsystem::CreatePointCloud(const FSplatPreparedCloud& Cloud)
+{
+	const TArray<FVector>& Positions = Cloud.Positions;
+	const TArray<FColor>& Colors = Cloud.Colors;
 	UWorld* World = GetWorld();
 	if (!World) return;
 	
@@ -1122,11 +1226,11 @@ void USplatCreatorSubsystem::CreatePointCloud(const TArray<FVector>& Positions,
 	if (!bMorphMaterialLoaded && debug)
 		UE_LOG(LogTemp, Warning, TEXT("[SplatCreator] Plane morph material not found at %s - using direct 3D display."), *PlaneMorphMaterialPath.ToString());
 	
-	// Precompute scaled positions and sphere sizes (needed for both paths)
+	// Scaled positions (needed for both paths); sphere sizes were computed with the prepared splat
 	TArray<FVector> ScaledPositions;
 	ScaledPositions.Reserve(Positions.Num());
-	for (const FVector& Pos : Positions) ScaledPositions.Add(Pos * 125.0f);
-	CalculateAdaptiveSphereSizes(ScaledPositions, SphereSizes);
+	for (const FVector& Pos : Positions) ScaledPositions.Add(Pos * SplatPositionScale);
+	SphereSizes = Cloud.SphereSizes;
 	const float FlatPlaneY = -PlaneMorphY;
 	float FlatMorphZ = PlaneMorphFlatZ;
 	if (bPlaneMorphZFromLowestPoint && ScaledPositions.Num() > 0)
@@ -1139,6 +1243,7 @@ void USplatCreatorSubsystem::CreatePointCloud(const TArray<FVector>& Positions,
 		FlatMorphZ = MinZ - PlaneMorphZLowestMargin;
 	}
 	const FVector DownOffset = FVector(0.0f, 0.0f, 0.0f);
+	SplatRestOffset = DownOffset;
 	const int32 NumInstances = FMath::Min(Positions.Num(), Colors.Num());
 	
 	// Create DynamicMaterial
@@ -1248,7 +1353,7 @@ void USplatCreatorSubsystem::CreatePointCloud(const TArray<FVector>& Positions,
 		
 		for (int32 i = BatchStart; i < BatchEnd; i++)
 		{
-			FVector ScaledPos = Positions[i] * 125.0f + DownOffset;
+			FVector ScaledPos = Positions[i] * SplatPositionScale + DownOffset;
 			FTransform Transform;
 			// Always place at 3D - bounds must match geometry for visibility when camera is inside
 			// Plane morph: material WPO uses (1-MorphProgress) to pull points to flat plane at start
@@ -1285,11 +1390,8 @@ void USplatCreatorSubsystem::CreatePointCloud(const TArray<FVector>& Positions,
 	// Force update bounds after all instances are added (critical for preventing culling)
 		if (CurrentPointPositions.Num() > 0)
 		{
-		FBox BoundingBox(ForceInit);
-		for (const FVector& Pos : CurrentPointPositions)
-		{
-			BoundingBox += Pos;
-		}
+		// 3D extent comes with the prepared splat (cached next to the PLY)
+		FBox BoundingBox = Cloud.Bounds.IsValid ? Cloud.Bounds.ShiftBy(DownOffset) : FBox(CurrentPointPositions);
 		// Include flat plane positions too - WPO moves vertices there during morph, so bounds must encompass both flat and 3D
 		if (bMorphMaterialLoaded)
 		{
@@ -1644,6 +1746,11 @@ TArray<FVector> USplatCreatorSubsystem::GetDensePointRegions(float DensityThresh
 	return DenseRegions;
 }
 
+bool USplatCreatorSubsystem::IsFirstSplatPending() const
+{
+	return CurrentLoadedPlyPath.IsEmpty() && !PendingShowPath.IsEmpty();
+}
+
 bool USplatCreatorSubsystem::IsPositionTooCloseToSplatPoints(const FVector& Position, float MinDistance, bool bCheckHorizontalOnly) const
 {
 	if (CurrentPointPositions.Num() == 0)
@@ -1651,6 +1758,21 @@ bool USplatCreatorSubsystem::IsPositionTooCloseToSplatPoints(const FVector& Posi
 		return false;
 	}
 
+	// Horizontal check straight from the distance raster; a 3D check can only be closer than the horizontal one allows
+	if (const FSplatPlacementField* Field = GetPlacementField())
+	{
+		const float HorizontalDistance = GetDistanceToSplatPoints(Position);
+		if (bCheckHorizontalOnly)
+		{
+			return HorizontalDistance < MinDistance;
+		}
+		const float Tolerance = Field->GetCellSize() * FMath::Abs(GetSplatRestToWorld().GetScale3D().X);
+		if (HorizontalDistance >= MinDistance + Tolerance)
+		{
+			return false;
+		}
+	}
+
 	// Position is in world space; transform splat points to world for comparison
 	const FTransform ActorTransform = CurrentPointCloudActor ? CurrentPointCloudActor->GetActorTransform() : FTransform::Identity;
 	const float MinDistanceSquared = MinDistance * MinDistance;
@@ -1679,6 +1801,238 @@ bool USplatCreatorSubsystem::IsPositionTooCloseToSplatPoints(const FVector& Posi
 	return false;
 }
 
+// ============================================================
+// PLACEMENT FIELD QUERIES
+// ============================================================
+
+const FSplatPlacementField* USplatCreatorSubsystem::GetPlacementField() const
+{
+	if (!CurrentSplat.IsValid() || !CurrentSplat->PlacementField.IsValid() || CurrentPointPositions.Num() == 0)
+	{
+		return nullptr;
+	}
+	return &CurrentSplat->PlacementField;
+}
+
+FTransform USplatCreatorSubsystem::GetSplatRestToWorld() const
+{
+	// Rest space (scaled PLY positions, as the placement field and sphere BVH are built) -> actor space
+	// (DownOffset, then SetSplatScale about the bounds centre) -> world.
+	// The actor is only yawed or flipped (roll 180), so its XY plane stays horizontal.
+	const float Scale = SplatScaleMultiplier;
+	const FVector Center = bHasSplatBounds ? CurrentSplatBounds.GetCenter() : FVector::ZeroVector;
+	const FTransform RestToActor(FQuat::Identity, Center + (SplatRestOffset - Center) * Scale, FVector(Scale));
+	const FTransform ActorTransform = CurrentPointCloudActor ? CurrentPointCloudActor->GetActorTransform() : FTransform::Identity;
+	return RestToActor * ActorTransform;
+}
+
+float USplatCreatorSubsystem::GetDistanceToSplatPoints(const FVector& Position) const
+{
+	const FSplatPlacementField* Field = GetPlacementField();
+	if (!Field)
+	{
+		return MAX_flt;
+	}
+	const FTransform FieldToWorld = GetSplatRestToWorld();
+	const FVector FieldPosition = FieldToWorld.InverseTransformPosition(Position);
+	return Field->GetDistance(FVector2D(FieldPosition)) * FMath::Abs(FieldToWorld.GetScale3D().X);
+}
+
+bool USplatCreatorSubsystem::IsSplatPlacementFree(const FVector& Position, float MinDistance) const
+{
+	return GetDistanceToSplatPoints(Position) >= MinDistance;
+}
+
+bool USplatCreatorSubsystem::GetSplatGroundHeight(const FVector& Position, float& OutHeight) const
+{
+	TArray<float> Heights;
+	TArray<bool> HasGround;
+	GetSplatGroundHeights({ Position }, Heights, HasGround);
+	OutHeight = Heights[0];
+	return HasGround[0];
+}
+
+TArray<float> USplatCreatorSubsystem::GetDistancesToSplatPoints(const TArray<FVector>& Positions) const
+{
+	TArray<float> Distances;
+	Distances.Init(MAX_flt, Positions.Num());
+	const FSplatPlacementField* Field = GetPlacementField();
+	if (!Field)
+	{
+		return Distances;
+	}
+
+	const FTransform FieldToWorld = GetSplatRestToWorld();
+	const float WorldScale = FMath::Abs(FieldToWorld.GetScale3D().X);
+	for (int32 i = 0; i < Positions.Num(); i++)
+	{
+		Distances[i] = Field->GetDistance(FVector2D(FieldToWorld.InverseTransformPosition(Positions[i]))) * WorldScale;
+	}
+	return Distances;
+}
+
+TArray<bool> USplatCreatorSubsystem::AreSplatPlacementsFree(const TArray<FVector>& Positions, float MinDistance) const
+{
+	const TArray<float> Distances = GetDistancesToSplatPoints(Positions);
+	TArray<bool> Free;
+	Free.SetNumUninitialized(Distances.Num());
+	for (int32 i = 0; i < Distances.Num(); i++)
+	{
+		Free[i] = Distances[i] >= MinDistance;
+	}
+	return Free;
+}
+
+void USplatCreatorSubsystem::GetSplatGroundHeights(const TArray<FVector>& Positions, TArray<float>& OutHeights, TArray<bool>& OutHasGround) const
+{
+	OutHeights.Init(0.0f, Positions.Num());
+	OutHasGround.Init(false, Positions.Num());
+	const FSplatPlacementField* Field = GetPlacementField();
+	if (!Field)
+	{
+		return;
+	}
+
+	const FTransform FieldToWorld = GetSplatRestToWorld();
+	for (int32 i = 0; i < Positions.Num(); i++)
+	{
+		const FVector FieldPosition = FieldToWorld.InverseTransformPosition(Positions[i]);
+		float MinZ, MaxZ;
+		if (Field->GetHeightRange(FVector2D(FieldPosition), MinZ, MaxZ))
+		{
+			// Either end of the column can be on top once the actor is flipped
+			const double LowEnd = FieldToWorld.TransformPosition(FVector(FieldPosition.X, FieldPosition.Y, MinZ)).Z;
+			const double HighEnd = FieldToWorld.TransformPosition(FVector(FieldPosition.X, FieldPosition.Y, MaxZ)).Z;
+			OutHeights[i] = float(FMath::Max(LowEnd, HighEnd));
+			OutHasGround[i] = true;
+		}
+	}
+}
+
+// ============================================================
+// PICKING
+// ============================================================
+
+float USplatCreatorSubsystem::GetSplatAnimationReach() const
+{
+	// Furthest an animated instance strays from its rest position, before scaling (Set Splat Scale is undone exactly)
+	if (bIsBobbing || bIsRandomMoving || bIsInterpolatingToBase)
+	{
+		return FMath::Max(FMath::Abs(BobbingAmplitude), RandomMovementRadius);
+	}
+	return 0.0f;
+}
+
+FSplatRayHit USplatCreatorSubsystem::TraceSplat(const FVector& Origin, const FVector& Direction, float MaxDistance, const FTransform& RestToWorld, const FTransform& ActorTransform, float Inflate) const
+{
+	FSplatRayHit Hit;
+	const FVector WorldDirection = Direction.GetSafeNormal();
+	if (WorldDirection.IsZero() || MaxDistance <= 0.0f)
+	{
+		return Hit;
+	}
+
+	// Same ray parameter (world distance) in every space: origin and direction go through the same affine map
+	const FVector RestOrigin = RestToWorld.InverseTransformPosition(Origin);
+	const FVector RestDirection = RestToWorld.InverseTransformVector(WorldDirection);
+	const FVector LocalOrigin = ActorTransform.InverseTransformPosition(Origin);
+	const FVector LocalDirection = ActorTransform.InverseTransformVector(WorldDirection);
+	const double DirectionSq = LocalDirection.SizeSquared();
+
+	// BVH candidates (rest spheres grown by the animation reach), confirmed against the instance as it is now
+	FVector HitCentre = FVector::ZeroVector;
+	double HitT = 0.0;
+	CurrentSplat->SphereBVH.Raycast(FVector3f(RestOrigin), FVector3f(RestDirection), MaxDistance, Inflate, [&](int32 Index, float MaxT)
+	{
+		FTransform Instance;
+		if (!PointCloudComponent->GetInstanceTransform(Index, Instance, false))
+		{
+			return MaxT;
+		}
+		const FVector Centre = Instance.GetLocation();
+		const double Radius = SplatSphereMeshRadius * Instance.GetScale3D().X;
+		const FVector ToOrigin = LocalOrigin - Centre;
+		const double B = FVector::DotProduct(ToOrigin, LocalDirection);
+		const double Discriminant = B * B - DirectionSq * (ToOrigin.SizeSquared() - Radius * Radius);
+		if (Discriminant < 0.0)
+		{
+			return MaxT;
+		}
+		const double T = (-B - FMath::Sqrt(Discriminant)) / DirectionSq;
+		if (T < 0.0 || T >= MaxT)
+		{
+			return MaxT;
+		}
+		Hit.bHit = true;
+		Hit.InstanceIndex = Index;
+		HitCentre = Centre;
+		HitT = T;
+		return float(T);
+	});
+	if (!Hit.bHit)
+	{
+		return Hit;
+	}
+
+	Hit.Distance = float(HitT);
+	Hit.Location = Origin + WorldDirection * HitT;
+	Hit.Normal = ActorTransform.TransformVectorNoScale(LocalOrigin + LocalDirection * HitT - HitCentre).GetSafeNormal();
+	if (CurrentSplat->Colors.IsValidIndex(Hit.InstanceIndex))
+	{
+		Hit.Color = CurrentSplat->Colors[Hit.InstanceIndex];
+	}
+	return Hit;
+}
+
+FSplatRayHit USplatCreatorSubsystem::RaycastSplat(const FVector& Origin, const FVector& Direction, float MaxDistance) const
+{
+	const TArray<FSplatRayHit> Hits = RaycastSplatBatch({ Origin }, { Direction }, MaxDistance);
+	return Hits[0];
+}
+
+TArray<FSplatRayHit> USplatCreatorSubsystem::RaycastSplatBatch(const TArray<FVector>& Origins, const TArray<FVector>& Directions, float MaxDistance) const
+{
+	TArray<FSplatRayHit> Hits;
+	Hits.SetNum(FMath::Min(Origins.Num(), Directions.Num()));
+	if (!PointCloudComponent || !CurrentSplat.IsValid() || !CurrentSplat->SphereBVH.IsValid())
+	{
+		return Hits;
+	}
+
+	const FTransform RestToWorld = GetSplatRestToWorld();
+	const FTransform ActorTransform = CurrentPointCloudActor ? CurrentPointCloudActor->GetActorTransform() : FTransform::Identity;
+	const float Inflate = GetSplatAnimationReach();
+	for (int32 i = 0; i < Hits.Num(); i++)
+	{
+		Hits[i] = TraceSplat(Origins[i], Directions[i], MaxDistance, RestToWorld, ActorTransform, Inflate);
+	}
+	return Hits;
+}
+
+TArray<FSplatRayHit> USplatCreatorSubsystem::PickSplatAtScreenPositions(APlayerController* PlayerController, const TArray<FVector2D>& ScreenPositions, float MaxDistance) const
+{
+	if (!PlayerController)
+	{
+		UWorld* World = GetWorld();
+		PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	}
+
+	TArray<FVector> Origins, Directions;
+	Origins.Reserve(ScreenPositions.Num());
+	Directions.Reserve(ScreenPositions.Num());
+	for (const FVector2D& ScreenPosition : ScreenPositions)
+	{
+		FVector Origin = FVector::ZeroVector, Direction = FVector::ZeroVector;
+		if (PlayerController)
+		{
+			PlayerController->DeprojectScreenPositionToWorld(float(ScreenPosition.X), float(ScreenPosition.Y), Origin, Direction);
+		}
+		Origins.Add(Origin);
+		Directions.Add(Direction);
+	}
+	return RaycastSplatBatch(Origins, Directions, MaxDistance);
+}
+
 // ============================================================
 // OSC MESSAGE HANDLING AND BOBBING ANIMATION
 // ============================================================
@@ -0,0 +1,175 @@
+#include "SplatCreator/SplatPlacementField.h"
+#include "Async/ParallelFor.h"
+
+static bool debug = false;
+//Occupancy, distance and height rasters of a splat for placement queries
+
+// Squared distance standing in for "no occupied cell on this line"
+static constexpr float FarDistSq = 1e20f;
+
+void FSplatPlacementField::Build(const TArray<FVector>& Points, float PositionScale, int32 MaxResolution)
+{
+	Distance.Reset();
+	MinZ.Reset();
+	MaxZ.Reset();
+	Dims = FIntPoint::ZeroValue;
+	if (Points.Num() == 0)
+	{
+		return;
+	}
+
+	FBox2f Bounds(ForceInit);
+	for (const FVector& Point : Points)
+	{
+		Bounds += FVector2f(Point.X * PositionScale, Point.Y * PositionScale);
+	}
+
+	// Margin so placements just outside the splat still read real distances
+	const FVector2f Size = Bounds.GetSize();
+	const float Extent = FMath::Max(FMath::Max(Size.X, Size.Y), 1.0f);
+	const float Margin = Extent * 0.25f;
+	MaxResolution = FMath::Clamp(MaxResolution, 16, 4096);
+	CellSize = (Extent + 2.0f * Margin) / MaxResolution;
+	InvCellSize = 1.0f / CellSize;
+	Origin = Bounds.Min - FVector2f(Margin);
+	Dims = FIntPoint(
+		FMath::Clamp(FMath::CeilToInt32((Size.X + 2.0f * Margin) * InvCellSize), 1, MaxResolution),
+		FMath::Clamp(FMath::CeilToInt32((Size.Y + 2.0f * Margin) * InvCellSize), 1, MaxResolution));
+	const int32 NumCells = Dims.X * Dims.Y;
+
+	// Heightfield (and with it occupancy)
+	MinZ.Init(MAX_flt, NumCells);
+	MaxZ.Init(-MAX_flt, NumCells);
+	for (const FVector& Point : Points)
+	{
+		const int32 X = FMath::Clamp(FMath::FloorToInt32((Point.X * PositionScale - Origin.X) * InvCellSize), 0, Dims.X - 1);
+		const int32 Y = FMath::Clamp(FMath::FloorToInt32((Point.Y * PositionScale - Origin.Y) * InvCellSize), 0, Dims.Y - 1);
+		const int32 Cell = Y * Dims.X + X;
+		const float Z = float(Point.Z * PositionScale);
+		MinZ[Cell] = FMath::Min(MinZ[Cell], Z);
+		MaxZ[Cell] = FMath::Max(MaxZ[Cell], Z);
+	}
+
+	// Separable exact distance transform: columns, then rows (lines are independent)
+	Distance.SetNumUninitialized(NumCells);
+	ParallelFor(Dims.X, [&](int32 X)
+	{
+		TArray<float> In, Out, Boundaries;
+		TArray<int32> Vertices;
+		In.SetNumUninitialized(Dims.Y);
+		Out.SetNumUninitialized(Dims.Y);
+		Vertices.SetNumUninitialized(Dims.Y);
+		Boundaries.SetNumUninitialized(Dims.Y + 1);
+		for (int32 Y = 0; Y < Dims.Y; Y++)
+		{
+			const int32 Cell = Y * Dims.X + X;
+			In[Y] = MinZ[Cell] <= MaxZ[Cell] ? 0.0f : FarDistSq;
+		}
+		DistanceTransform1D(In.GetData(), Out.GetData(), Dims.Y, Vertices.GetData(), Boundaries.GetData());
+		for (int32 Y = 0; Y < Dims.Y; Y++)
+		{
+			Distance[Y * Dims.X + X] = Out[Y];
+		}
+	});
+	ParallelFor(Dims.Y, [&](int32 Y)
+	{
+		TArray<float> Out, Boundaries;
+		TArray<int32> Vertices;
+		Out.SetNumUninitialized(Dims.X);
+		Vertices.SetNumUninitialized(Dims.X);
+		Boundaries.SetNumUninitialized(Dims.X + 1);
+		float* Row = Distance.GetData() + Y * Dims.X;
+		DistanceTransform1D(Row, Out.GetData(), Dims.X, Vertices.GetData(), Boundaries.GetData());
+		for (int32 X = 0; X < Dims.X; X++)
+		{
+			Row[X] = FMath::Sqrt(Out[X]) * CellSize;
+		}
+	});
+
+	if (debug) UE_LOG(LogTemp, Display, TEXT("[SplatPlacementField] %d points -> %dx%d cells of %.2f"), Points.Num(), Dims.X, Dims.Y, CellSize);
+}
+
+void FSplatPlacementField::DistanceTransform1D(const float* In, float* Out, int32 Count, int32* Vertices, float* Boundaries)
+{
+	// Lower envelope of the parabolas (q - p)^2 + In[p]
+	int32 K = 0;
+	Vertices[0] = 0;
+	Boundaries[0] = -MAX_flt;
+	Boundaries[1] = MAX_flt;
+	for (int32 Q = 1; Q < Count; Q++)
+	{
+		// Intersection with the rightmost envelope parabola; drop those it hides
+		auto Intersect = [&](int32 V) { return ((In[Q] + float(Q * Q)) - (In[V] + float(V * V))) / float(2 * (Q - V)); };
+		float S = Intersect(Vertices[K]);
+		while (S <= Boundaries[K])
+		{
+			K--;
+			S = Intersect(Vertices[K]);
+		}
+		K++;
+		Vertices[K] = Q;
+		Boundaries[K] = S;
+		Boundaries[K + 1] = MAX_flt;
+	}
+
+	K = 0;
+	for (int32 Q = 0; Q < Count; Q++)
+	{
+		while (Boundaries[K + 1] < float(Q))
+		{
+			K++;
+		}
+		const int32 V = Vertices[K];
+		Out[Q] = float((Q - V) * (Q - V)) + In[V];
+	}
+}
+
+float FSplatPlacementField::GetDistance(const FVector2D& Local) const
+{
+	if (!IsValid())
+	{
+		return MAX_flt;
+	}
+
+	// Continuous cell-centre coordinates, clamped to the raster
+	const float FX = (float(Local.X) - Origin.X) * InvCellSize - 0.5f;
+	const float FY = (float(Local.Y) - Origin.Y) * InvCellSize - 0.5f;
+	const float CX = FMath::Clamp(FX, 0.0f, float(Dims.X - 1));
+	const float CY = FMath::Clamp(FY, 0.0f, float(Dims.Y - 1));
+	const int32 X0 = FMath::Min(FMath::FloorToInt32(CX), Dims.X - 1);
+	const int32 Y0 = FMath::Min(FMath::FloorToInt32(CY), Dims.Y - 1);
+	const int32 X1 = FMath::Min(X0 + 1, Dims.X - 1);
+	const int32 Y1 = FMath::Min(Y0 + 1, Dims.Y - 1);
+	const float TX = CX - X0;
+	const float TY = CY - Y0;
+	const float Top = FMath::Lerp(Distance[Y0 * Dims.X + X0], Distance[Y0 * Dims.X + X1], TX);
+	const float Bottom = FMath::Lerp(Distance[Y1 * Dims.X + X0], Distance[Y1 * Dims.X + X1], TX);
+	const float Inside = FMath::Lerp(Top, Bottom, TY);
+
+	// Outside: triangle inequality through the nearest edge sample
+	const float Outside = FMath::Sqrt(FMath::Square(FX - CX) + FMath::Square(FY - CY)) * CellSize;
+	return Inside + Outside;
+}
+
+bool FSplatPlacementField::GetHeightRange(const FVector2D& Local, float& OutMinZ, float& OutMaxZ) const
+{
+	if (!IsValid())
+	{
+		return false;
+	}
+
+	const int32 X = FMath::FloorToInt32((float(Local.X) - Origin.X) * InvCellSize);
+	const int32 Y = FMath::FloorToInt32((float(Local.Y) - Origin.Y) * InvCellSize);
+	if (X < 0 || Y < 0 || X >= Dims.X || Y >= Dims.Y)
+	{
+		return false;
+	}
+	const int32 Cell = Y * Dims.X + X;
+	if (MinZ[Cell] > MaxZ[Cell])
+	{
+		return false;
+	}
+	OutMinZ = MinZ[Cell];
+	OutMaxZ = MaxZ[Cell];
+	return true;
+}
@@ -0,0 +1,591 @@
+#include "SplatCreator/SplatPlyReader.h"
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/ByteSwap.h"
+#include "Misc/FileHelper.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#endif
+
+static bool debug = false;
+//Typed PLY vertex reader: header from bytes, vertex block memory-mapped and decoded in parallel
+
+// ============================================================
+// Mapped file
+// ============================================================
+
+FSplatMappedFile::FSplatMappedFile() = default;
+
+FSplatMappedFile::~FSplatMappedFile()
+{
+	Close();
+}
+
+bool FSplatMappedFile::Open(const FString& Path)
+{
+	Close();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const int64 FileSize = PlatformFile.FileSize(*Path);
+	if (FileSize <= 0)
+	{
+		return false;
+	}
+
+	auto Mapped = PlatformFile.OpenMappedEx(*Path);
+	if (Mapped.HasValue())
+	{
+		Handle = Mapped.StealValue();
+		Region.Reset(Handle->MapRegion(0, FileSize));
+		if (Region)
+		{
+			Data = Region->GetMappedPtr();
+			Size = Region->GetMappedSize();
+			return true;
+		}
+		Handle.Reset();
+	}
+
+	// No mapping on this platform/file system: one plain read
+	if (!FFileHelper::LoadFileToArray(Fallback, *Path))
+	{
+		return false;
+	}
+	Data = Fallback.GetData();
+	Size = Fallback.Num();
+	if (debug) UE_LOG(LogTemp, Verbose, TEXT("[SplatPlyReader] Mapping unavailable, loaded %s (%lld bytes)"), *Path, Size);
+	return true;
+}
+
+void FSplatMappedFile::Close()
+{
+	// Region before handle
+	Region.Reset();
+	Handle.Reset();
+	Fallback.Empty();
+	Data = nullptr;
+	Size = 0;
+}
+
+// ============================================================
+// Header
+// ============================================================
+
+namespace SplatPly
+{
+	enum class EType : uint8 { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64, Invalid };
+	enum class EFormat : uint8 { Ascii, BinaryLittleEndian, BinaryBigEndian };
+
+	struct FProperty
+	{
+		FString Name;
+		EType Type = EType::Invalid;
+		int32 Offset = 0;
+		bool bList = false;
+	};
+
+	struct FElement
+	{
+		FString Name;
+		int64 Count = 0;
+		int32 Stride = 0;
+		bool bHasList = false;
+		TArray<FProperty> Properties;
+
+		int32 FindProperty(const TCHAR* PropertyName) const
+		{
+			return Properties.IndexOfByPredicate([PropertyName](const FProperty& P) { return P.Name == PropertyName; });
+		}
+	};
+
+	struct FHeader
+	{
+		EFormat Format = EFormat::Ascii;
+		int64 Size = 0;
+		TArray<FElement> Elements;
+	};
+
+	static EType ParseType(const FString& Name)
+	{
+		if (Name == TEXT("char") || Name == TEXT("int8")) return EType::Int8;
+		if (Name == TEXT("uchar") || Name == TEXT("uint8")) return EType::UInt8;
+		if (Name == TEXT("short") || Name == TEXT("int16")) return EType::Int16;
+		if (Name == TEXT("ushort") || Name == TEXT("uint16")) return EType::UInt16;
+		if (Name == TEXT("int") || Name == TEXT("int32")) return EType::Int32;
+		if (Name == TEXT("uint") || Name == TEXT("uint32")) return EType::UInt32;
+		if (Name == TEXT("float") || Name == TEXT("float32")) return EType::Float32;
+		if (Name == TEXT("double") || Name == TEXT("float64")) return EType::Float64;
+		return EType::Invalid;
+	}
+
+	static int32 TypeSize(EType Type)
+	{
+		switch (Type)
+		{
+		case EType::Int8: case EType::UInt8: return 1;
+		case EType::Int16: case EType::UInt16: return 2;
+		case EType::Int32: case EType::UInt32: case EType::Float32: return 4;
+		case EType::Float64: return 8;
+		default: return 0;
+		}
+	}
+
+	static bool IsFloatType(EType Type)
+	{
+		return Type == EType::Float32 || Type == EType::Float64;
+	}
+
+	// Only the header bytes become text; the vertex block is never converted
+	static bool ParseHeader(const uint8* Data, int64 Size, FHeader& Out)
+	{
+		static const ANSICHAR EndToken[] = "end_header";
+		const int64 EndLen = UE_ARRAY_COUNT(EndToken) - 1;
+		const int64 SearchLimit = FMath::Min<int64>(Size, 1024 * 1024);
+		if (SearchLimit < 3 || FMemory::Memcmp(Data, "ply", 3) != 0)
+		{
+			return false;
+		}
+
+		int64 EndPos = INDEX_NONE;
+		for (int64 i = 0; i + EndLen <= SearchLimit; i++)
+		{
+			if (Data[i] == 'e' && FMemory::Memcmp(Data + i, EndToken, EndLen) == 0 && (i == 0 || Data[i - 1] == '\n'))
+			{
+				EndPos = i;
+				break;
+			}
+		}
+		if (EndPos == INDEX_NONE)
+		{
+			return false;
+		}
+
+		// Data starts after the end_header line (LF or CRLF)
+		int64 DataStart = EndPos + EndLen;
+		while (DataStart < Size && Data[DataStart] != '\n')
+		{
+			DataStart++;
+		}
+		Out.Size = FMath::Min(DataStart + 1, Size);
+
+		const FString HeaderText = FString::ConstructFromPtrSize(reinterpret_cast<const ANSICHAR*>(Data), int32(EndPos));
+		TArray<FString> Lines;
+		HeaderText.ParseIntoArrayLines(Lines);
+
+		for (const FString& Line : Lines)
+		{
+			TArray<FString> Parts;
+			Line.ParseIntoArrayWS(Parts);
+			if (Parts.Num() == 0)
+			{
+				continue;
+			}
+
+			if (Parts[0] == TEXT("format") && Parts.Num() >= 2)
+			{
+				Out.Format = Parts[1] == TEXT("binary_little_endian") ? EFormat::BinaryLittleEndian
+				           : Parts[1] == TEXT("binary_big_endian") ? EFormat::BinaryBigEndian
+				           : EFormat::Ascii;
+			}
+			else if (Parts[0] == TEXT("element") && Parts.Num() >= 3)
+			{
+				FElement& Element = Out.Elements.AddDefaulted_GetRef();
+				Element.Name = Parts[1];
+				Element.Count = FCString::Atoi64(*Parts[2]);
+			}
+			else if (Parts[0] == TEXT("property") && Parts.Num() >= 3 && Out.Elements.Num() > 0)
+			{
+				FElement& Element = Out.Elements.Last();
+				FProperty& Property = Element.Properties.AddDefaulted_GetRef();
+				if (Parts[1] == TEXT("list"))
+				{
+					// Variable size: the element has no fixed stride
+					Property.bList = true;
+					Property.Name = Parts.Last();
+					Element.bHasList = true;
+					continue;
+				}
+				Property.Name = Parts[2];
+				Property.Type = ParseType(Parts[1]);
+				Property.Offset = Element.Stride;
+				if (Property.Type == EType::Invalid)
+				{
+					if (debug) UE_LOG(LogTemp, Warning, TEXT("[SplatPlyReader] Unknown property type '%s'"), *Parts[1]);
+					return false;
+				}
+				Element.Stride += TypeSize(Property.Type);
+			}
+		}
+		return Out.Elements.Num() > 0;
+	}
+
+	// ============================================================
+	// Decode
+	// ============================================================
+
+	FORCEINLINE static float ReadScalar(const uint8* P, EType Type, bool bSwap)
+	{
+		switch (Type)
+		{
+		case EType::Int8: return float(*reinterpret_cast<const int8*>(P));
+		case EType::UInt8: return float(*P);
+		case EType::Int16:
+		case EType::UInt16:
+		{
+			uint16 V;
+			FMemory::Memcpy(&V, P, sizeof(V));
+			if (bSwap) V = BYTESWAP_ORDER16(V);
+			return Type == EType::Int16 ? float(int16(V)) : float(V);
+		}
+		case EType::Int32:
+		case EType::UInt32:
+		case EType::Float32:
+		{
+			uint32 V;
+			FMemory::Memcpy(&V, P, sizeof(V));
+			if (bSwap) V = BYTESWAP_ORDER32(V);
+			if (Type == EType::Float32)
+			{
+				float F;
+				FMemory::Memcpy(&F, &V, sizeof(F));
+				return F;
+			}
+			return Type == EType::Int32 ? float(int32(V)) : float(V);
+		}
+		case EType::Float64:
+		{
+			uint64 V;
+			FMemory::Memcpy(&V, P, sizeof(V));
+			if (bSwap) V = BYTESWAP_ORDER64(V);
+			double D;
+			FMemory::Memcpy(&D, &V, sizeof(D));
+			return float(D);
+		}
+		default:
+			return 0.0f;
+		}
+	}
+
+	// Gaussian splat DC term to RGBA8: clamp(0.5 + SH_C0 * dc, 0, 1) * 255
+	static void DCToColors(const float* R, const float* G, const float* B, int32 Count, FColor* Out)
+	{
+		constexpr float SH_C0 = 0.28209479177387814f;
+		int32 I = 0;
+
+#if PLATFORM_CPU_X86_FAMILY && PLATFORM_LITTLE_ENDIAN
+		// FColor is B, G, R, A in memory, i.e. A << 24 | R << 16 | G << 8 | B as a uint32
+		const __m128 Half = _mm_set1_ps(0.5f);
+		const __m128 C0 = _mm_set1_ps(SH_C0);
+		const __m128 Zero = _mm_setzero_ps();
+		const __m128 One = _mm_set1_ps(1.0f);
+		const __m128 Scale = _mm_set1_ps(255.0f);
+		const __m128i Alpha = _mm_set1_epi32(int32(0xFF000000));
+		auto Channel = [&](const float* Src)
+		{
+			// max(NaN, 0) returns 0
+			const __m128 V = _mm_min_ps(_mm_max_ps(_mm_add_ps(Half, _mm_mul_ps(C0, _mm_loadu_ps(Src + I))), Zero), One);
+			return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(V, Scale), Half));
+		};
+		for (; I + 4 <= Count; I += 4)
+		{
+			const __m128i Packed = _mm_or_si128(_mm_or_si128(Alpha, _mm_slli_epi32(Channel(R), 16)),
+			                                    _mm_or_si128(_mm_slli_epi32(Channel(G), 8), Channel(B)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Out + I), Packed);
+		}
+#endif
+
+		for (; I < Count; ++I)
+		{
+			Out[I] = FColor(
+				uint8(FMath::Clamp(0.5f + SH_C0 * R[I], 0.0f, 1.0f) * 255.0f + 0.5f),
+				uint8(FMath::Clamp(0.5f + SH_C0 * G[I], 0.0f, 1.0f) * 255.0f + 0.5f),
+				uint8(FMath::Clamp(0.5f + SH_C0 * B[I], 0.0f, 1.0f) * 255.0f + 0.5f),
+				255);
+		}
+	}
+
+	// red/green/blue properties: integer types are 0-255, float ones 0-1 unless a channel exceeds 1
+	FORCEINLINE static FColor RGBToColor(float R, float G, float B, bool bFloat)
+	{
+		const float Scale = (bFloat && R <= 1.0f && G <= 1.0f && B <= 1.0f) ? 255.0f : 1.0f;
+		return FColor(
+			uint8(FMath::Clamp(FMath::RoundToInt(R * Scale), 0, 255)),
+			uint8(FMath::Clamp(FMath::RoundToInt(G * Scale), 0, 255)),
+			uint8(FMath::Clamp(FMath::RoundToInt(B * Scale), 0, 255)),
+			255);
+	}
+
+	// Columns the reader needs from the vertex element
+	struct FColumns
+	{
+		int32 Pos[3] = { INDEX_NONE, INDEX_NONE, INDEX_NONE };
+		int32 DC[3] = { INDEX_NONE, INDEX_NONE, INDEX_NONE };
+		int32 RGB[3] = { INDEX_NONE, INDEX_NONE, INDEX_NONE };
+		bool bSH = false;
+		bool bRGB = false;
+		bool bFloatRGB = false;
+
+		explicit FColumns(const FElement& Vertex)
+		{
+			static const TCHAR* PosNames[3] = { TEXT("x"), TEXT("y"), TEXT("z") };
+			static const TCHAR* DCNames[3] = { TEXT("f_dc_0"), TEXT("f_dc_1"), TEXT("f_dc_2") };
+			static const TCHAR* RGBNames[3] = { TEXT("red"), TEXT("green"), TEXT("blue") };
+			for (int32 C = 0; C < 3; C++)
+			{
+				Pos[C] = Vertex.FindProperty(PosNames[C]);
+				DC[C] = Vertex.FindProperty(DCNames[C]);
+				RGB[C] = Vertex.FindProperty(RGBNames[C]);
+			}
+			bSH = DC[0] != INDEX_NONE && DC[1] != INDEX_NONE && DC[2] != INDEX_NONE;
+			bRGB = RGB[0] != INDEX_NONE && RGB[1] != INDEX_NONE && RGB[2] != INDEX_NONE;
+			bFloatRGB = bRGB && IsFloatType(Vertex.Properties[RGB[0]].Type);
+		}
+	};
+
+	static void SetNum(FSplatPlyPoints& Out, int32 Num)
+	{
+		Out.X.SetNumUninitialized(Num);
+		Out.Y.SetNumUninitialized(Num);
+		Out.Z.SetNumUninitialized(Num);
+		Out.Colors.SetNumUninitialized(Num);
+	}
+
+	static bool DecodeBinary(const uint8* Data, int64 Size, const FHeader& Header, int32 VertexElement, FSplatPlyPoints& Out)
+	{
+		// Vertex block offset: elements before it need a fixed stride
+		int64 Offset = Header.Size;
+		for (int32 E = 0; E < VertexElement; E++)
+		{
+			if (Header.Elements[E].bHasList)
+			{
+				if (debug) UE_LOG(LogTemp, Warning, TEXT("[SplatPlyReader] List element '%s' before the vertices"), *Header.Elements[E].Name);
+				return false;
+			}
+			Offset += Header.Elements[E].Count * Header.Elements[E].Stride;
+		}
+
+		const FElement& Vertex = Header.Elements[VertexElement];
+		if (Vertex.bHasList || Vertex.Stride <= 0 || Offset >= Size)
+		{
+			return false;
+		}
+
+		// Truncated files keep the complete vertices
+		const int32 Num = int32(FMath::Min<int64>(FMath::Min<int64>(Vertex.Count, (Size - Offset) / Vertex.Stride), MAX_int32));
+		SetNum(Out, Num);
+
+		const FColumns Columns(Vertex);
+		const bool bSwap = (Header.Format == EFormat::BinaryBigEndian) == bool(PLATFORM_LITTLE_ENDIAN);
+		const uint8* Base = Data + Offset;
+		const int32 Stride = Vertex.Stride;
+		auto Column = [&Vertex](int32 Index, int32& OutOffset, EType& OutType)
+		{
+			OutOffset = Index != INDEX_NONE ? Vertex.Properties[Index].Offset : 0;
+			OutType = Index != INDEX_NONE ? Vertex.Properties[Index].Type : EType::Invalid;
+		};
+		int32 PosOffset[3], DCOffset[3], RGBOffset[3];
+		EType PosType[3], DCType[3], RGBType[3];
+		for (int32 C = 0; C < 3; C++)
+		{
+			Column(Columns.Pos[C], PosOffset[C], PosType[C]);
+			Column(Columns.DC[C], DCOffset[C], DCType[C]);
+			Column(Columns.RGB[C], RGBOffset[C], RGBType[C]);
+		}
+
+		// Chunks of vertices; DC terms go through chunk-local SoA so the colour conversion runs 4 wide
+		constexpr int32 ChunkSize = 16384;
+		ParallelFor(FMath::DivideAndRoundUp(Num, ChunkSize), [&](int32 Chunk)
+		{
+			const int32 Begin = Chunk * ChunkSize;
+			const int32 End = FMath::Min(Begin + ChunkSize, Num);
+			TArray<float> DC[3];
+			if (Columns.bSH)
+			{
+				for (TArray<float>& Channel : DC)
+				{
+					Channel.SetNumUninitialized(End - Begin);
+				}
+			}
+
+			for (int32 i = Begin; i < End; i++)
+			{
+				const uint8* V = Base + int64(i) * Stride;
+				Out.X[i] = ReadScalar(V + PosOffset[0], PosType[0], bSwap);
+				Out.Y[i] = ReadScalar(V + PosOffset[1], PosType[1], bSwap);
+				Out.Z[i] = ReadScalar(V + PosOffset[2], PosType[2], bSwap);
+
+				if (Columns.bSH)
+				{
+					for (int32 C = 0; C < 3; C++)
+					{
+						DC[C][i - Begin] = ReadScalar(V + DCOffset[C], DCType[C], bSwap);
+					}
+				}
+				else if (Columns.bRGB)
+				{
+					Out.Colors[i] = RGBToColor(ReadScalar(V + RGBOffset[0], RGBType[0], bSwap), ReadScalar(V + RGBOffset[1], RGBType[1], bSwap),
+					                           ReadScalar(V + RGBOffset[2], RGBType[2], bSwap), Columns.bFloatRGB);
+				}
+				else
+				{
+					Out.Colors[i] = FColor::White;
+				}
+			}
+
+			if (Columns.bSH)
+			{
+				DCToColors(DC[0].GetData(), DC[1].GetData(), DC[2].GetData(), End - Begin, Out.Colors.GetData() + Begin);
+			}
+		});
+		return Num > 0;
+	}
+
+	// One line of whitespace separated values (bounded copy so mapped data needs no terminator)
+	static int32 ParseAsciiLine(const uint8* Line, int64 Length, TArray<float>& OutValues)
+	{
+		ANSICHAR Buffer[2048];
+		const int32 Len = int32(FMath::Min<int64>(Length, UE_ARRAY_COUNT(Buffer) - 1));
+		FMemory::Memcpy(Buffer, Line, Len);
+		Buffer[Len] = 0;
+
+		OutValues.Reset();
+		ANSICHAR* Cursor = Buffer;
+		while (*Cursor)
+		{
+			while (*Cursor == ' ' || *Cursor == '\t' || *Cursor == '\r')
+			{
+				Cursor++;
+			}
+			if (!*Cursor)
+			{
+				break;
+			}
+			ANSICHAR* Token = Cursor;
+			while (*Cursor && *Cursor != ' ' && *Cursor != '\t' && *Cursor != '\r')
+			{
+				Cursor++;
+			}
+			const bool bLast = !*Cursor;
+			*Cursor = 0;
+			OutValues.Add(FCStringAnsi::Atof(Token));
+			if (bLast)
+			{
+				break;
+			}
+			Cursor++;
+		}
+		return OutValues.Num();
+	}
+
+	static bool DecodeAscii(const uint8* Data, int64 Size, const FHeader& Header, int32 VertexElement, FSplatPlyPoints& Out)
+	{
+		int64 Cursor = Header.Size;
+		auto NextLine = [&](int64& OutStart, int64& OutLength) -> bool
+		{
+			if (Cursor >= Size)
+			{
+				return false;
+			}
+			OutStart = Cursor;
+			while (Cursor < Size && Data[Cursor] != '\n')
+			{
+				Cursor++;
+			}
+			OutLength = Cursor - OutStart;
+			Cursor++;
+			return true;
+		};
+
+		// One line per element entry before the vertices
+		int64 Start = 0, Length = 0;
+		for (int32 E = 0; E < VertexElement; E++)
+		{
+			for (int64 i = 0; i < Header.Elements[E].Count; i++)
+			{
+				if (!NextLine(Start, Length)) return false;
+			}
+		}
+
+		const FElement& Vertex = Header.Elements[VertexElement];
+		const FColumns Columns(Vertex);
+		const int32 Reserve = int32(FMath::Min<int64>(Vertex.Count, MAX_int32));
+		Out.X.Reserve(Reserve);
+		Out.Y.Reserve(Reserve);
+		Out.Z.Reserve(Reserve);
+		Out.Colors.Reserve(Reserve);
+
+		// Sequential: line starts are only known after the previous line
+		TArray<float> Values;
+		auto Value = [&Values](int32 Index) { return Values.IsValidIndex(Index) ? Values[Index] : 0.0f; };
+		for (int64 i = 0; i < Vertex.Count && NextLine(Start, Length); i++)
+		{
+			if (ParseAsciiLine(Data + Start, Length, Values) < 3)
+			{
+				continue;
+			}
+			Out.X.Add(Value(Columns.Pos[0] != INDEX_NONE ? Columns.Pos[0] : 0));
+			Out.Y.Add(Value(Columns.Pos[1] != INDEX_NONE ? Columns.Pos[1] : 1));
+			Out.Z.Add(Value(Columns.Pos[2] != INDEX_NONE ? Columns.Pos[2] : 2));
+			if (Columns.bSH)
+			{
+				const float DC[3] = { Value(Columns.DC[0]), Value(Columns.DC[1]), Value(Columns.DC[2]) };
+				DCToColors(&DC[0], &DC[1], &DC[2], 1, &Out.Colors.AddDefaulted_GetRef());
+			}
+			else if (Columns.bRGB)
+			{
+				Out.Colors.Add(RGBToColor(Value(Columns.RGB[0]), Value(Columns.RGB[1]), Value(Columns.RGB[2]), Columns.bFloatRGB));
+			}
+			else
+			{
+				Out.Colors.Add(FColor::White);
+			}
+		}
+		return Out.Num() > 0;
+	}
+}
+
+// ============================================================
+// FSplatPlyReader
+// ============================================================
+
+bool FSplatPlyReader::Read(const FString& Path, FSplatPlyPoints& Out)
+{
+	FSplatMappedFile File;
+	if (!File.Open(Path))
+	{
+		if (debug) UE_LOG(LogTemp, Warning, TEXT("[SplatPlyReader] Cannot open %s"), *Path);
+		return false;
+	}
+	return Read(File.GetData(), File.Num(), Out);
+}
+
+bool FSplatPlyReader::Read(const uint8* Data, int64 Size, FSplatPlyPoints& Out)
+{
+	using namespace SplatPly;
+
+	SetNum(Out, 0);
+	FHeader Header;
+	if (!Data || !ParseHeader(Data, Size, Header))
+	{
+		if (debug) UE_LOG(LogTemp, Warning, TEXT("[SplatPlyReader] Not a PLY file or header not terminated"));
+		return false;
+	}
+
+	const int32 VertexElement = Header.Elements.IndexOfByPredicate([](const FElement& E) { return E.Name == TEXT("vertex"); });
+	if (VertexElement == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const bool bRead = Header.Format == EFormat::Ascii
+		? DecodeAscii(Data, Size, Header, VertexElement, Out)
+		: DecodeBinary(Data, Size, Header, VertexElement, Out);
+
+	if (debug) UE_LOG(LogTemp, Display, TEXT("[SplatPlyReader] %d of %lld vertices (%d properties, stride %d) in %.1f ms"),
+		Out.Num(), Header.Elements[VertexElement].Count, Header.Elements[VertexElement].Properties.Num(),
+		Header.Elements[VertexElement].Stride, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return bRead;
+}
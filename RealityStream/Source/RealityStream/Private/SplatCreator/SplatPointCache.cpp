@@ -0,0 +1,147 @@
+#include "SplatCreator/SplatPointCache.h"
+#include "SplatCreator/SplatPlyReader.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Serialization/Archive.h"
+
+static bool debug = false;
+//Versioned binary cache of preprocessed splats next to their PLY files
+
+namespace SplatCache
+{
+	// Bump when the file layout, sampling or sphere sizing changes
+	static constexpr uint32 Magic = 0x434C5053; // "SPLC"
+	static constexpr uint32 Version = 2;
+
+	// 64 bytes, followed by Positions (float[3 * NumPoints]), Colors (FColor[NumPoints]), SphereSizes (float[NumPoints])
+	struct FHeader
+	{
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		int64 SourceSize = 0;
+		int64 SourceTicks = 0;
+		uint32 ParamsHash = 0;
+		int32 NumPoints = 0;
+		float BoundsMin[3] = { 0.0f, 0.0f, 0.0f };
+		float BoundsMax[3] = { 0.0f, 0.0f, 0.0f };
+		uint8 Reserved[8] = {};
+	};
+	static_assert(sizeof(FHeader) == 64, "Splat cache header layout changed - bump Version");
+
+	static int64 GetFileSize(int32 NumPoints)
+	{
+		return int64(sizeof(FHeader)) + int64(NumPoints) * (3 * sizeof(float) + sizeof(FColor) + sizeof(float));
+	}
+}
+
+FString FSplatPointCache::GetCachePath(const FString& PLYPath)
+{
+	return FPaths::ChangeExtension(PLYPath, TEXT("splatcache"));
+}
+
+bool FSplatPointCache::Load(const FString& PLYPath, int64 SourceSize, const FDateTime& SourceTimeStamp, uint32 ParamsHash, FSplatPreparedCloud& Out)
+{
+	using namespace SplatCache;
+
+	const FString CachePath = GetCachePath(PLYPath);
+	FSplatMappedFile File;
+	if (!File.Open(CachePath) || File.Num() < int64(sizeof(FHeader)))
+	{
+		return false;
+	}
+
+	FHeader Header;
+	FMemory::Memcpy(&Header, File.GetData(), sizeof(Header));
+	if (Header.Magic != Magic || Header.Version != Version || Header.ParamsHash != ParamsHash ||
+	    Header.SourceSize != SourceSize || Header.SourceTicks != SourceTimeStamp.GetTicks() ||
+	    Header.NumPoints <= 0 || File.Num() < GetFileSize(Header.NumPoints))
+	{
+		if (debug) UE_LOG(LogTemp, Display, TEXT("[SplatPointCache] Stale or foreign cache %s"), *CachePath);
+		return false;
+	}
+
+	const int32 Num = Header.NumPoints;
+	const uint8* Cursor = File.GetData() + sizeof(FHeader);
+	const float* Positions = reinterpret_cast<const float*>(Cursor);
+	Cursor += int64(Num) * 3 * sizeof(float);
+
+	Out.Positions.SetNumUninitialized(Num);
+	for (int32 i = 0; i < Num; i++)
+	{
+		Out.Positions[i] = FVector(Positions[i * 3], Positions[i * 3 + 1], Positions[i * 3 + 2]);
+	}
+	Out.Colors.SetNumUninitialized(Num);
+	FMemory::Memcpy(Out.Colors.GetData(), Cursor, int64(Num) * sizeof(FColor));
+	Cursor += int64(Num) * sizeof(FColor);
+	Out.SphereSizes.SetNumUninitialized(Num);
+	FMemory::Memcpy(Out.SphereSizes.GetData(), Cursor, int64(Num) * sizeof(float));
+
+	Out.Bounds = FBox(FVector(Header.BoundsMin[0], Header.BoundsMin[1], Header.BoundsMin[2]),
+	                  FVector(Header.BoundsMax[0], Header.BoundsMax[1], Header.BoundsMax[2]));
+	Out.SourceSize = SourceSize;
+	Out.SourceTimeStamp = SourceTimeStamp;
+	return true;
+}
+
+bool FSplatPointCache::Save(const FString& PLYPath, uint32 ParamsHash, const FSplatPreparedCloud& Cloud)
+{
+	using namespace SplatCache;
+
+	const int32 Num = Cloud.Positions.Num();
+	if (Num == 0 || Cloud.Colors.Num() != Num || Cloud.SphereSizes.Num() != Num)
+	{
+		return false;
+	}
+
+	FHeader Header;
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.SourceSize = Cloud.SourceSize;
+	Header.SourceTicks = Cloud.SourceTimeStamp.GetTicks();
+	Header.ParamsHash = ParamsHash;
+	Header.NumPoints = Num;
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		Header.BoundsMin[Axis] = float(Cloud.Bounds.Min[Axis]);
+		Header.BoundsMax[Axis] = float(Cloud.Bounds.Max[Axis]);
+	}
+
+	TArray<float> Positions;
+	Positions.SetNumUninitialized(Num * 3);
+	for (int32 i = 0; i < Num; i++)
+	{
+		Positions[i * 3] = float(Cloud.Positions[i].X);
+		Positions[i * 3 + 1] = float(Cloud.Positions[i].Y);
+		Positions[i * 3 + 2] = float(Cloud.Positions[i].Z);
+	}
+
+	// Unique temp name: two preparations of the same file may finish together
+	const FString CachePath = GetCachePath(PLYPath);
+	const FString TempPath = CachePath + FString::Printf(TEXT(".%s.tmp"), *FGuid::NewGuid().ToString());
+	{
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempPath));
+		if (!Writer)
+		{
+			if (debug) UE_LOG(LogTemp, Warning, TEXT("[SplatPointCache] Cannot write %s"), *TempPath);
+			return false;
+		}
+		Writer->Serialize(&Header, sizeof(Header));
+		Writer->Serialize(Positions.GetData(), Positions.Num() * sizeof(float));
+		Writer->Serialize(const_cast<FColor*>(Cloud.Colors.GetData()), Num * sizeof(FColor));
+		Writer->Serialize(const_cast<float*>(Cloud.SphereSizes.GetData()), Num * sizeof(float));
+		if (!Writer->Close() || Writer->IsError())
+		{
+			Writer.Reset();
+			IFileManager::Get().Delete(*TempPath, false, false, true);
+			return false;
+		}
+	}
+
+	const bool bMoved = IFileManager::Get().Move(*CachePath, *TempPath, true, true, false, true);
+	if (!bMoved)
+	{
+		IFileManager::Get().Delete(*TempPath, false, false, true);
+	}
+	if (debug) UE_LOG(LogTemp, Display, TEXT("[SplatPointCache] %s %s (%d points)"), bMoved ? TEXT("Wrote") : TEXT("Failed to write"), *CachePath, Num);
+	return bMoved;
+}
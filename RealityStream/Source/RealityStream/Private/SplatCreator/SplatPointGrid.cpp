@@ -0,0 +1,212 @@
+#include "SplatCreator/SplatPointGrid.h"
+#include "Async/ParallelFor.h"
+
+static bool debug = false;
+//Uniform grid k-nearest-neighbour search over splat points
+
+void FSplatPointGrid::Build(const TArray<FVector>& Points, float PointsPerCell)
+{
+	const int32 NumPoints = Points.Num();
+	SortedPoints.Reset();
+	SortedIndex.Reset();
+	CellStart.Reset();
+	if (NumPoints == 0)
+	{
+		Dims = FIntVector(1, 1, 1);
+		CellStart.Init(0, 2);
+		return;
+	}
+
+	// Bounds (per chunk, then merged)
+	constexpr int32 ChunkSize = 65536;
+	const int32 NumChunks = FMath::DivideAndRoundUp(NumPoints, ChunkSize);
+	TArray<FBox3f> ChunkBounds;
+	ChunkBounds.Init(FBox3f(ForceInit), NumChunks);
+	ParallelFor(NumChunks, [&](int32 Chunk)
+	{
+		const int32 End = FMath::Min((Chunk + 1) * ChunkSize, NumPoints);
+		for (int32 i = Chunk * ChunkSize; i < End; i++)
+		{
+			ChunkBounds[Chunk] += FVector3f(Points[i]);
+		}
+	});
+	FBox3f Bounds(ForceInit);
+	for (const FBox3f& Box : ChunkBounds)
+	{
+		Bounds += Box;
+	}
+
+	// Cell size for about NumPoints / PointsPerCell cells; bisection because flat clouds collapse an axis to one cell
+	const FVector3f Extent = Bounds.GetSize();
+	const double TargetCells = FMath::Max(1.0, NumPoints / FMath::Max(PointsPerCell, 0.1f));
+	auto CountCells = [&Extent](double Size)
+	{
+		return FMath::Max(1.0, FMath::CeilToDouble(Extent.X / Size)) * FMath::Max(1.0, FMath::CeilToDouble(Extent.Y / Size)) *
+		       FMath::Max(1.0, FMath::CeilToDouble(Extent.Z / Size));
+	};
+	double Lo = FMath::Max(double(Extent.GetMax()) * 1e-6, 1e-6);
+	double Hi = FMath::Max(double(Extent.GetMax()), 1e-6) * 2.0;
+	for (int32 Iteration = 0; Iteration < 48; Iteration++)
+	{
+		const double Mid = FMath::Sqrt(Lo * Hi);
+		(CountCells(Mid) > TargetCells ? Lo : Hi) = Mid;
+	}
+	CellSize = float(Hi);
+	InvCellSize = 1.0f / CellSize;
+	Origin = Bounds.Min;
+	Dims = FIntVector(
+		FMath::Max(1, FMath::CeilToInt32(Extent.X * InvCellSize)),
+		FMath::Max(1, FMath::CeilToInt32(Extent.Y * InvCellSize)),
+		FMath::Max(1, FMath::CeilToInt32(Extent.Z * InvCellSize)));
+	const int32 NumCells = Dims.X * Dims.Y * Dims.Z;
+
+	// Cell keys in parallel
+	TArray<int32> PointCell;
+	PointCell.SetNumUninitialized(NumPoints);
+	ParallelFor(NumChunks, [&](int32 Chunk)
+	{
+		const int32 End = FMath::Min((Chunk + 1) * ChunkSize, NumPoints);
+		for (int32 i = Chunk * ChunkSize; i < End; i++)
+		{
+			const FIntVector C = CellOf(FVector3f(Points[i]));
+			PointCell[i] = CellIndex(C.X, C.Y, C.Z);
+		}
+	});
+
+	// Counting sort (linear, memory bound)
+	CellStart.SetNumZeroed(NumCells + 1);
+	for (int32 Cell : PointCell)
+	{
+		CellStart[Cell + 1]++;
+	}
+	for (int32 c = 0; c < NumCells; c++)
+	{
+		CellStart[c + 1] += CellStart[c];
+	}
+	TArray<int32> Cursor(CellStart.GetData(), NumCells);
+	SortedPoints.SetNumUninitialized(NumPoints);
+	SortedIndex.SetNumUninitialized(NumPoints);
+	for (int32 i = 0; i < NumPoints; i++)
+	{
+		const int32 Slot = Cursor[PointCell[i]]++;
+		SortedPoints[Slot] = FVector3f(Points[i]);
+		SortedIndex[Slot] = i;
+	}
+
+	if (debug) UE_LOG(LogTemp, Display, TEXT("[SplatPointGrid] %d points in %dx%dx%d cells of %.2f"), NumPoints, Dims.X, Dims.Y, Dims.Z, CellSize);
+}
+
+FIntVector FSplatPointGrid::CellOf(const FVector3f& P) const
+{
+	return FIntVector(
+		FMath::Clamp(FMath::FloorToInt32((P.X - Origin.X) * InvCellSize), 0, Dims.X - 1),
+		FMath::Clamp(FMath::FloorToInt32((P.Y - Origin.Y) * InvCellSize), 0, Dims.Y - 1),
+		FMath::Clamp(FMath::FloorToInt32((P.Z - Origin.Z) * InvCellSize), 0, Dims.Z - 1));
+}
+
+int32 FSplatPointGrid::FindKNearest(const FVector3f& Query, int32 K, int32 ExcludeIndex, float* OutDistSq, int32* OutIndices) const
+{
+	K = FMath::Clamp(K, 1, MaxNeighbours);
+	if (SortedPoints.Num() == 0)
+	{
+		return 0;
+	}
+
+	int32 Found = 0;
+	auto ScanCell = [&](int32 Cell)
+	{
+		for (int32 s = CellStart[Cell]; s < CellStart[Cell + 1]; s++)
+		{
+			const float DistSq = FVector3f::DistSquared(Query, SortedPoints[s]);
+			if ((Found == K && DistSq >= OutDistSq[K - 1]) || SortedIndex[s] == ExcludeIndex)
+			{
+				continue;
+			}
+
+			// Insertion into the ascending list (K is small)
+			int32 Pos = Found < K ? Found++ : K - 1;
+			while (Pos > 0 && OutDistSq[Pos - 1] > DistSq)
+			{
+				OutDistSq[Pos] = OutDistSq[Pos - 1];
+				if (OutIndices) OutIndices[Pos] = OutIndices[Pos - 1];
+				Pos--;
+			}
+			OutDistSq[Pos] = DistSq;
+			if (OutIndices) OutIndices[Pos] = SortedIndex[s];
+		}
+	};
+
+	const FIntVector C = CellOf(Query);
+	const int32 MaxRing = FMath::Max3(Dims.X, Dims.Y, Dims.Z);
+	for (int32 R = 0; R <= MaxRing; R++)
+	{
+		// Shell of Chebyshev radius R around C, clipped to the grid
+		const int32 Z0 = FMath::Max(C.Z - R, 0), Z1 = FMath::Min(C.Z + R, Dims.Z - 1);
+		const int32 Y0 = FMath::Max(C.Y - R, 0), Y1 = FMath::Min(C.Y + R, Dims.Y - 1);
+		const int32 X0 = FMath::Max(C.X - R, 0), X1 = FMath::Min(C.X + R, Dims.X - 1);
+		for (int32 Z = Z0; Z <= Z1; Z++)
+		{
+			for (int32 Y = Y0; Y <= Y1; Y++)
+			{
+				if (FMath::Abs(Z - C.Z) == R || FMath::Abs(Y - C.Y) == R)
+				{
+					for (int32 X = X0; X <= X1; X++)
+					{
+						ScanCell(CellIndex(X, Y, Z));
+					}
+				}
+				else
+				{
+					if (C.X - R >= 0) ScanCell(CellIndex(C.X - R, Y, Z));
+					if (R > 0 && C.X + R < Dims.X) ScanCell(CellIndex(C.X + R, Y, Z));
+				}
+			}
+		}
+
+		// Distance from the query to the nearest face of the visited block that still has cells beyond it
+		float Reach = MAX_flt;
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			if (C[Axis] - R > 0)
+			{
+				Reach = FMath::Min(Reach, Query[Axis] - (Origin[Axis] + (C[Axis] - R) * CellSize));
+			}
+			if (C[Axis] + R < Dims[Axis] - 1)
+			{
+				Reach = FMath::Min(Reach, Origin[Axis] + (C[Axis] + R + 1) * CellSize - Query[Axis]);
+			}
+		}
+		if (Reach == MAX_flt || (Found == K && OutDistSq[K - 1] <= FMath::Square(FMath::Max(Reach, 0.0f))))
+		{
+			break;
+		}
+	}
+	return Found;
+}
+
+void FSplatPointGrid::ComputeMeanNeighbourDistances(const TArray<FVector>& Points, int32 K, TArray<float>& OutDistances)
+{
+	FSplatPointGrid Grid;
+	Grid.Build(Points);
+	OutDistances.SetNumUninitialized(Points.Num());
+
+	// Queries in cell order, so neighbouring queries touch the same cells
+	constexpr int32 ChunkSize = 4096;
+	K = FMath::Clamp(K, 1, MaxNeighbours);
+	ParallelFor(FMath::DivideAndRoundUp(Grid.Num(), ChunkSize), [&](int32 Chunk)
+	{
+		float DistSq[MaxNeighbours];
+		const int32 End = FMath::Min((Chunk + 1) * ChunkSize, Grid.Num());
+		for (int32 s = Chunk * ChunkSize; s < End; s++)
+		{
+			const int32 Index = Grid.SortedIndex[s];
+			const int32 Found = Grid.FindKNearest(Grid.SortedPoints[s], K, Index, DistSq);
+			float Sum = 0.0f;
+			for (int32 n = 0; n < Found; n++)
+			{
+				Sum += FMath::Sqrt(DistSq[n]);
+			}
+			OutDistances[Index] = Found > 0 ? Sum / Found : MAX_flt;
+		}
+	});
+}
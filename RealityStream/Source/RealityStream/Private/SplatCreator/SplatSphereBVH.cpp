@@ -0,0 +1,211 @@
+#include "SplatCreator/SplatSphereBVH.h"
+#include "Algo/Sort.h"
+#include "Async/ParallelFor.h"
+
+static bool debug = false;
+//Linear BVH over splat spheres for ray picking
+
+static constexpr int32 MaxLeafSpheres = 4;
+
+// 10 bits per axis interleaved into 30
+static uint32 ExpandBits(uint32 V)
+{
+	V = (V * 0x00010001u) & 0xFF0000FFu;
+	V = (V * 0x00000101u) & 0x0F00F00Fu;
+	V = (V * 0x00000011u) & 0xC30C30C3u;
+	V = (V * 0x00000005u) & 0x49249249u;
+	return V;
+}
+
+void FSplatSphereBVH::Build(const TArray<FVector>& Centers, const TArray<float>& Radii, float PositionScale, float RadiusScale)
+{
+	Nodes.Reset();
+	Spheres.Reset();
+	SphereIndex.Reset();
+	const int32 NumSpheres = FMath::Min(Centers.Num(), Radii.Num());
+	if (NumSpheres == 0)
+	{
+		return;
+	}
+
+	Spheres.SetNumUninitialized(NumSpheres);
+	FBox3f CentreBounds(ForceInit);
+	for (int32 i = 0; i < NumSpheres; i++)
+	{
+		const FVector3f Centre(Centers[i] * PositionScale);
+		Spheres[i] = FVector4f(Centre, Radii[i] * RadiusScale);
+		CentreBounds += Centre;
+	}
+
+	// Morton keys (code in the high half, sphere in the low half) in parallel, then one sort
+	const FVector3f Extent = CentreBounds.GetSize();
+	const FVector3f ToGrid(
+		Extent.X > 0.0f ? 1023.0f / Extent.X : 0.0f,
+		Extent.Y > 0.0f ? 1023.0f / Extent.Y : 0.0f,
+		Extent.Z > 0.0f ? 1023.0f / Extent.Z : 0.0f);
+	TArray<uint64> Keys;
+	Keys.SetNumUninitialized(NumSpheres);
+	ParallelFor(NumSpheres, [&](int32 i)
+	{
+		const FVector3f Grid = (FVector3f(Spheres[i]) - CentreBounds.Min) * ToGrid;
+		const uint32 Code = (ExpandBits(FMath::Min(uint32(Grid.X), 1023u)) << 2) | (ExpandBits(FMath::Min(uint32(Grid.Y), 1023u)) << 1) |
+		                    ExpandBits(FMath::Min(uint32(Grid.Z), 1023u));
+		Keys[i] = (uint64(Code) << 32) | uint32(i);
+	});
+	Algo::Sort(Keys);
+
+	// Spheres in leaf order
+	TArray<FVector4f> Unsorted = MoveTemp(Spheres);
+	Spheres.SetNumUninitialized(NumSpheres);
+	SphereIndex.SetNumUninitialized(NumSpheres);
+	for (int32 i = 0; i < NumSpheres; i++)
+	{
+		const int32 Index = int32(Keys[i] & 0xFFFFFFFFu);
+		Spheres[i] = Unsorted[Index];
+		SphereIndex[i] = Index;
+	}
+
+	Nodes.Reserve(FMath::Max(1, 4 * NumSpheres / MaxLeafSpheres));
+	Nodes.AddDefaulted();
+	BuildNode(0, 0, NumSpheres, Keys);
+
+	if (debug) UE_LOG(LogTemp, Display, TEXT("[SplatSphereBVH] %d spheres, %d nodes"), NumSpheres, Nodes.Num());
+}
+
+void FSplatSphereBVH::BuildNode(int32 NodeIndex, int32 Begin, int32 End, const TArray<uint64>& Keys)
+{
+	if (End - Begin <= MaxLeafSpheres)
+	{
+		FBox3f Bounds(ForceInit);
+		for (int32 i = Begin; i < End; i++)
+		{
+			const FVector3f Centre(Spheres[i]);
+			Bounds += Centre - FVector3f(Spheres[i].W);
+			Bounds += Centre + FVector3f(Spheres[i].W);
+		}
+		Nodes[NodeIndex].Min = Bounds.Min;
+		Nodes[NodeIndex].Max = Bounds.Max;
+		Nodes[NodeIndex].Start = Begin;
+		Nodes[NodeIndex].Count = End - Begin;
+		return;
+	}
+
+	// Split after the last key sharing more leading bits with the first than the last one does
+	auto CodeAt = [&Keys](int32 i) { return uint32(Keys[i] >> 32); };
+	const uint32 First = CodeAt(Begin);
+	const uint32 Last = CodeAt(End - 1);
+	int32 Split;
+	if (First == Last)
+	{
+		Split = (Begin + End) / 2;
+	}
+	else
+	{
+		const uint32 CommonPrefix = FMath::CountLeadingZeros(First ^ Last);
+		int32 LastLeft = Begin;
+		int32 Step = End - 1 - Begin;
+		do
+		{
+			Step = (Step + 1) >> 1;
+			const int32 Candidate = LastLeft + Step;
+			if (Candidate < End - 1 && FMath::CountLeadingZeros(First ^ CodeAt(Candidate)) > CommonPrefix)
+			{
+				LastLeft = Candidate;
+			}
+		}
+		while (Step > 1);
+		Split = LastLeft + 1;
+	}
+
+	const int32 Left = Nodes.AddDefaulted(2);
+	BuildNode(Left, Begin, Split, Keys);
+	BuildNode(Left + 1, Split, End, Keys);
+
+	FNode& Node = Nodes[NodeIndex];
+	Node.Min = Nodes[Left].Min.ComponentMin(Nodes[Left + 1].Min);
+	Node.Max = Nodes[Left].Max.ComponentMax(Nodes[Left + 1].Max);
+	Node.Start = Left;
+	Node.Count = 0;
+}
+
+void FSplatSphereBVH::Raycast(const FVector3f& Origin, const FVector3f& Direction, float MaxT, float Inflate, TFunctionRef<float(int32, float)> Visit) const
+{
+	if (!IsValid())
+	{
+		return;
+	}
+
+	const FVector3f InvDirection(
+		Direction.X != 0.0f ? 1.0f / Direction.X : BIG_NUMBER,
+		Direction.Y != 0.0f ? 1.0f / Direction.Y : BIG_NUMBER,
+		Direction.Z != 0.0f ? 1.0f / Direction.Z : BIG_NUMBER);
+	const float DirectionSq = Direction.SizeSquared();
+	if (DirectionSq <= 0.0f)
+	{
+		return;
+	}
+
+	// Entry t of the ray into a node box grown by Inflate; MAX_flt on a miss
+	auto EnterNode = [&](const FNode& Node)
+	{
+		const FVector3f T0 = (Node.Min - FVector3f(Inflate) - Origin) * InvDirection;
+		const FVector3f T1 = (Node.Max + FVector3f(Inflate) - Origin) * InvDirection;
+		const float Enter = FMath::Max(FMath::Max3(FMath::Min(T0.X, T1.X), FMath::Min(T0.Y, T1.Y), FMath::Min(T0.Z, T1.Z)), 0.0f);
+		const float Exit = FMath::Min(FMath::Min3(FMath::Max(T0.X, T1.X), FMath::Max(T0.Y, T1.Y), FMath::Max(T0.Z, T1.Z)), MaxT);
+		return Enter <= Exit ? Enter : MAX_flt;
+	};
+
+	TArray<TPair<int32, float>, TInlineAllocator<64>> Stack;
+	const float RootEnter = EnterNode(Nodes[0]);
+	if (RootEnter != MAX_flt)
+	{
+		Stack.Emplace(0, RootEnter);
+	}
+	while (Stack.Num() > 0)
+	{
+		const TPair<int32, float> Entry = Stack.Pop(EAllowShrinking::No);
+		if (Entry.Value > MaxT)
+		{
+			continue;
+		}
+
+		const FNode& Node = Nodes[Entry.Key];
+		if (Node.Count > 0)
+		{
+			for (int32 s = Node.Start; s < Node.Start + Node.Count; s++)
+			{
+				// Grown sphere test: |Origin + t * Direction - Centre| <= Radius + Inflate for some t in [0, MaxT]
+				const FVector3f ToOrigin = Origin - FVector3f(Spheres[s]);
+				const float Radius = Spheres[s].W + Inflate;
+				const float B = FVector3f::DotProduct(ToOrigin, Direction);
+				const float Discriminant = B * B - DirectionSq * (ToOrigin.SizeSquared() - Radius * Radius);
+				if (Discriminant < 0.0f)
+				{
+					continue;
+				}
+				const float Root = FMath::Sqrt(Discriminant);
+				if ((-B + Root) < 0.0f || (-B - Root) > MaxT * DirectionSq)
+				{
+					continue;
+				}
+				MaxT = Visit(SphereIndex[s], MaxT);
+			}
+			continue;
+		}
+
+		// Nearer child popped first
+		const float LeftEnter = EnterNode(Nodes[Node.Start]);
+		const float RightEnter = EnterNode(Nodes[Node.Start + 1]);
+		const bool bLeftFirst = LeftEnter <= RightEnter;
+		const float FarEnter = bLeftFirst ? RightEnter : LeftEnter;
+		const float NearEnter = bLeftFirst ? LeftEnter : RightEnter;
+		if (FarEnter != MAX_flt)
+		{
+			Stack.Emplace(bLeftFirst ? Node.Start + 1 : Node.Start, FarEnter);
+		}
+		if (NearEnter != MAX_flt)
+		{
+			Stack.Emplace(bLeftFirst ? Node.Start : Node.Start + 1, NearEnter);
+		}
+	}
+}
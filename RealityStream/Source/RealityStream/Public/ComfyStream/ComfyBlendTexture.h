@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/Texture2D.h"
+#include "ComfyPngDecoder.h"
+#include "ComfyBlendTexture.generated.h"
+
+// Two persistent textures for one channel of a CPU-blended frame, written alternately.
+// The texture currently bound to materials is never written; the other one receives the next blend.
+USTRUCT()
+struct REALITYSTREAM_API FComfyBlendTexture
+{
+	GENERATED_BODY()
+
+	// Blends mip 0 of A and B at Weight (0 = A, 256 = B) into the next texture and returns it (game thread only).
+	// Null when A and B differ in size or format. Recreates the texture when the layout changed.
+	UTexture2D* Blend(const FComfyDecodedImage& A, const FComfyDecodedImage& B, int32 Weight);
+
+	// Fills the next texture through Fill (Width * Height * bytes-per-pixel bytes) and returns it (game thread only)
+	UTexture2D* Write(int32 Width, int32 Height, EPixelFormat Format, TFunctionRef<void(uint8*)> Fill);
+
+	void Reset();
+
+	// (A * (256 - Weight) + B * Weight + 128) >> 8 per 8-bit channel (SSE2), 16-bit samples in 32-bit fixed point.
+	// Rows are processed in parallel.
+	static void BlendPixels(const FComfyDecodedImage& A, const FComfyDecodedImage& B, int32 Weight, uint8* Dst);
+
+private:
+	UPROPERTY()
+	TObjectPtr<UTexture2D> Textures[2];
+
+	int32 Current = INDEX_NONE;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/Texture2D.h"
+#include "ComfyFrameIngest.h"
+#include "ComfyFrameBundle.h"
+#include "ComfyDeltaTexture.generated.h"
+
+// Ring of persistent textures for one stream channel, written with only the tiles that changed.
+// A texture is rewritten only once no frame holds its lease any more (displayed, queued for interpolation,
+// kept as history), so retained frames keep their pixels; each texture is diffed against the content it holds.
+USTRUCT()
+struct REALITYSTREAM_API FComfyDeltaTexture
+{
+	GENERATED_BODY()
+
+	// Textures kept per channel; when every one of them is still held, frames get a standalone full upload
+	static constexpr int32 MaxTextures = 8;
+
+	// Writes Image into a free ring texture and returns it with the lease frames must hold (game thread only).
+	// Recreates the texture with a full upload when size, format or mip count changed.
+	// The image stays referenced until the render thread has copied the dirty regions.
+	UTexture2D* Upload(const FComfyImageRef& Image, const FComfyTileHashes& Tiles,
+	                   FComfyTextureLeaseRef& OutLease, int32& OutTilesUploaded, int32& OutTilesTotal);
+
+	void Reset();
+
+private:
+	UPROPERTY()
+	TArray<TObjectPtr<UTexture2D>> Textures;
+
+	// Per ring slot: tile hashes of the content the texture holds, the lease handed to frames
+	// (free again when only the ring references it) and when it was last written
+	TArray<FComfyTileHashes> TextureTiles;
+	TArray<FComfyTextureLeaseRef> Leases;
+	TArray<uint64> LastWritten;
+	uint64 UploadCounter = 0;
+
+	static bool LayoutMatches(UTexture2D* Texture, const FComfyDecodedImage& Image);
+
+	// Enqueues region updates for the dirty tiles of every mip and mirrors them into the CPU bulk data
+	static void UploadDirtyTiles(UTexture2D* Texture, const FComfyImageRef& Image, int32 TileSize, int32 TilesX, int32 TilesY, const TBitArray<>& Dirty);
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ComfyFrameBundle.h"
+
+// Pinhole intrinsics and grid options for unprojecting a streamed depth map
+struct REALITYSTREAM_API FComfyDepthMeshSettings
+{
+	// Focal length in full-frame widths (UComfyStreamComponent::FocalScale)
+	float FocalScale = 1.2f;
+
+	// Distance covered by the full depth range (UComfyStreamComponent::DepthScaleUnits); bright = near
+	float DepthScaleUnits = 500.0f;
+
+	// Distance of the nearest depth value from the camera; it ends up on the mesh's Z = 0 plane
+	float NearDistance = 100.0f;
+
+	// Depth pixels between grid points
+	int32 GridStep = 4;
+
+	// Mask values above this are part of the mesh (0..255)
+	uint8 MaskThreshold = 8;
+
+	// Cells whose corner depths differ by more than this fraction of the range are dropped (silhouettes, occlusions)
+	float DepthEdgeThreshold = 0.05f;
+
+	// ROI of cropped frames, so the principal point stays at the centre of the full frame
+	FVector2D RoiOffset = FVector2D::ZeroVector;
+	FVector2D RoiScale = FVector2D(1.0, 1.0);
+};
+
+// Unprojected grid points of one depth frame (SoA, GridX * GridY, row-major)
+struct REALITYSTREAM_API FComfyDepthGrid
+{
+	int32 GridX = 0;
+	int32 GridY = 0;
+
+	// Depth pixels between grid points
+	int32 Step = 1;
+
+	// Sampled depth (0..1), inside the mask, position in mesh space
+	TArray<float> Depth;
+	TArray<uint8> Inside;
+	TArray<float> PointX;
+	TArray<float> PointY;
+	TArray<float> PointZ;
+};
+
+// Procedural mesh section data, reused from frame to frame.
+// Every grid cell owns four vertices and two triangles, so the index buffer only changes with the grid size;
+// cells outside the mask or across a depth edge are collapsed to a point (degenerate triangles).
+struct REALITYSTREAM_API FComfyDepthMeshBuffers
+{
+	// Grid, grid step and depth size Triangles/UV0 were built for
+	int32 GridX = 0;
+	int32 GridY = 0;
+	int32 GridStep = 0;
+	FIntPoint DepthSize = FIntPoint::ZeroValue;
+
+	TArray<FVector> Vertices;
+	TArray<FVector> Normals;
+	TArray<FVector2D> UV0;
+	TArray<int32> Triangles;
+
+	// Cells that produced geometry in the last build
+	int32 NumValidCells = 0;
+
+	// Set when Triangles/UV0 were rebuilt (the section must be recreated instead of updated)
+	bool bTopologyChanged = false;
+
+	// Per grid point scratch
+	FComfyDepthGrid Grid;
+	TArray<FVector3f> PointNormals;
+};
+
+// Depth-to-geometry reconstruction for streamed frames (CPU pixels only, safe on the thread pool)
+class REALITYSTREAM_API FComfyDepthMesh
+{
+public:
+	// Samples Depth (and Mask) every Settings.GridStep pixels and unprojects the grid points (SSE2, grid rows in parallel).
+	// Mesh space: X follows U, Y follows V, Z points at the camera (nearest depth at Z = 0). False for invalid depth.
+	static bool UnprojectGrid(const FComfyPixelView& Depth, const FComfyPixelView& Mask, const FComfyDepthMeshSettings& Settings, FComfyDepthGrid& Grid);
+
+	// Mesh over UnprojectGrid's points with smooth normals. Mask may be invalid (everything is kept) or of another
+	// resolution; UVs are those of the depth texture. False when no cell is inside the mask.
+	static bool Build(const FComfyPixelView& Depth, const FComfyPixelView& Mask, const FComfyDepthMeshSettings& Settings, FComfyDepthMeshBuffers& Buffers);
+
+private:
+	// Rebuilds UVs and the fixed triangle list for a GridX x GridY grid
+	static void BuildTopology(int32 Width, int32 Height, FComfyDepthMeshBuffers& Buffers);
+};
@@ -1,7 +1,92 @@
 #pragma once
 #include "Engine/Texture2D.h"
+#include "ComfyPngDecoder.h"
+#include "ComfyStreamTypes.h"
 #include "ComfyFrameBundle.generated.h"
 
+// Held by every copy of a frame whose textures live in a delta upload ring (FComfyDeltaTexture):
+// the ring only rewrites a texture once no frame references it any more
+struct FComfyTextureLease {};
+using FComfyTextureLeaseRef = TSharedPtr<FComfyTextureLease, ESPMode::ThreadSafe>;
+
+// Read-only view of one channel's CPU pixels. Holds a reference to the shared decoded image,
+// so it stays valid after the frame and its textures are gone. No texture data is locked.
+struct FComfyPixelView
+{
+    FComfyPixelView() = default;
+    explicit FComfyPixelView(FComfyImageRef InImage, int32 InComponentOffset = 0)
+        : Image(MoveTemp(InImage)), ComponentOffset(InComponentOffset) {}
+
+    FComfyImageRef Image;
+
+    // Byte within a pixel that GetValue reads (3 = alpha of a mask packed into RGB)
+    int32 ComponentOffset = 0;
+
+    bool IsValid() const { return Image.IsValid() && Image->IsValid(); }
+    int32 GetWidth() const { return Image ? Image->Width : 0; }
+    int32 GetHeight() const { return Image ? Image->Height : 0; }
+    EPixelFormat GetFormat() const { return Image ? Image->Format : PF_Unknown; }
+    int32 GetBytesPerPixel() const { return Image ? Image->GetBytesPerPixel() : 0; }
+    int32 GetRowPitch() const { return GetWidth() * GetBytesPerPixel(); }
+    int32 GetNumMips() const { return Image ? Image->GetNumMips() : 0; }
+
+    // Tightly packed rows of the mip level (level N is max(1, Width >> N) wide)
+    TConstArrayView<uint8> GetPixels(int32 Mip = 0) const
+    {
+        if (!Image)
+        {
+            return TConstArrayView<uint8>();
+        }
+        if (Mip == 0)
+        {
+            return Image->Pixels;
+        }
+        return Image->Mips.IsValidIndex(Mip - 1) ? TConstArrayView<uint8>(Image->Mips[Mip - 1]) : TConstArrayView<uint8>();
+    }
+
+    // Row Y of mip 0 (no bounds check)
+    const uint8* GetRow(int32 Y) const
+    {
+        return Image->Pixels.GetData() + int64(Y) * GetRowPitch();
+    }
+
+    // Mask/depth value at a mip 0 pixel in 0..1 (G16 reads all 16 bits), coordinates clamped to the image
+    float GetValue(int32 X, int32 Y) const
+    {
+        if (!IsValid())
+        {
+            return 0.0f;
+        }
+        const uint8* Pixel = GetRow(FMath::Clamp(Y, 0, Image->Height - 1)) + FMath::Clamp(X, 0, Image->Width - 1) * GetBytesPerPixel();
+        if (Image->Format == PF_G16)
+        {
+            return *reinterpret_cast<const uint16*>(Pixel) / 65535.0f;
+        }
+        return Pixel[ComponentOffset] / 255.0f;
+    }
+
+    // Pixel as stored, in 0..1 (single-channel formats repeat the value, R8G8 normals have B = 0)
+    FLinearColor GetColor(int32 X, int32 Y) const
+    {
+        if (!IsValid())
+        {
+            return FLinearColor::Transparent;
+        }
+        const uint8* Pixel = GetRow(FMath::Clamp(Y, 0, Image->Height - 1)) + FMath::Clamp(X, 0, Image->Width - 1) * GetBytesPerPixel();
+        switch (Image->Format)
+        {
+        case PF_R8G8B8A8:   return FLinearColor(Pixel[0] / 255.0f, Pixel[1] / 255.0f, Pixel[2] / 255.0f, Pixel[3] / 255.0f);
+        case PF_B8G8R8A8:   return FLinearColor(Pixel[2] / 255.0f, Pixel[1] / 255.0f, Pixel[0] / 255.0f, Pixel[3] / 255.0f);
+        case PF_R8G8:       return FLinearColor(Pixel[0] / 255.0f, Pixel[1] / 255.0f, 0.0f, 1.0f);
+        default:
+        {
+            const float Value = GetValue(X, Y);
+            return FLinearColor(Value, Value, Value, 1.0f);
+        }
+        }
+    }
+};
+
 //The Blueprint stuct for RGB, Depth, and Mask Maps
 USTRUCT(BlueprintType)
 struct FComfyFrame
@@ -12,6 +97,34 @@ struct FComfyFrame
     UPROPERTY() UTexture2D* Depth = nullptr;
     UPROPERTY() UTexture2D* Mask = nullptr;
 
+    // Optional R8G8 normal map computed from Depth on ingest (X, Y encoded as n * 0.5 + 0.5)
+    UPROPERTY() UTexture2D* Normal = nullptr;
+
+    // Ingest sequence number of the fetcher (gaps mean frames were dropped while the worker was busy)
+    UPROPERTY() int32 FrameNumber = 0;
+
+    // Delta upload ring slots the textures occupy (empty for standalone textures)
+    TArray<FComfyTextureLeaseRef, TInlineAllocator<4>> TextureLeases;
+
+    // CPU pixels behind the textures (shared, never modified) - CPU blending reads these instead of locking texture data.
+    // Packed frames share one image for RGB and Mask. Empty for frames that did not come from the ingest stage.
+    FComfyImageRef RGBPixels;
+    FComfyImageRef DepthPixels;
+    FComfyImageRef MaskPixels;
+    FComfyImageRef NormalPixels;
+
+    // Region of the full ComfyUI frame the textures cover, in UV (cropped frames from the ingest stage)
+    UPROPERTY() FVector2D RoiOffset = FVector2D::ZeroVector;
+    UPROPERTY() FVector2D RoiScale = FVector2D(1.0, 1.0);
+
+    // Presentation clock (FPlatformTime seconds): when the ingest stage delivered the frame,
+    // and when the receiving actor's jitter buffer shows it (0 = not scheduled)
+    UPROPERTY() double ArrivalTime = 0.0;
+    UPROPERTY() double PresentationTime = 0.0;
+
+    // Subject bounds, centroid, orientation and mean depth from the ingest stage
+    UPROPERTY(BlueprintReadOnly, Category = "ComfyStream") FComfyMaskAnalytics Analytics;
+
     bool IsComplete() const
     {
         // Frame is complete if we have RGB and Mask (Depth is optional)
@@ -23,4 +136,36 @@ struct FComfyFrame
     {
         return IsValid(Depth);
     }
+
+    bool HasNormal() const
+    {
+        return IsValid(Normal);
+    }
+
+    bool HasRoi() const
+    {
+        return !RoiOffset.IsZero() || RoiScale != FVector2D(1.0, 1.0);
+    }
+
+    // Mask stored in RGB.A (ingest packing) - Mask points at the RGB texture
+    bool IsMaskPacked() const
+    {
+        return RGB != nullptr && Mask == RGB;
+    }
+
+    // CPU pixel views (invalid for frames without CPU pixels); a packed mask reads the RGB alpha byte
+    FComfyPixelView GetRGBView() const { return FComfyPixelView(RGBPixels); }
+    FComfyPixelView GetDepthView() const { return FComfyPixelView(DepthPixels); }
+    FComfyPixelView GetNormalView() const { return FComfyPixelView(NormalPixels); }
+    FComfyPixelView GetMaskView() const
+    {
+        const bool bPacked = MaskPixels.IsValid() && MaskPixels == RGBPixels;
+        return FComfyPixelView(MaskPixels, bPacked ? 3 : 0);
+    }
 };
+
+//Fires when a complete frame is ready (RGB and Mask required, Depth optional)
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnFullFrameReady, const FComfyFrame&, Frame);
+
+//Native counterpart of FOnFullFrameReady for C++ consumers (no reflection; read pixels through the frame's views)
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnFullFrameReadyNative, const FComfyFrame& /*Frame*/);
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ComfyPngDecoder.h"
+#include "ComfyStreamTypes.h"
+
+// Content hashes of fixed-size tiles of one image (mip 0), row-major
+struct REALITYSTREAM_API FComfyTileHashes
+{
+	int32 TileSize = 0;
+	int32 TilesX = 0;
+	int32 TilesY = 0;
+	TArray<uint64> Hashes;
+
+	bool Matches(const FComfyTileHashes& Other) const
+	{
+		return TileSize == Other.TileSize && TilesX == Other.TilesX && TilesY == Other.TilesY && Hashes.Num() == Other.Hashes.Num();
+	}
+};
+
+// CPU result of ingesting one RGB/Depth/Mask triplet (produced on a worker thread)
+struct REALITYSTREAM_API FComfyIngestResult
+{
+	FComfyDecodedImage RGB;
+	FComfyDecodedImage Depth;	// optional (invalid when missing)
+	FComfyDecodedImage Mask;	// empty when packed into RGB alpha
+	FComfyDecodedImage Normal;	// optional R8G8 normal map computed from Depth
+
+	// Mask lives in RGB.A - no separate mask texture is created
+	bool bMaskPacked = false;
+
+	// Subject bounds, centroid, moments and mean depth (before cropping)
+	FComfyMaskAnalytics Analytics;
+
+	// Crop region in UV of the full decoded frame (identity when not cropped)
+	FVector2D RoiOffset = FVector2D::ZeroVector;
+	FVector2D RoiScale = FVector2D(1.0, 1.0);
+
+	// Crop rectangle in pixels of the full decoded frame (empty when not cropped); pass it back as PreviousCrop
+	FIntRect CropRect;
+
+	// Tile hashes per channel (only filled when delta uploads are enabled)
+	FComfyTileHashes RGBTiles;
+	FComfyTileHashes DepthTiles;
+	FComfyTileHashes MaskTiles;
+	FComfyTileHashes NormalTiles;
+
+	// Worker-side stage timings (upload time and counters are filled in by the fetcher)
+	FComfyIngestStats Stats;
+
+	bool IsComplete() const { return RGB.IsValid() && (bMaskPacked || Mask.IsValid()); }
+};
+
+// Edge rules used when upscaling a channel
+enum class EComfyUpscaleChannel : uint8
+{
+	Color,	// plain Lanczos
+	Mask,	// Lanczos, then threshold at half range (no ringing or grey seams)
+	Depth	// Lanczos clamped to the source neighbourhood; nearest sample across discontinuities
+};
+
+// Worker-thread ingest stages for streamed frames
+// Everything here works on CPU pixels only (no UObject access), so it is safe to run from the thread pool
+class REALITYSTREAM_API FComfyFrameIngest
+{
+public:
+	// Decodes the PNGs of one frame, assigns RGB/Depth/Mask and runs the enabled stages.
+	// PreviousCrop is the CropRect of the stream's last frame; the crop stays on it while the subject fits.
+	static bool ProcessTriplet(const TArray<TArray<uint8>>& Pngs, const FComfyIngestSettings& Settings, FComfyIngestResult& OutResult,
+	                           const FIntRect& PreviousCrop = FIntRect());
+
+	// Writes Mask into the alpha channel of an RGBA8 image of the same size (SSE2 with scalar fallback)
+	static bool PackMaskIntoAlpha(FComfyDecodedImage& RGB, const FComfyDecodedImage& Mask);
+
+	// Separable Lanczos-3 upscale by Factor (>= 1), SSE2, tiled over row bands with ParallelFor.
+	// DepthEdgeThreshold (fraction of the value range) is only used by EComfyUpscaleChannel::Depth.
+	static void UpscaleImage(FComfyDecodedImage& Image, float Factor, EComfyUpscaleChannel Channel, float DepthEdgeThreshold = 0.04f);
+
+	// Times UpscaleImage on a synthetic RGB/Depth/Mask frame of the given size
+	static FComfyUpscaleBenchmark BenchmarkUpscale(int32 Width, int32 Height, float Factor, int32 Iterations, float GenerationMs);
+
+	// Erode, dilate and feather a mask in place (separable, SSE2, rows in parallel). 16-bit masks become G8.
+	static void CleanMask(FComfyDecodedImage& Mask, int32 ErodeRadius, int32 DilateRadius, float FeatherSigma);
+
+	// R8G8 tangent-space normals from a single-channel depth image (Sobel, SSE2, rows in parallel).
+	// DepthScale is the world size of the full depth range; the frame width is taken as 100 units (engine plane).
+	static bool ComputeNormalsFromDepth(const FComfyDecodedImage& Depth, float DepthScale, FComfyDecodedImage& OutNormal);
+
+	// Bounding rectangle of mask values above Threshold (SSE2 row/column max scan). False for an empty mask.
+	static bool ComputeMaskBounds(const FComfyDecodedImage& Mask, uint8 Threshold, FIntRect& OutBounds);
+
+	// Bounds, coverage-weighted area, centroid and second moments of mask values above Threshold, plus the
+	// mean of Depth inside the mask (Depth may be invalid or of another resolution). One SSE2 pass, row bands in parallel.
+	static bool ComputeMaskAnalytics(const FComfyDecodedImage& Mask, const FComfyDecodedImage& Depth, uint8 Threshold, FComfyMaskAnalytics& OutAnalytics);
+
+	// Hashes TileSize x TileSize blocks of mip 0 (edge tiles are clipped to the image)
+	static void ComputeTileHashes(const FComfyDecodedImage& Image, int32 TileSize, FComfyTileHashes& OutTiles);
+
+private:
+	// Crops every channel to the padded mask bounds (grid-snapped, or PreviousCrop while it still fits) and records the ROI
+	static void CropToMask(FComfyIngestResult& Result, const FComfyIngestSettings& Settings, const FIntRect& PreviousCrop);
+
+	// Colored image = RGB, larger grayscale PNG = Depth, smaller = Mask. Falls back to arrival order.
+	static void AssignChannels(const TArray<TArray<uint8>>& Pngs, TArray<FComfyDecodedImage>& Images, FComfyIngestResult& OutResult);
+};
@@ -2,6 +2,8 @@
 
 #include "CoreMinimal.h"
 #include "ComfyStreamTypes.h"
+#include "ComfyFrameBundle.h"
+#include "ComfyDeltaTexture.h"
 #include "ComfyImageFetcher.generated.h"
 
 class UComfyPngDecoder;
@@ -19,6 +21,13 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FOnTextureReceived OnTextureReceived;
 
+	//Complete frame (RGB, optional Depth, Mask) after worker-thread ingest
+	UPROPERTY(BlueprintAssignable)
+	FOnFullFrameReady OnFullFrameReady;
+
+	//Same frame for C++ consumers, broadcast first (CPU pixels through FComfyFrame::GetRGBView etc.)
+	FOnFullFrameReadyNative OnFullFrameReadyNative;
+
 	UPROPERTY(BlueprintAssignable)
 	FOnConnectionStatusChanged OnConnectionStatusChanged;
 
@@ -34,6 +43,10 @@ public:
 	UFUNCTION(BlueprintCallable)
 	bool IsPolling() const;
 
+	//Timings of the last ingested frame and running counters
+	UFUNCTION(BlueprintCallable)
+	FComfyIngestStats GetIngestStats() const { return IngestStats; }
+
 	//default websocket port is 8001 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	int32 WebSocketPort = 8001;
@@ -41,6 +54,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FComfyStreamConfig Config;
 
+	//Worker-thread processing for received frames
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FComfyIngestSettings IngestSettings;
+
 private:
 	EComfyConnectionStatus ConnectionStatus = EComfyConnectionStatus::Disconnected;
 	//Decodes png files 
@@ -66,6 +83,27 @@ private:
 	int32 MessagesSinceLastFrame = 0;
 	static constexpr int32 MaxMessagesBeforeClear = 10; // Clear accumulator if 10+ messages without completing a frame
 
+	// Worker-thread ingest: one frame in flight, only the newest waiting triplet is kept (older ones are dropped)
+	bool bIngestInFlight = false;
+	TArray<TArray<uint8>> PendingIngestPngs;
+	// Bumped by StopPolling so results from a previous connection are discarded
+	uint32 IngestGeneration = 0;
+	FComfyIngestStats IngestStats;
+
+	// Persistent per-channel textures for delta uploads (IngestSettings.bDeltaUploads)
+	UPROPERTY() FComfyDeltaTexture RGBDelta;
+	UPROPERTY() FComfyDeltaTexture DepthDelta;
+	UPROPERTY() FComfyDeltaTexture MaskDelta;
+	UPROPERTY() FComfyDeltaTexture NormalDelta;
+	int64 TotalTilesUploaded = 0;
+	int64 TotalTiles = 0;
+
+	// Crop of the last ingested frame, held by the next one while the subject still fits (IngestSettings.bCropToMask)
+	FIntRect LastCropRect;
+
+	// For FComfyIngestStats::FrameIntervalMs
+	double LastIngestTime = 0.0;
+
 	//WebSocket events (may be called from worker threads)
 	void OnWebSocketConnected();
 	void OnWebSocketConnectionError(const FString& Error);
@@ -80,6 +118,9 @@ private:
 	void OnWebSocketMessage_GameThread(const void* Data, SIZE_T Size, SIZE_T BytesRemaining);
 
 	void ProcessImageData(const TArray<uint8>& Data);
+	void QueueFrameIngest(TArray<TArray<uint8>>&& Pngs);
+	void StartFrameIngest();
+	void OnFrameIngested(FComfyIngestResult& Result);
 	void SetConnectionStatus(EComfyConnectionStatus NewStatus);
 	FString BuildWebSocketURL(const FString& ServerURL, int32 ChannelNumber);
 	TArray<TArray<uint8>> SplitPNGStream(const TArray<uint8>& Buffer);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ComfyPngDecoder.h"
+
+// Block motion vectors from one frame to the next (pixels of the full-resolution frame)
+struct REALITYSTREAM_API FComfyFlowField
+{
+	// Frame size the vectors were estimated on
+	int32 Width = 0;
+	int32 Height = 0;
+
+	int32 BlockSize = 8;
+	int32 BlocksX = 0;
+	int32 BlocksY = 0;
+
+	// Row-major, one displacement From -> To per block
+	TArray<FVector2f> Vectors;
+
+	bool IsValid() const { return BlocksX > 0 && BlocksY > 0 && Vectors.Num() == BlocksX * BlocksY; }
+
+	// Bilinear between block centres, X/Y in frame pixels
+	FVector2f Sample(float X, float Y) const;
+};
+
+// Coarse optical flow and motion-compensated in-betweens for streamed frames.
+// Everything here works on CPU pixels only, so estimation can run on the thread pool.
+class REALITYSTREAM_API FComfyMotionFlow
+{
+public:
+	// Coarse-to-fine block matching on luma pyramids of From and To (SSE2 SAD, block rows in parallel).
+	// Blocks outside both masks keep zero motion (the background is static); masks may be null.
+	static bool EstimateFlow(const FComfyDecodedImage& From, const FComfyDecodedImage& To,
+	                         const FComfyDecodedImage* FromMask, const FComfyDecodedImage* ToMask, FComfyFlowField& OutFlow);
+
+	// In-between at time T (0 = From, 1 = To): both frames are warped along the flow to T and blended.
+	// From and To must share size and format; channels of another resolution than the flow are scaled to it.
+	static void WarpBlend(const FComfyDecodedImage& From, const FComfyDecodedImage& To, const FComfyFlowField& Flow, float T, uint8* Dst);
+
+private:
+	// 8-bit luma (RGBA) or high byte (G16) of mip 0
+	static void ComputeLuma(const FComfyDecodedImage& Image, TArray<uint8>& OutLuma);
+
+	// Coverage above the mask threshold as 8-bit (G8, G16 high byte, or RGBA alpha for packed masks)
+	static void ComputeCoverage(const FComfyDecodedImage& Mask, int32 Width, int32 Height, TArray<uint8>& OutCoverage);
+};
@@ -5,6 +5,43 @@
 #include "Engine/Texture2D.h"
 #include "ComfyPngDecoder.generated.h"
 
+// CPU-side pixels of one decoded PNG
+// Colour PNGs decode to PF_R8G8B8A8, grayscale PNGs keep their bit depth as PF_G8 (mask) or PF_G16 (16-bit depth)
+struct REALITYSTREAM_API FComfyDecodedImage
+{
+	int32 Width = 0;
+	int32 Height = 0;
+	EPixelFormat Format = PF_Unknown;
+	TArray<uint8> Pixels;
+
+	// Mip levels 1..N (level 0 is Pixels), filled by UComfyPngDecoder::BuildMipChain
+	TArray<TArray<uint8>> Mips;
+
+	static int32 GetBytesPerPixel(EPixelFormat InFormat)
+	{
+		switch (InFormat)
+		{
+		case PF_G8:			return 1;
+		case PF_G16:		return 2;
+		case PF_R8G8:		return 2;
+		case PF_R8G8B8A8:	return 4;
+		case PF_B8G8R8A8:	return 4;
+		default:			return 0;
+		}
+	}
+
+	int32 GetBytesPerPixel() const { return GetBytesPerPixel(Format); }
+	int32 GetNumMips() const { return 1 + Mips.Num(); }
+	bool IsSingleChannel() const { return Format == PF_G8 || Format == PF_G16; }
+	bool IsValid() const
+	{
+		return Width > 0 && Height > 0 && GetBytesPerPixel() > 0 &&
+		       Pixels.Num() == Width * Height * GetBytesPerPixel();
+	}
+};
+
+// Immutable decoded image shared by frames, CPU blending and pending render-thread uploads
+using FComfyImageRef = TSharedPtr<const FComfyDecodedImage, ESPMode::ThreadSafe>;
 
 // Decodes PNG images into UTexture2D (used by ComfyStreamActor for received images)
 UCLASS()
@@ -13,11 +50,36 @@ class REALITYSTREAM_API UComfyPngDecoder : public UObject
 	GENERATED_BODY()
 
 public:
+	// Decode, downscale by half and upload. Picks RGBA8, G8 or G16 from the PNG colour type and bit depth.
 	UTexture2D* DecodePNGToTexture(const TArray<uint8>& PNGData);
 	UTexture2D* DecodePNGToTextureWithFormat(const TArray<uint8>& PNGData, TEnumAsByte<EPixelFormat> PixelFormat);
 
-	bool IsValidPNGData(const TArray<uint8>& PNGData);
+	// Decode to CPU pixels only (no UObject access, safe to call off the game thread)
+	static bool DecodePNGToImage(const TArray<uint8>& PNGData, FComfyDecodedImage& OutImage);
+
+	// 2x2 box filter to half resolution (all formats produced by DecodePNGToImage)
+	static void DownscaleImageHalf(FComfyDecodedImage& Image);
+
+	// Full mip chain down to 1x1 using the same 2x2 kernel as DownscaleImageHalf
+	static void BuildMipChain(FComfyDecodedImage& Image);
+
+	// One 2x2 box filter step from Src (W x H) into Dst (max(1,W/2) x max(1,H/2)). SSE2 for RGBA8/G8.
+	static void DownsampleHalf(const uint8* Src, int32 W, int32 H, EPixelFormat Format, uint8* Dst);
+
+	// True when a sampled grid of pixels has R=G=B (always true for single-channel formats)
+	static bool IsImageGrayscale(const FComfyDecodedImage& Image);
+
+	// Keeps only the pixels inside Rect (clamped to the image)
+	static void CropImage(FComfyDecodedImage& Image, const FIntRect& Rect);
+
+	// Collapses an RGBA image whose content is gray into PF_G8 (ComfyUI often saves masks/depth as RGB PNGs)
+	static void ConvertToSingleChannel(FComfyDecodedImage& Image);
+
+	// Creates a transient texture from already decoded pixels, including any mips (game thread only)
+	static UTexture2D* CreateTextureFromImage(const FComfyDecodedImage& Image);
+
+	static bool IsValidPNGData(const TArray<uint8>& PNGData);
 
-private:
-	UTexture2D* CreateTextureFromData(const TArray<uint8>& UncompressedData, int32 Width, int32 Height, EPixelFormat PixelFormat);
+	// Reads bit depth and colour type from the IHDR chunk. Returns false if the header is not a valid PNG IHDR.
+	static bool ReadPNGHeader(const TArray<uint8>& PNGData, uint8& OutBitDepth, uint8& OutColorType);
 };
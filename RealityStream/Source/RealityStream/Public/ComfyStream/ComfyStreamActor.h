@@ -4,20 +4,56 @@
 #include "GameFramework/Actor.h"
 #include "Components/StaticMeshComponent.h"
 #include "ComfyStreamComponent.h"
-#include "ComfyFrameBuffer.h"
+#include "ComfyFrameBundle.h"
+#include "ComfyBlendTexture.h"
+#include "ComfyMotionFlow.h"
+#include "ComfyDepthMesh.h"
 #include "ComfyStreamActor.generated.h"
 
-// Holds an interpolated frame plus how long it should remain active
-USTRUCT(BlueprintType)
-struct FInterpolatedFrame
+class UProceduralMeshComponent;
+
+// Stream parameters of one MID, resolved once when the MID is created: scalars and vectors are written by index,
+// textures by prebuilt parameter info and only when the bound texture changes. Applying a frame never looks
+// parameters up by name or reads them back.
+USTRUCT()
+struct FComfyMaterialSlots
 {
 	GENERATED_BODY()
 
-	UPROPERTY()
-	FComfyFrame Frame;
+	void Resolve(UMaterialInstanceDynamic* Material);
+
+	// Binds Frame to the base (Slot 0: RGB_Map ...) or crossfade target (Slot 1: RGB_Map_New ...) textures
+	void SetTextures(UMaterialInstanceDynamic* Material, const FComfyFrame& Frame, int32 Slot);
+
+	// Frame's RGB and Mask (and Depth, when it has one) are what Slot currently holds
+	bool IsBound(const FComfyFrame& Frame, int32 Slot) const;
+
+	// Crossfade finished: the *_New textures become the base textures
+	void PromoteNewSlot(UMaterialInstanceDynamic* Material);
+
+	// MaskInRGBAlpha and ROI_Rect
+	void SetLayout(UMaterialInstanceDynamic* Material, const FComfyFrame& Frame);
+
+	void SetLerpAlpha(UMaterialInstanceDynamic* Material, float Value);
+	void SetOpacity(UMaterialInstanceDynamic* Material, float Value);
+
+private:
+	void SetTexture(UMaterialInstanceDynamic* Material, int32 Param, int32 Slot, UTexture* Texture);
 
+	// Last written texture per parameter [RGB, Mask, Depth, Normal][Slot]
 	UPROPERTY()
-	float TimeRemaining = 0.0f;
+	TObjectPtr<UTexture> Bound[8];
+
+	// Bit per entry of Bound: written at least once (null is a valid binding)
+	uint8 BoundMask = 0;
+
+	// Delta upload ring leases of the frame bound to each slot (its textures are not rewritten while shown)
+	TArray<FComfyTextureLeaseRef, TInlineAllocator<4>> Leases[2];
+
+	int32 LerpAlphaIndex = INDEX_NONE;
+	int32 MaskPackedIndex = INDEX_NONE;
+	int32 OpacityIndex = INDEX_NONE;
+	int32 RoiIndex = INDEX_NONE;
 };
 
 // Tracks spawned actor state for lerp/fade handling
@@ -35,18 +71,35 @@ struct FActorLerpData
 	UPROPERTY()
 	TObjectPtr<UMaterialInstanceDynamic> Material = nullptr;
 
+	// Parameter slots of Material
+	UPROPERTY()
+	FComfyMaterialSlots Slots;
+
 	UPROPERTY()
 	float LerpAlpha = 1.0f;
 
 	UPROPERTY()
 	bool bIsLerping = false;
 
+	// Timed lerp (crossfade): LerpAlpha = Elapsed / Duration, eased. Duration 0 = advance by LerpSpeed.
+	UPROPERTY()
+	float LerpElapsed = 0.0f;
+
+	UPROPERTY()
+	float LerpDuration = 0.0f;
+
+	UPROPERTY()
+	bool bEaseLerp = false;
+
 	UPROPERTY()
 	float OpacityAlpha = 1.0f;
 
 	UPROPERTY()
 	bool bIsFadingOut = false;
 
+	// Last frame shown on this actor (FPlatformTime seconds) - the least recently used actor moves at MaxDisplayActors
+	double LastUsedTime = 0.0;
+
 	// Timer handles are not UPROPERTY types and do not need GC tracking
 	FTimerHandle DestroyTimer;
 	FTimerHandle LerpTimer;
@@ -96,24 +149,83 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Spawning")
 	float FadeOutDuration = 0.5f;
 
+	// Display actors (with their material instances) created hidden at BeginPlay and reused for new locations
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Spawning", meta = (ClampMin = "0", Tooltip = "Display actors created up front so new locations don't spawn actors or materials"))
+	int32 ActorPoolSize = 1;
+
+	// Upper bound of display actors; at the cap the least recently used one moves to a new location
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Spawning", meta = (ClampMin = "0", Tooltip = "Maximum number of display actors (0 = unlimited)"))
+	int32 MaxDisplayActors = 16;
+
+	// Display actors go to the subject's centroid on the display plane (FComfyMaskAnalytics) instead of the actor location.
+	// The image stays where it is; only the actor root follows the subject.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Spawning", meta = (Tooltip = "Place display actors at the segmented subject (mask centroid) instead of this actor's location"))
+	bool bPlaceActorsAtSubject = false;
+
+	// Depth reconstruction: masked depth is unprojected with the stream component's FocalScale / DepthScaleUnits
+	// into a procedural mesh (BaseMaterial, updated in place) that replaces the display actors
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Reconstruction", meta = (Tooltip = "Show the subject as a mesh rebuilt from each depth frame instead of textured display planes"))
+	bool bReconstructDepthMesh = false;
+
+	// Depth pixels between mesh vertices
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Reconstruction", meta = (EditCondition = "bReconstructDepthMesh", ClampMin = "1", ClampMax = "32"))
+	int32 ReconstructionGridStep = 4;
+
+	// Camera distance of the nearest depth value (placed at this actor's display plane)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Reconstruction", meta = (EditCondition = "bReconstructDepthMesh", ClampMin = "1.0"))
+	float ReconstructionNearDistance = 100.0f;
+
+	// Depth steps larger than this fraction of the depth range split the mesh (silhouettes and occlusions)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Reconstruction", meta = (EditCondition = "bReconstructDepthMesh", ClampMin = "0.0", ClampMax = "1.0"))
+	float ReconstructionEdgeThreshold = 0.05f;
+
+	// Collision on the reconstructed mesh (cooked asynchronously)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Reconstruction", meta = (EditCondition = "bReconstructDepthMesh"))
+	bool bReconstructionCollision = false;
+
 	// Delay before applying new frames (for staggered multi-actor setups). 0 = apply immediately.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyStream", meta = (ClampMin = "0.0", Tooltip = "Seconds to wait before applying a new frame. Use 0 for first actor, higher values for 2nd/3rd actors for delayed change."))
 	float FrameApplyDelaySeconds = 0.0f;
 
+	// Receive frames through UComfyStreamHubSubsystem: actors on the same server/channel share one connection and decode
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyStream", meta = (Tooltip = "Share one connection and decode per server/channel with other actors instead of opening a connection per actor"))
+	bool bUseStreamHub = false;
+
+	// Jitter buffer (opt-in, adds up to MaxJitterBufferSeconds of latency): frames are held for a multiple of the measured arrival jitter and shown at a steady cadence
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Presentation", meta = (Tooltip = "Hold incoming frames briefly so uneven ComfyUI arrival times are shown at an even pace"))
+	bool bUseJitterBuffer = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Presentation", meta = (EditCondition = "bUseJitterBuffer", ClampMin = "0.0", ClampMax = "8.0", Tooltip = "Buffer delay in multiples of the measured arrival jitter"))
+	float JitterBufferScale = 2.0f;
+
+	// Upper bound of the added latency
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Presentation", meta = (EditCondition = "bUseJitterBuffer", ClampMin = "0.0", Tooltip = "Maximum seconds a frame is held by the jitter buffer"))
+	float MaxJitterBufferSeconds = 0.25f;
+
 	// Frame interpolation settings
 	// Generates intermediate blended frames between consecutive frames for smoother transitions
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Interpolation", meta = (Tooltip = "Enable frame interpolation to generate smooth transitions between frames"))
 	bool bEnableInterpolation = true;
 
-	// Number of intermediate frames to generate between each pair of frames
-	// Higher values = smoother transitions but more CPU/GPU cost
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Interpolation", meta = (EditCondition = "bEnableInterpolation", ClampMin = "1", ClampMax = "60", Tooltip = "Number of interpolated frames between each real frame. Higher = smoother but more expensive."))
+	// Material crossfade animates one scalar between two bound frames; CPU blend builds blended textures,
+	// motion compensated additionally warps both frames along the estimated flow.
+	// Falls back to CPU blend when BaseMaterial has no LerpAlpha parameter.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Interpolation", meta = (EditCondition = "bEnableInterpolation"))
+	EComfyInterpolationMode InterpolationMode = EComfyInterpolationMode::MaterialCrossfade;
+
+	// Number of intermediate blend steps between each pair of frames (CPU blend / motion compensated)
+	// Steps are blended on demand, so the cost is bounded by the display rate
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Interpolation", meta = (EditCondition = "bEnableInterpolation && InterpolationMode != EComfyInterpolationMode::MaterialCrossfade", ClampMin = "1", ClampMax = "60", Tooltip = "Number of interpolated steps between each real frame. Each step is blended when it is displayed."))
 	int32 NumInterpolatedFrames = 20;
 
 	// Total duration to display all interpolated frames before showing the final frame
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Interpolation", meta = (EditCondition = "bEnableInterpolation", ClampMin = "0.1", Tooltip = "Time in seconds to display all interpolated frames"))
 	float InterpolationDuration = 1.0f;
 
+	// Transitions last until the next frame is due (measured input interval) instead of InterpolationDuration
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Interpolation", meta = (EditCondition = "bEnableInterpolation", Tooltip = "Fit each transition to the measured input frame interval so it finishes as the next frame is due"))
+	bool bAdaptInterpolationDuration = true;
+
 	// Use smooth easing function instead of linear interpolation for more natural motion
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Frame Interpolation", meta = (EditCondition = "bEnableInterpolation", Tooltip = "Use smooth easing (ease-in-out) for more natural transitions"))
 	bool bUseSmoothEasing = true;
@@ -132,16 +244,30 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void ConnectSegmentationChannel();
 
+	// Arrival interval, jitter and buffer delay of the presentation clock
+	UFUNCTION(BlueprintCallable, Category = "ComfyStream")
+	FComfyPresentationStats GetPresentationStats() const;
+
 	UFUNCTION(BlueprintCallable)
 	void DisconnectAll();
 
+	// Subject bounds, centroid, orientation and mean depth of the last applied frame
+	UFUNCTION(BlueprintCallable, Category = "ComfyStream")
+	FComfyMaskAnalytics GetMaskAnalytics() const;
+
+	// World position of the last applied frame's mask centroid on the display plane (actor location without a subject)
+	UFUNCTION(BlueprintCallable, Category = "ComfyStream")
+	FVector GetSubjectLocation() const;
+
 private:
-	// External helper objects
 	UPROPERTY()
-	TObjectPtr<UComfyFrameBuffer> FrameBuffer = nullptr;
+	TObjectPtr<UMaterialInstanceDynamic> DynMat = nullptr;
 
 	UPROPERTY()
-	TObjectPtr<UMaterialInstanceDynamic> DynMat = nullptr;
+	FComfyMaterialSlots DynMatSlots;
+
+	// A Blueprint subclass implements Event Tick - never put the actor to sleep
+	bool bAlwaysTick = false;
 
 	// Last known complete frame
 	UPROPERTY()
@@ -155,32 +281,77 @@ private:
 	UPROPERTY()
 	FComfyFrame PreviousFrame;
 
-	// Interpolation queue
+	// CPU blend between BlendFromFrame and BlendToFrame (InterpolationMode == CpuBlend / MotionCompensated)
 	UPROPERTY()
-	TArray<FInterpolatedFrame> InterpolationQueue;
+	FComfyFrame BlendFromFrame;
+
+	UPROPERTY()
+	FComfyFrame BlendToFrame;
+
+	// Display actor location of the running blend, resolved once so blend textures stay on one actor
+	FVector BlendLocation = FVector::ZeroVector;
 
 	UPROPERTY()
 	float InterpolationTimer = 0.0f;
 
-	// Delayed frame apply (when FrameApplyDelaySeconds > 0)
+	// Duration of the running CPU blend (fixed when it starts)
+	float BlendDuration = 1.0f;
+
+	bool bCpuBlending = false;
+
+	// Step last blended (INDEX_NONE = none yet this transition)
+	int32 LastBlendStep = INDEX_NONE;
+
+	// Flow BlendFromFrame -> BlendToFrame (MotionCompensated), null until estimated on the thread pool
+	TSharedPtr<FComfyFlowField, ESPMode::ThreadSafe> BlendFlow;
+
+	// Discards flow results of transitions that were already replaced
+	uint32 FlowGeneration = 0;
+
+	// Reconstructed depth mesh (bReconstructDepthMesh), created at BeginPlay
 	UPROPERTY()
-	FComfyFrame PendingDelayedFrame;
+	TObjectPtr<UProceduralMeshComponent> DepthMeshComponent = nullptr;
 
-	FTimerHandle DelayedApplyTimer;
+	// Section data reused by every build; one build in flight, the newest waiting frame is kept
+	TSharedPtr<FComfyDepthMeshBuffers, ESPMode::ThreadSafe> DepthMeshBuffers;
+	bool bDepthMeshInFlight = false;
+	FComfyFrame PendingDepthMeshFrame;
 
-	// sequence index for textures
+	// Discards builds that finish after EndPlay
+	uint32 DepthMeshGeneration = 0;
+
+	// Persistent ping-pong textures for blended frames (2 per channel instead of new textures per step)
 	UPROPERTY()
-	int32 SeqIndex = 0;
+	FComfyBlendTexture RGBBlend;
 
-	// Track which channels have been received in the current frame
 	UPROPERTY()
-	bool bHasRGB = false;
+	FComfyBlendTexture MaskBlend;
 
 	UPROPERTY()
-	bool bHasDepth = false;
+	FComfyBlendTexture DepthBlend;
 
 	UPROPERTY()
-	bool bHasMask = false;
+	FComfyBlendTexture NormalBlend;
+
+	// BaseMaterial exposes LerpAlpha (checked at BeginPlay) - material crossfade possible
+	bool bMaterialHasLerpAlpha = false;
+
+	// UComfyStreamHubSubsystem subscription (bUseStreamHub, 0 = none)
+	int32 HubSubscription = 0;
+
+	// Frames waiting for their PresentationTime (jitter buffer and FrameApplyDelaySeconds), oldest first
+	UPROPERTY()
+	TArray<FComfyFrame> FrameQueue;
+
+	// Arrival statistics (seconds): smoothed interval and interarrival jitter
+	double LastArrivalTime = 0.0;
+	double MeanArrivalInterval = 0.0;
+	double ArrivalJitter = 0.0;
+
+	// Presentation time of the frame shown last
+	double LastPresentationTime = 0.0;
+
+	FComfyPresentationStats PresentationStats;
 
 	// Spawned actors from textures
 	UPROPERTY()
@@ -190,6 +361,13 @@ private:
 	UPROPERTY()
 	TArray<FActorLerpData> ActorData;
 
+	// Hidden display actors ready for reuse (material instance and slots kept)
+	UPROPERTY()
+	TArray<FActorLerpData> ActorPool;
+
+	// Spatial hash of ActorData indices on LocationThreshold-sized cells
+	TMultiMap<FIntVector, int32> ActorCells;
+
 	// Internal helper functions (must be UFUNCTION for dynamic delegate binding)
 	UFUNCTION()
 	void HandleStreamTexture(UTexture2D* Texture);
@@ -200,13 +378,21 @@ private:
 	UFUNCTION()
 	void HandleStreamError(const FString& Error);
 
-	// When FrameBuffer emits a complete triplet
+	// When the stream component emits a complete frame
 	UFUNCTION()
 	void HandleFullFrame(const FComfyFrame& Frame);
 
-	// Timer callback for delayed frame apply
-	UFUNCTION()
-	void ApplyDelayedFrame();
+	// Updates the arrival statistics, stamps the frame's PresentationTime and queues it
+	void ScheduleFrame(FComfyFrame Frame);
+
+	// Shows the newest queued frame whose PresentationTime has come (older due frames are skipped)
+	void PresentDueFrames();
+
+	// Transition length: until the next frame is due (bAdaptInterpolationDuration) or InterpolationDuration
+	float GetTransitionDuration() const;
+
+	// Ticks only while frames are queued or a transition runs; HandleFullFrame wakes the actor
+	void UpdateTickState();
 
 	// Apply textures to the material
 	void ApplyTexturesToMaterial(const FComfyFrame& Frame);
@@ -214,23 +400,54 @@ private:
 	// Shared apply path (immediate or from delayed callback)
 	void ApplyNewFrame(const FComfyFrame& Frame);
 
-	// Spawn actor at specified world position
-	void SpawnTextureActor(const FComfyFrame& Frame, const FVector& WorldPosition);
+	// Spawn actor at specified world position (returns its lerp entry, valid until ActorData changes)
+	FActorLerpData* SpawnTextureActor(const FComfyFrame& Frame, const FVector& WorldPosition);
 
-	// Find existing actor at location or spawn new
-	AActor* FindOrSpawnActorAtLocation(const FVector& WorldPosition);
+	// Binds From as current and To as *_New on the spawned actor's material and starts the LerpAlpha animation.
+	// False when the material can't crossfade (caller falls back to CPU blending).
+	bool StartMaterialCrossfade(const FComfyFrame& From, const FComfyFrame& To);
+
+	// Linear progress -> displayed blend weight (smooth step when bUseSmoothEasing)
+	float EaseInterpolation(float LinearAlpha) const;
+
+	// Actor within LocationThreshold of the location, else a pooled, recycled (at MaxDisplayActors) or new one
+	FActorLerpData* FindOrAcquireActorAtLocation(const FVector& WorldPosition);
+
+	// Spawns a display actor (scene root + plane mesh) and tracks it in SpawnedTextureActors
+	AActor* CreateDisplayActor(const FVector& WorldPosition);
+
+	// Material instance for a pooled actor, so reuse doesn't create one
+	void CreateDisplayMaterial(FActorLerpData& Entry);
+
+	// Hides the actor and returns it to ActorPool
+	void ReleaseDisplayActor(int32 Index);
+
+	FIntVector GetActorCell(const FVector& Position) const;
+	void RebuildActorCells();
 
 	// Update material lerp
 	void UpdateActorLerp(FActorLerpData& ActorDataEntry, const FComfyFrame& Frame, float DeltaTime);
 
-	// Destroy actor after delay
+	// Returns the actor to the pool (actors are never destroyed before EndPlay)
 	void DestroyActorDelayed(AActor* Actor);
 
 	// Scale actor to match texture dimensions
 	void ScaleActorToTextureSize(AActor* Actor, const FComfyFrame& Frame);
 
+	// Point on the display plane at frame UV (plane local X follows U, local Y follows V)
+	FVector GetFrameWorldLocation(const FVector2D& UV) const;
+
+	// Where SpawnTextureActor places the frame's display actor (subject centroid or actor location)
+	FVector GetDisplayActorLocation(const FComfyFrame& Frame) const;
+
+	// Rebuilds the depth mesh from the frame's CPU depth and mask on a worker thread
+	void UpdateDepthMesh(const FComfyFrame& Frame);
+	void OnDepthMeshBuilt(bool bBuilt);
+
 	// Frame interpolation functions
-	void GenerateInterpolatedFrames(const FComfyFrame& FromFrame, const FComfyFrame& ToFrame);
-	UTexture2D* BlendTextures(UTexture2D* TextureA, UTexture2D* TextureB, float Alpha);
-	void ApplyInterpolatedFrame(const FComfyFrame& Frame);
+	void StartCpuBlend(const FComfyFrame& FromFrame, const FComfyFrame& ToFrame);
+	void UpdateCpuBlend(float DeltaTime);
+	// Ends a running blend on the real BlendToFrame textures
+	void FinishCpuBlend();
+	void ApplyInterpolatedFrame(const FComfyFrame& Frame, const FVector& WorldPosition);
 };
\ No newline at end of file
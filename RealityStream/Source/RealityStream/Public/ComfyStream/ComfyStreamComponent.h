@@ -4,6 +4,7 @@
 #include "Components/ActorComponent.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "ComfyStreamTypes.h"
+#include "ComfyFrameBundle.h"
 #include "ComfyStreamComponent.generated.h"
 
 class UComfyImageFetcher;
@@ -32,6 +33,13 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "ComfyStream")
 	FOnTextureReceived OnTextureReceived;
 
+	//Complete frame after worker-thread ingest (RGB, optional Depth, Mask or mask packed in RGB alpha)
+	UPROPERTY(BlueprintAssignable, Category = "ComfyStream")
+	FOnFullFrameReady OnFullFrameReady;
+
+	//Native frame event for C++ consumers: shared read-only CPU pixels (GetRGBView, GetMaskView ...) next to the textures
+	FOnFullFrameReadyNative OnFullFrameReadyNative;
+
 	UPROPERTY(BlueprintAssignable, Category = "ComfyStream")
 	FOnConnectionStatusChanged OnConnectionStatusChanged;
 
@@ -42,6 +50,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="ComfyStream", meta=(EditCondition="!bSuppressStreamConfigInEditor", EditConditionHides))
 	FComfyStreamConfig StreamConfig;
 
+	//Worker-thread processing applied to each received frame (read at BeginPlay)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="ComfyStream|Ingest")
+	FComfyIngestSettings IngestSettings;
+
 	//Intrinsics knobs for DepthAnything webcam
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Reconstruction")
 	float FocalScale = 1.2f; 
@@ -55,6 +67,14 @@ public:
 	UFUNCTION(BlueprintCallable) bool IsConnected() const;
 	UFUNCTION(BlueprintCallable) EComfyConnectionStatus GetConnectionStatus() const;
 
+	//Per-frame ingest timings (decode, downscale, pack, mips, upload) of the last received frame
+	UFUNCTION(BlueprintCallable, Category="ComfyStream|Ingest") FComfyIngestStats GetIngestStats() const;
+
+	//Times the Lanczos upscale on a synthetic Width x Height frame and compares it with the generation time saved
+	//by rendering at that size. GenerationMs <= 0 uses the measured frame interval of the stream.
+	UFUNCTION(BlueprintCallable, Category="ComfyStream|Ingest")
+	FComfyUpscaleBenchmark BenchmarkUpscale(int32 Width = 512, int32 Height = 512, float Factor = 2.0f, int32 Iterations = 10, float GenerationMs = 0.0f) const;
+
 private:
 	/** When true, Stream Config is not shown in the details panel (AComfyStreamActor sets this; not exposed to users). Serialization keeps instance defaults in sync. */
 	UPROPERTY()
@@ -69,6 +89,7 @@ private:
 	FTimerHandle ReconnectTimer;
 
 	UFUNCTION() void OnTextureReceivedInternal(UTexture2D* Texture);
+	UFUNCTION() void OnFullFrameReadyInternal(const FComfyFrame& Frame);
 	UFUNCTION() void OnConnectionStatusChangedInternal(bool bConnected);
 	UFUNCTION() void OnErrorInternal(const FString& ErrorMessage);
 
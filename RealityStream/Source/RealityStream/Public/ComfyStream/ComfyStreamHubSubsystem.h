@@ -0,0 +1,116 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "ComfyStreamTypes.h"
+#include "ComfyFrameBundle.h"
+#include "ComfyStreamHubSubsystem.generated.h"
+
+class UComfyImageFetcher;
+
+// Frame callback of a hub subscriber (game thread)
+DECLARE_DELEGATE_OneParam(FComfyHubFrameDelegate, const FComfyFrame&);
+
+struct FComfyHubSubscriber
+{
+	int32 Id = 0;
+
+	// Frames are delivered this long after they arrived
+	float DelaySeconds = 0.0f;
+
+	// ArrivalTime of the last delivered frame
+	double Cursor = 0.0;
+
+	FComfyHubFrameDelegate OnFrame;
+};
+
+// One shared connection and decode for a server/channel, plus the recent frame history
+UCLASS()
+class REALITYSTREAM_API UComfyHubStream : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	void Start(const FComfyStreamConfig& InConfig, const FComfyIngestSettings& InIngestSettings);
+	void Stop();
+
+	// Delivers due frames to delayed subscribers and drops history outside the budget
+	void Tick(double Now, int64 MemoryBudgetBytes, double MaxHistorySeconds);
+
+	// Newest frame that arrived at or before Time (FPlatformTime seconds)
+	bool GetFrameAtTime(double Time, FComfyFrame& OutFrame) const;
+
+	int64 GetHistoryBytes() const { return HistoryBytes; }
+	int32 GetHistoryNum() const { return History.Num(); }
+
+	UPROPERTY()
+	TObjectPtr<UComfyImageFetcher> Fetcher = nullptr;
+
+	FComfyStreamConfig Config;
+	TArray<FComfyHubSubscriber> Subscribers;
+
+private:
+	void HandleFrame(const FComfyFrame& Frame);
+
+	UFUNCTION()
+	void HandleConnectionChanged(bool bConnected);
+
+	// CPU pixels of the frame's channels (textures hold about as much again on the GPU)
+	static int64 GetFrameBytes(const FComfyFrame& Frame);
+
+	// Received frames, oldest first (keeps their textures alive)
+	UPROPERTY()
+	TArray<FComfyFrame> History;
+
+	TArray<int64> FrameBytes;
+	int64 HistoryBytes = 0;
+
+	// Reconnect attempt due (0 = none)
+	double ReconnectTime = 0.0;
+};
+
+// Decodes each ComfyUI server/channel once and fans the frames out to any number of consumers.
+// Staggered displays subscribe with their own delay instead of opening one socket and decode each.
+UCLASS(BlueprintType)
+class REALITYSTREAM_API UComfyStreamHubSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Connects the server/channel on first use. IngestSettings of the first subscriber apply to the stream.
+	// DelaySeconds > 0 delivers every frame that long after its arrival. Returns the subscription id.
+	int32 Subscribe(const FComfyStreamConfig& Config, const FComfyIngestSettings& IngestSettings, float DelaySeconds, FComfyHubFrameDelegate OnFrame);
+
+	// Disconnects the stream when its last subscriber leaves
+	void Unsubscribe(int32 SubscriptionId);
+
+	// Frame that was current SecondsAgo on a subscribed stream (from the history)
+	UFUNCTION(BlueprintCallable, Category = "ComfyStream|Hub")
+	bool GetFrameAtTime(const FString& ServerURL, int32 ChannelNumber, float SecondsAgo, FComfyFrame& OutFrame) const;
+
+	// History kept per stream: frames older than MaxSeconds or beyond MemoryBudgetMB are dropped (newest frame always kept)
+	UFUNCTION(BlueprintCallable, Category = "ComfyStream|Hub")
+	void SetHistoryBudget(int32 MemoryBudgetMB = 256, float MaxSeconds = 10.0f);
+
+	// Estimated memory of all stream histories
+	UFUNCTION(BlueprintCallable, Category = "ComfyStream|Hub")
+	int64 GetHistoryBytes() const;
+
+private:
+	bool Tick(float DeltaTime);
+
+	static FString MakeStreamKey(const FString& ServerURL, int32 ChannelNumber);
+
+	UPROPERTY()
+	TMap<FString, TObjectPtr<UComfyHubStream>> Streams;
+
+	int32 NextSubscriptionId = 1;
+	int64 MemoryBudgetBytes = 256ll * 1024 * 1024;
+	double MaxHistorySeconds = 10.0;
+
+	FTSTicker::FDelegateHandle TickHandle;
+};
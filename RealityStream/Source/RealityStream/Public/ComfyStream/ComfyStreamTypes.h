@@ -31,6 +31,18 @@ enum class EComfyConnectionStatus : uint8
 	Error			UMETA(DisplayName = "Error")
 };
 
+// How AComfyStreamActor blends between consecutive frames
+UENUM(BlueprintType)
+enum class EComfyInterpolationMode : uint8
+{
+	// Previous and next frame bound once (RGB_Map / RGB_Map_New ...), only the LerpAlpha scalar is animated
+	MaterialCrossfade	UMETA(DisplayName = "Material Crossfade"),
+	// Blended textures built on the CPU (for materials without LerpAlpha and *_New slots)
+	CpuBlend			UMETA(DisplayName = "CPU Blend"),
+	// CPU steps warped along block-matching optical flow before blending (less ghosting on moving subjects)
+	MotionCompensated	UMETA(DisplayName = "Motion Compensated")
+};
+
 // Configuration structure for ComfyUI connection
 USTRUCT(BlueprintType)
 struct FComfyStreamConfig
@@ -89,6 +101,264 @@ struct FComfyStreamConfig
 	}
 };
 
+// Worker-thread processing applied to each received frame before upload
+USTRUCT(BlueprintType)
+struct FComfyIngestSettings
+{
+	GENERATED_BODY()
+
+	// Halve the resolution of all channels after decode (2x2 box filter). Ignored while upscaling.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI|Ingest", meta = (EditCondition = "UpscaleFactor <= 1.0"))
+	bool bDownscaleHalf = true;
+
+	// Lanczos-3 upscale of all channels after decode (1 = off). Lets ComfyUI render at a lower resolution
+	// (e.g. 512x512 with factor 2); the mask is thresholded after upscaling and depth keeps hard edges.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI|Ingest", meta = (ClampMin = "1.0", ClampMax = "4.0"))
+	float UpscaleFactor = 1.0f;
+
+	// Depth steps larger than this fraction of the depth range use the nearest sample instead of Lanczos
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI|Ingest", meta = (EditCondition = "UpscaleFactor > 1.0", ClampMin = "0.0", ClampMax = "1.0"))
+	float UpscaleDepthEdgeThreshold = 0.04f;
+
+	// Merge the mask into the RGB texture's alpha channel (one upload and one sampler instead of two).
+	// Material reads coverage from RGB_Map.A when the "MaskInRGBAlpha" scalar is 1.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI|Ingest")
+	bool bPackMaskIntoRGBAlpha = false;
+
+	// Build a full mip chain for every channel (trilinear sampling when DisplayMesh is far away or at an angle)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI|Ingest")
+	bool bGenerateMips = false;
+
+	// Mask clean-up: erode radius in pixels (removes specks and thin noise; 0 = off). Runs before dilate.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI|Ingest|Mask", meta = (ClampMin = "0", ClampMax = "16"))
+	int32 MaskErodeRadius = 0;
+
+	// Mask clean-up: dilate radius in pixels (closes holes / restores size after erode; 0 = off)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI|Ingest|Mask", meta = (ClampMin = "0", ClampMax = "16"))
+	int32 MaskDilateRadius = 0;
+
+	// Mask clean-up: Gaussian feather sigma in pixels for soft edges (0 = off)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI|Ingest|Mask", meta = (ClampMin = "0.0", ClampMax = "16.0"))
+	float MaskFeatherSigma = 0.0f;
+
+	// Compute a normal map from depth (Sobel) for the material's "Normal_Map" parameter instead of
+	// taking depth differences in MF_DepthToNormal. Stored as R8G8 (X, Y); the material rebuilds Z.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI|Ingest")
+	bool bComputeNormals = false;
+
+	// World units covered by the full depth range (set from UComfyStreamComponent::DepthScaleUnits)
+	UPROPERTY()
+	float NormalDepthScale = 500.0f;
+
+	// Crop all channels to the mask's bounding rectangle before upload (frame carries the ROI for the material)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI|Ingest")
+	bool bCropToMask = false;
+
+	// Pixels added around the mask bounds (in decoded, post-downscale pixels)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI|Ingest", meta = (EditCondition = "bCropToMask", ClampMin = "0"))
+	int32 CropPadding = 8;
+
+	// Mask values above this count as subject when computing the bounds and the mask analytics
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI|Ingest", meta = (EditCondition = "bCropToMask || bComputeMaskAnalytics", ClampMin = "0", ClampMax = "254"))
+	int32 CropMaskThreshold = 8;
+
+	// Bounds, area, centroid, orientation and mean depth of the mask, published with the frame (FComfyFrame::Analytics)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI|Ingest|Mask")
+	bool bComputeMaskAnalytics = true;
+
+	// Upload only tiles that changed into a small ring of persistent textures per channel (textures held by retained frames are skipped)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI|Ingest")
+	bool bDeltaUploads = false;
+
+	// Edge length in pixels of the tiles compared for delta uploads
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ComfyUI|Ingest", meta = (EditCondition = "bDeltaUploads", ClampMin = "16", ClampMax = "512"))
+	int32 DeltaTileSize = 64;
+};
+
+// Timings of the most recent ingested frame (milliseconds) plus running counters
+USTRUCT(BlueprintType)
+struct FComfyIngestStats
+{
+	GENERATED_BODY()
+
+	// PNG decode and channel assignment
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float DecodeMs = 0.0f;
+
+	// Half-resolution downscale
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float DownscaleMs = 0.0f;
+
+	// Lanczos upscale
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float UpscaleMs = 0.0f;
+
+	// Mask erode/dilate/feather
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float MaskCleanupMs = 0.0f;
+
+	// Depth-to-normal Sobel pass
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float NormalMs = 0.0f;
+
+	// Mask analytics pass
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float AnalyticsMs = 0.0f;
+
+	// Mask bounds scan and crop
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float CropMs = 0.0f;
+
+	// Mask packing into RGB alpha
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float PackMs = 0.0f;
+
+	// Mip chain generation
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float MipMs = 0.0f;
+
+	// Tile hashing for delta uploads
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float HashMs = 0.0f;
+
+	// Everything done on the worker thread
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float WorkerMs = 0.0f;
+
+	// Texture creation and upload on the game thread
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float UploadMs = 0.0f;
+
+	// Tiles uploaded / total tiles over all channels of the last frame (1 = full upload)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	int32 TilesUploaded = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	int32 TilesTotal = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float UploadedTileFraction = 1.0f;
+
+	// Running fraction since polling started (bandwidth actually spent vs. full uploads)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float AverageUploadedTileFraction = 1.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	int32 FramesIngested = 0;
+
+	// Time between the last two ingested frames (roughly the ComfyUI generation time per frame)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float FrameIntervalMs = 0.0f;
+
+	// Triplets replaced by a newer one while the worker was busy
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	int32 FramesDropped = 0;
+};
+
+// Result of UComfyStreamComponent::BenchmarkUpscale: local upscale cost vs. the generation time it saves
+USTRUCT(BlueprintType)
+struct FComfyUpscaleBenchmark
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	FIntPoint SourceSize = FIntPoint::ZeroValue;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	FIntPoint OutputSize = FIntPoint::ZeroValue;
+
+	// Average worker time to upscale one RGB + Depth + Mask frame
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float UpscaleMs = 0.0f;
+
+	// Generation time per frame at the source resolution (input or measured)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float GenerationMs = 0.0f;
+
+	// Generation time saved per frame vs. rendering at the output resolution (assumes cost ~ pixel count)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float GenerationMsSaved = 0.0f;
+
+	// Estimated end-to-end frame rate gain (generation and ingest overlap, so the slower one limits)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Ingest")
+	float EstimatedSpeedup = 1.0f;
+};
+
+// Shape of the segmented subject in one frame, from the ingest stage's mask pass.
+// Positions are UV of the full (uncropped) frame; values are weighted by mask coverage.
+USTRUCT(BlueprintType)
+struct FComfyMaskAnalytics
+{
+	GENERATED_BODY()
+
+	// Mask had values above the threshold (all other fields are defaults otherwise)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Analytics")
+	bool bHasSubject = false;
+
+	// Bounding rectangle of the subject (Max exclusive)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Analytics")
+	FVector2D BoundsMin = FVector2D::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Analytics")
+	FVector2D BoundsMax = FVector2D::ZeroVector;
+
+	// Covered fraction of the frame
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Analytics")
+	float Area = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Analytics")
+	FVector2D Centroid = FVector2D(0.5, 0.5);
+
+	// Major axis angle from the frame's U axis towards V (image rows), -90..90
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Analytics")
+	float OrientationDegrees = 0.0f;
+
+	// Major and minor semi-axes of the ellipse with the same second moments, in frame widths
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Analytics")
+	FVector2D SemiAxes = FVector2D::ZeroVector;
+
+	// Central second moments (mu20, mu02, mu11) in mask pixels squared
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Analytics")
+	FVector SecondMoments = FVector::ZeroVector;
+
+	// Frame had a depth map; MeanDepth is 0..1 of its range inside the mask
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Analytics")
+	bool bHasDepth = false;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Analytics")
+	float MeanDepth = 0.0f;
+};
+
+// Presentation clock of AComfyStreamActor: arrival statistics and the jitter buffer they size
+USTRUCT(BlueprintType)
+struct FComfyPresentationStats
+{
+	GENERATED_BODY()
+
+	// Smoothed time between frame arrivals
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Presentation")
+	float MeanIntervalMs = 0.0f;
+
+	// Smoothed deviation of arrival intervals from the mean (interarrival jitter as in RFC 3550)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Presentation")
+	float JitterMs = 0.0f;
+
+	// Hold time currently added to arrivals
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Presentation")
+	float BufferDelayMs = 0.0f;
+
+	// Duration of the last started transition
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Presentation")
+	float TransitionMs = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Presentation")
+	int32 QueuedFrames = 0;
+
+	// Frames that became due together with a newer one and were never shown
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ComfyUI|Presentation")
+	int32 FramesSkipped = 0;
+};
+
 // Structure for managing lerp-based texture transitions
 USTRUCT(BlueprintType)
 struct FComfyLerpState
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ComfyDepthMesh.h"
+
+// Options of FComfyVoxelFusion
+struct REALITYSTREAM_API FComfyVoxelFusionSettings
+{
+	// Intrinsics, grid step, mask threshold and depth edge threshold of the unprojection
+	FComfyDepthMeshSettings Unproject;
+
+	// Edge length of a voxel in mesh units
+	float VoxelSize = 2.0f;
+
+	// Cap of the running-average weight, so voxels keep following the subject
+	float MaxWeight = 32.0f;
+
+	// Frames a voxel must be observed in before it is shown
+	float MinConfidence = 2.0f;
+
+	// Voxels not observed for this many integrated frames are evicted (0 = only MaxVoxels evicts)
+	int32 MaxAgeFrames = 600;
+
+	// Voxel budget; the least recently observed voxel makes room for a new one
+	int32 MaxVoxels = 200000;
+};
+
+// Change of one voxel slot (slot = instance index of the point cloud)
+struct FComfyVoxelUpdate
+{
+	int32 Slot = 0;
+	FVector3f Position = FVector3f::ZeroVector;
+	FColor Color = FColor::Black;
+
+	// False for evicted or not yet confident voxels (the instance is scaled to zero and kept for reuse)
+	bool bVisible = false;
+};
+
+// Sparse voxel hash that fuses unprojected RGB-D frames into a persistent point cloud.
+// Not thread-safe: one Integrate at a time (the owner keeps a single build in flight).
+class REALITYSTREAM_API FComfyVoxelFusion
+{
+public:
+	// Merges one frame into the voxels (thread pool safe, CPU pixels only). Colour and position are running
+	// averages of each frame's mean, confidence counts the frames a voxel was observed in. Only slots touched by this frame or evicted are reported.
+	bool Integrate(const FComfyPixelView& RGB, const FComfyPixelView& Depth, const FComfyPixelView& Mask,
+	               const FComfyVoxelFusionSettings& Settings, TArray<FComfyVoxelUpdate>& OutUpdates);
+
+	int32 GetNumVoxels() const { return VoxelIndex.Num(); }
+	int32 GetNumSlots() const { return Voxels.Num(); }
+
+private:
+	struct FVoxel
+	{
+		FIntVector Key = FIntVector::ZeroValue;
+		FVector3f Position = FVector3f::ZeroVector;
+		FVector3f Color = FVector3f::ZeroVector;
+		float Weight = 0.0f;
+
+		// Sums of the current frame's points in this voxel (scratch)
+		FVector3f FramePosition = FVector3f::ZeroVector;
+		FVector3f FrameColor = FVector3f::ZeroVector;
+		int32 FramePoints = 0;
+
+		// Frame of the last observation (INDEX_NONE = free slot)
+		int32 LastSeen = INDEX_NONE;
+
+		bool bDirty = false;
+		bool bShown = false;
+	};
+
+	// Observation log entry; stale once the voxel was seen again or evicted
+	struct FTouch
+	{
+		int32 Slot = 0;
+		int32 Frame = 0;
+	};
+
+	// Oldest live log entry's voxel is freed (false when the log is empty)
+	bool EvictOldest(int32 MinAge);
+	void Evict(int32 Slot);
+	void MarkDirty(int32 Slot);
+
+	TMap<FIntVector, int32> VoxelIndex;
+	TArray<FVoxel> Voxels;
+	TArray<int32> FreeSlots;
+	TArray<int32> DirtySlots;
+
+	// Observations oldest first, from TouchHead (compacted when the consumed part dominates)
+	TArray<FTouch> Touches;
+	int32 TouchHead = 0;
+	int32 FrameCounter = 0;
+
+	// Per frame scratch
+	FComfyDepthGrid Grid;
+	TArray<FIntVector> PointKeys;
+	TArray<FVector3f> PointColors;
+	TArray<uint8> PointValid;
+	TArray<int32> FrameSlots;
+};
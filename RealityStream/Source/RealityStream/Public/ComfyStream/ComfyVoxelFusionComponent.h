@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "ComfyFrameBundle.h"
+#include "ComfyVoxelFusion.h"
+#include "ComfyVoxelFusionComponent.generated.h"
+
+class UComfyStreamComponent;
+class UInstancedStaticMeshComponent;
+class UMaterialInterface;
+
+//Fuses the depth frames of the owner's UComfyStreamComponent into a persistent coloured point cloud.
+//Integration runs on the thread pool; only voxels that changed are pushed to the instanced spheres.
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class REALITYSTREAM_API UComfyVoxelFusionComponent : public USceneComponent
+{
+	GENERATED_BODY()
+
+public:
+	UComfyVoxelFusionComponent();
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	//Integrates every frame of the owner's UComfyStreamComponent (off: call IntegrateFrame, e.g. for hub-fed actors)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Voxel Fusion")
+	bool bAutoBindStream = true;
+
+	//Voxel edge length in cloud units; one point per voxel
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Voxel Fusion", meta=(ClampMin="0.1"))
+	float VoxelSize = 2.0f;
+
+	//Depth pixels between sampled points
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Voxel Fusion", meta=(ClampMin="1", ClampMax="32"))
+	int32 GridStep = 2;
+
+	//Distance of the nearest depth value from the camera (see AComfyStreamActor::ReconstructionNearDistance)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Voxel Fusion", meta=(ClampMin="1.0"))
+	float NearDistance = 100.0f;
+
+	//Points next to a depth jump larger than this fraction of the range are not fused (flying pixels)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Voxel Fusion", meta=(ClampMin="0.0", ClampMax="1.0"))
+	float EdgeThreshold = 0.05f;
+
+	//Frames a voxel must be observed in before it is shown
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Voxel Fusion", meta=(ClampMin="1.0"))
+	float MinConfidence = 2.0f;
+
+	//Running-average weight cap: lower follows moving subjects faster, higher smooths more
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Voxel Fusion", meta=(ClampMin="1.0"))
+	float MaxConfidence = 32.0f;
+
+	//Voxels unseen for this many integrated frames are removed (0 = keep until MaxVoxels)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Voxel Fusion", meta=(ClampMin="0"))
+	int32 MaxAgeFrames = 600;
+
+	//Voxel (and instance) budget; the least recently seen voxel makes room for new ones
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Voxel Fusion", meta=(ClampMin="1"))
+	int32 MaxVoxels = 200000;
+
+	//Sphere scale of a shown voxel (the engine sphere is 100 units across)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Voxel Fusion", meta=(ClampMin="0.001"))
+	float PointScale = 0.02f;
+
+	//Reads RGBA from per-instance custom data 0-3 (default: M_VertexColor like the splat point cloud)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Voxel Fusion")
+	TObjectPtr<UMaterialInterface> PointMaterial;
+
+	//Queues a frame for integration (newest frame wins while one is in flight)
+	UFUNCTION(BlueprintCallable, Category="Voxel Fusion")
+	void IntegrateFrame(const FComfyFrame& Frame);
+
+	//Drops all voxels and instances
+	UFUNCTION(BlueprintCallable, Category="Voxel Fusion")
+	void ResetCloud();
+
+	UFUNCTION(BlueprintCallable, Category="Voxel Fusion")
+	int32 GetNumVoxels() const { return NumVoxels; }
+
+	UFUNCTION(BlueprintCallable, Category="Voxel Fusion")
+	UInstancedStaticMeshComponent* GetPointCloudComponent() const { return PointCloud; }
+
+private:
+	void HandleFrame(const FComfyFrame& Frame);
+	void CreatePointCloud();
+	void ApplyUpdates(const TArray<FComfyVoxelUpdate>& Updates, int32 InNumVoxels);
+
+	UPROPERTY(Transient)
+	TObjectPtr<UComfyStreamComponent> StreamComponent;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UInstancedStaticMeshComponent> PointCloud;
+
+	FDelegateHandle FrameHandle;
+
+	//Worker-side state; replaced on reset so a running integration finishes on the old one
+	TSharedPtr<FComfyVoxelFusion, ESPMode::ThreadSafe> Fusion;
+
+	bool bInFlight = false;
+	FComfyFrame PendingFrame;
+	uint32 Generation = 0;
+	int32 NumVoxels = 0;
+};
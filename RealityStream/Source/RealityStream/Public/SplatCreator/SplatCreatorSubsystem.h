@@ -2,6 +2,8 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "HAL/ThreadSafeBool.h"
+#include "SplatPointCache.h"
 #include "SplatCreatorSubsystem.generated.h"
 
 class UInstancedStaticMeshComponent;
@@ -10,6 +12,7 @@ class UMaterialInterface;
 class UMaterialInstanceDynamic;
 class UTexture2D;
 class UCanvas;
+class APlayerController;
 
 // Delegate for when splat bounds are updated
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSplatBoundsUpdated, FBox, NewBounds);
@@ -45,6 +48,64 @@ struct FImagePreviewTarget
 	FName TargetName = NAME_None;
 };
 
+// Sphere of the splat point cloud hit by a ray (RaycastSplat / PickSplatAtScreenPositions)
+USTRUCT(BlueprintType)
+struct FSplatRayHit
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SplatCreator|Pick")
+	bool bHit = false;
+
+	// Instance index in the point cloud (also the index into the splat's colours and sphere sizes)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SplatCreator|Pick")
+	int32 InstanceIndex = INDEX_NONE;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SplatCreator|Pick")
+	FVector Location = FVector::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SplatCreator|Pick")
+	FVector Normal = FVector::ZeroVector;
+
+	// Along the ray from its origin, in world units
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SplatCreator|Pick")
+	float Distance = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SplatCreator|Pick")
+	FColor Color = FColor::Black;
+};
+
+// Result of USplatCreatorSubsystem::BenchmarkSphereSizing: grid k-NN sphere sizing vs. the previous index-window scan
+USTRUCT(BlueprintType)
+struct FSplatDensityBenchmark
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SplatCreator")
+	int32 NumPoints = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SplatCreator")
+	int32 Neighbours = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SplatCreator")
+	float GridBuildMs = 0.0f;
+
+	// Grid build plus exact k-NN mean distance for every point
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SplatCreator")
+	float KnnMs = 0.0f;
+
+	// Index-window nearest-neighbour scan, timed on up to 20k points and extrapolated to NumPoints
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SplatCreator")
+	float LegacyMsEstimated = 0.0f;
+
+	// Fraction of points where the index window contained the true nearest neighbour
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SplatCreator")
+	float LegacyNearestAccuracy = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SplatCreator")
+	float Speedup = 0.0f;
+};
+
 UCLASS(BlueprintType)
 class REALITYSTREAM_API USplatCreatorSubsystem : public UGameInstanceSubsystem
 {
@@ -79,6 +140,53 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "SplatCreator")
 	bool IsPositionTooCloseToSplatPoints(const FVector& Position, float MinDistance = 50.0f, bool bCheckHorizontalOnly = true) const;
 
+	// True from StartPointCloudSystem until the first splat is shown - it is prepared in the background,
+	// so placement queries see no splat points yet. OnSplatBoundsUpdated is broadcast once it is up.
+	UFUNCTION(BlueprintCallable, Category = "SplatCreator")
+	bool IsFirstSplatPending() const;
+
+	// Placement queries against the splat's top-down rasters (built once per splat load, O(1) per query).
+	// Horizontal (X,Y) distances in world units; the rasters hold the splat at rest, without bobbing or random movement.
+
+	// Horizontal distance from Position to the nearest splat point (about half a raster cell accurate); MAX_flt with no splat loaded
+	UFUNCTION(BlueprintCallable, Category = "SplatCreator|Placement")
+	float GetDistanceToSplatPoints(const FVector& Position) const;
+
+	// True when no splat point lies within MinDistance of Position horizontally
+	UFUNCTION(BlueprintCallable, Category = "SplatCreator|Placement")
+	bool IsSplatPlacementFree(const FVector& Position, float MinDistance = 50.0f) const;
+
+	// World Z of the highest splat point in the column under Position; false where the splat has no points
+	UFUNCTION(BlueprintCallable, Category = "SplatCreator|Placement")
+	bool GetSplatGroundHeight(const FVector& Position, float& OutHeight) const;
+
+	UFUNCTION(BlueprintCallable, Category = "SplatCreator|Placement")
+	TArray<float> GetDistancesToSplatPoints(const TArray<FVector>& Positions) const;
+
+	UFUNCTION(BlueprintCallable, Category = "SplatCreator|Placement")
+	TArray<bool> AreSplatPlacementsFree(const TArray<FVector>& Positions, float MinDistance = 50.0f) const;
+
+	// OutHeights[i] is valid where OutHasGround[i]
+	UFUNCTION(BlueprintCallable, Category = "SplatCreator|Placement")
+	void GetSplatGroundHeights(const TArray<FVector>& Positions, TArray<float>& OutHeights, TArray<bool>& OutHasGround) const;
+
+	// Pick the nearest splat sphere along a world ray. Uses a BVH built in the background per splat; hits are checked
+	// against the live instances, so bobbing, random movement and Set Splat Scale are followed (not the plane morph).
+	UFUNCTION(BlueprintCallable, Category = "SplatCreator|Pick")
+	FSplatRayHit RaycastSplat(const FVector& Origin, const FVector& Direction, float MaxDistance = 100000.0f) const;
+
+	// One hit per ray (Origins[i], Directions[i]), e.g. one per touch
+	UFUNCTION(BlueprintCallable, Category = "SplatCreator|Pick")
+	TArray<FSplatRayHit> RaycastSplatBatch(const TArray<FVector>& Origins, const TArray<FVector>& Directions, float MaxDistance = 100000.0f) const;
+
+	// Rays through screen positions (touch or cursor) of PlayerController's view; the first local player's if null
+	UFUNCTION(BlueprintCallable, Category = "SplatCreator|Pick")
+	TArray<FSplatRayHit> PickSplatAtScreenPositions(APlayerController* PlayerController, const TArray<FVector2D>& ScreenPositions, float MaxDistance = 100000.0f) const;
+
+	// Time adaptive sphere sizing on a synthetic cloud of NumPoints (try 100k, 1M, 5M); logs and returns the result
+	UFUNCTION(BlueprintCallable, Category = "SplatCreator")
+	FSplatDensityBenchmark BenchmarkSphereSizing(int32 NumPoints = 100000, int32 Neighbours = 4) const;
+
 	// Handle OSC message to control splat bobbing animation
 	// Message should contain "up", "down", "left", or "right" to control bobbing direction
 	// Call this from BP_OSC blueprint when receiving OSC messages
@@ -240,6 +348,10 @@ public:
 	UPROPERTY(EditAnywhere, Category = "SplatCreator|Cycle", meta = (EditCondition = "!bCycleSplatOnComfyFrame", ClampMin = "1.0", ClampMax = "300.0"), Setter = "SetCycleLength", Getter = "GetCycleLength")
 	float CycleIntervalSeconds = 16.0f;
 
+	/** Memory cap for prepared (parsed, sampled, sized) splats kept for instant revisits. The next splat is always prepared in the background. */
+	UPROPERTY(EditAnywhere, Category = "SplatCreator|Cycle", meta = (ClampMin = "0"))
+	int32 PreparedSplatCacheMB = 512;
+
 	/** Delay in seconds after cycle change before morphing starts */
 	UPROPERTY(EditAnywhere, Category = "SplatCreator|Cycle", meta = (ClampMin = "0.0", ClampMax = "60.0"))
 	float MorphStartDelaySeconds = 8.0f;
@@ -254,6 +366,17 @@ private:
 	int32 NextFileIndex = -1;
 	FTimerHandle CycleTimer;
 
+	// Background splat preparation: one job at a time, least recently used prepared splats first to go
+	TArray<TPair<FString, FSplatPreparedCloudPtr>> PreparedSplats;
+	FString PreparingPath;
+	FString PendingShowPath;
+	TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> PrepareCancel;
+	uint32 PrepareJobId = 0;
+
+	// Splat on screen; its placement field and sphere BVH answer placement and pick queries (in rest space)
+	FSplatPreparedCloudPtr CurrentSplat;
+	FVector SplatRestOffset = FVector::ZeroVector;
+
 	// Point cloud rendering
 	UPROPERTY(Transient)
 	TObjectPtr<AActor> CurrentPointCloudActor = nullptr;
@@ -353,10 +476,20 @@ private:
 	void ScanForPLYFiles();
 	void CycleToNextPLY();
 	void LoadPLYFile(const FString& PLYPath);
-	bool ParsePLYFile(const FString& PLYPath, TArray<FVector>& OutPositions, TArray<FColor>& OutColors);
-	void SamplePointsUniformly(const TArray<FVector>& InPositions, const TArray<FColor>& InColors, TArray<FVector>& OutPositions, TArray<FColor>& OutColors);
-	void CalculateAdaptiveSphereSizes(const TArray<FVector>& Positions, TArray<float>& OutSphereSizes);
-	void CreatePointCloud(const TArray<FVector>& Positions, const TArray<FColor>& Colors);
+	void ShowPreparedSplat(const FString& PLYPath, FSplatPreparedCloudPtr Cloud);
+	void PrepareSplatAsync(const FString& PLYPath);
+	void OnSplatPrepared(const FString& PLYPath, FSplatPreparedCloudPtr Cloud, uint32 JobId);
+	FSplatPreparedCloudPtr FindPreparedSplat(const FString& PLYPath);
+	void AddPreparedSplat(const FString& PLYPath, FSplatPreparedCloudPtr Cloud);
+	const FSplatPlacementField* GetPlacementField() const;
+	FTransform GetSplatRestToWorld() const;
+	FSplatRayHit TraceSplat(const FVector& Origin, const FVector& Direction, float MaxDistance, const FTransform& RestToWorld, const FTransform& ActorTransform, float Inflate) const;
+	float GetSplatAnimationReach() const;
+	static FSplatPreparedCloudPtr PrepareSplat(const FString& PLYPath, const FThreadSafeBool& bCancel);
+	static bool ParsePLYFile(const FString& PLYPath, TArray<FVector>& OutPositions, TArray<FColor>& OutColors);
+	static void SamplePointsUniformly(const TArray<FVector>& InPositions, const TArray<FColor>& InColors, TArray<FVector>& OutPositions, TArray<FColor>& OutColors);
+	static void CalculateAdaptiveSphereSizes(const TArray<FVector>& Positions, TArray<float>& OutSphereSizes);
+	void CreatePointCloud(const FSplatPreparedCloud& Cloud);
 	void UpdatePlaneMorph();
 	void CompletePlaneMorph();
 	void StartDelayedMorph();
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Top-down rasters of a splat for object placement, in the splat actor's local space:
+// a heightfield (Z range of the points per XY cell; empty cells are the free part of the occupancy raster)
+// and a Euclidean distance transform of the occupied cells. Built once per splat, read-only afterwards.
+class REALITYSTREAM_API FSplatPlacementField
+{
+public:
+	// Raster over the XY bounds of Points * PositionScale plus a margin, MaxResolution cells along the longer side
+	void Build(const TArray<FVector>& Points, float PositionScale = 1.0f, int32 MaxResolution = 512);
+
+	bool IsValid() const { return Distance.Num() > 0; }
+
+	// XY distance to the nearest occupied cell, bilinear between cell centres (about half a cell accurate).
+	// Beyond the raster, the edge value plus the distance to the edge.
+	float GetDistance(const FVector2D& Local) const;
+
+	// Z range of the points in the column at Local; false for empty cells and outside the raster
+	bool GetHeightRange(const FVector2D& Local, float& OutMinZ, float& OutMaxZ) const;
+
+	float GetCellSize() const { return CellSize; }
+	FIntPoint GetDims() const { return Dims; }
+	int64 GetAllocatedSize() const { return Distance.GetAllocatedSize() + MinZ.GetAllocatedSize() + MaxZ.GetAllocatedSize(); }
+
+private:
+	// Exact squared distance transform along one line of Count samples (Felzenszwalb-Huttenlocher lower envelope)
+	static void DistanceTransform1D(const float* In, float* Out, int32 Count, int32* Vertices, float* Boundaries);
+
+	FVector2f Origin = FVector2f::ZeroVector;
+	float CellSize = 1.0f;
+	float InvCellSize = 1.0f;
+	FIntPoint Dims = FIntPoint::ZeroValue;
+
+	// Row-major Dims.X * Dims.Y; Distance in local units, MinZ > MaxZ marks an empty cell
+	TArray<float> Distance;
+	TArray<float> MinZ;
+	TArray<float> MaxZ;
+};
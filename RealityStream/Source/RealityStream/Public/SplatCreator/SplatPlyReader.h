@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// Read-only view of a whole file: memory-mapped where the platform supports it, loaded otherwise
+class REALITYSTREAM_API FSplatMappedFile
+{
+public:
+	FSplatMappedFile();
+	~FSplatMappedFile();
+
+	bool Open(const FString& Path);
+	void Close();
+
+	const uint8* GetData() const { return Data; }
+	int64 Num() const { return Size; }
+
+private:
+	TUniquePtr<IMappedFileHandle> Handle;
+	TUniquePtr<IMappedFileRegion> Region;
+	TArray64<uint8> Fallback;
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+};
+
+// Decoded splat vertices (SoA, PLY axes; the subsystem converts to Unreal axes)
+struct REALITYSTREAM_API FSplatPlyPoints
+{
+	TArray<float> X;
+	TArray<float> Y;
+	TArray<float> Z;
+	TArray<FColor> Colors;
+
+	int32 Num() const { return X.Num(); }
+};
+
+// PLY vertex reader for ascii and binary (little/big endian) files with typed properties.
+// Colours come from the Gaussian splat DC term (f_dc_0..2) when present, otherwise from red/green/blue.
+// Thread-safe; only touches the file and the output.
+class REALITYSTREAM_API FSplatPlyReader
+{
+public:
+	static bool Read(const FString& Path, FSplatPlyPoints& Out);
+
+	// Same on bytes already in memory (whole file, header included)
+	static bool Read(const uint8* Data, int64 Size, FSplatPlyPoints& Out);
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SplatPlacementField.h"
+#include "SplatSphereBVH.h"
+
+// Parsed, sampled and sized splat, ready for instancing. Built on the thread pool, shared read-only afterwards.
+struct FSplatPreparedCloud
+{
+	// Sampled points in PLY units, Unreal axes (instances use Positions * SplatPositionScale)
+	TArray<FVector> Positions;
+	TArray<FColor> Colors;
+	TArray<float> SphereSizes;
+
+	// Bounds of the scaled positions
+	FBox Bounds = FBox(ForceInit);
+
+	// Placement rasters and pick hierarchy over the scaled positions (rebuilt on load, not stored in the cache file)
+	FSplatPlacementField PlacementField;
+	FSplatSphereBVH SphereBVH;
+
+	// Source file state the cloud was built from
+	FDateTime SourceTimeStamp;
+	int64 SourceSize = 0;
+
+	int64 GetAllocatedSize() const
+	{
+		return Positions.GetAllocatedSize() + Colors.GetAllocatedSize() + SphereSizes.GetAllocatedSize() + PlacementField.GetAllocatedSize() +
+		       SphereBVH.GetAllocatedSize();
+	}
+};
+using FSplatPreparedCloudPtr = TSharedPtr<const FSplatPreparedCloud, ESPMode::ThreadSafe>;
+
+// Preprocessed splat file next to its PLY (<name>.splatcache): header, then float3 positions, RGBA8 colours and
+// sphere sizes as flat 4-byte aligned arrays, so a load maps the file and copies three blocks.
+// Valid while the PLY's size and modification time and the processing parameters match.
+class REALITYSTREAM_API FSplatPointCache
+{
+public:
+	static FString GetCachePath(const FString& PLYPath);
+
+	// False when missing, from another version/parameter set, or stale against SourceSize/SourceTimeStamp
+	static bool Load(const FString& PLYPath, int64 SourceSize, const FDateTime& SourceTimeStamp, uint32 ParamsHash, FSplatPreparedCloud& Out);
+
+	// Written to a temporary file and moved into place, so readers never see a partial cache
+	static bool Save(const FString& PLYPath, uint32 ParamsHash, const FSplatPreparedCloud& Cloud);
+};
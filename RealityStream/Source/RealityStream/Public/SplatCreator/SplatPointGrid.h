@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Uniform grid over a point cloud for exact k-nearest-neighbour queries.
+// Points are counting-sorted by cell, so a cell is one contiguous run of SortedPoints. Read-only after Build,
+// so queries may run in parallel.
+class REALITYSTREAM_API FSplatPointGrid
+{
+public:
+	// Largest K FindKNearest accepts
+	static constexpr int32 MaxNeighbours = 16;
+
+	// Cubic cells sized for about PointsPerCell points each (cell keys in parallel, then one counting sort)
+	void Build(const TArray<FVector>& Points, float PointsPerCell = 2.0f);
+
+	// Squared distances of the K nearest points to Query, ascending, skipping the point with index ExcludeIndex.
+	// Exact: cells are visited in growing shells until no unvisited cell can be closer. Returns the number found.
+	int32 FindKNearest(const FVector3f& Query, int32 K, int32 ExcludeIndex, float* OutDistSq, int32* OutIndices = nullptr) const;
+
+	// Mean distance of every point to its K nearest neighbours (ParallelFor in cell order); MAX_flt for lone points
+	static void ComputeMeanNeighbourDistances(const TArray<FVector>& Points, int32 K, TArray<float>& OutDistances);
+
+	int32 Num() const { return SortedPoints.Num(); }
+	float GetCellSize() const { return CellSize; }
+	FIntVector GetDims() const { return Dims; }
+
+private:
+	FIntVector CellOf(const FVector3f& P) const;
+	int32 CellIndex(int32 X, int32 Y, int32 Z) const { return (Z * Dims.Y + Y) * Dims.X + X; }
+
+	FVector3f Origin = FVector3f::ZeroVector;
+	float CellSize = 1.0f;
+	float InvCellSize = 1.0f;
+	FIntVector Dims = FIntVector(1, 1, 1);
+
+	// CellStart[c]..CellStart[c + 1] index SortedPoints/SortedIndex
+	TArray<int32> CellStart;
+	TArray<FVector3f> SortedPoints;
+	TArray<int32> SortedIndex;
+};
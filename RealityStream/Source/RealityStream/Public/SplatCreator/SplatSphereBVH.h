@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Bounding volume hierarchy over the splat's instanced spheres for ray picking.
+// Spheres are ordered along a Morton curve and split where the codes first differ (linear BVH), leaves hold a few
+// spheres each. Nodes are 32 bytes with both children adjacent. Read-only after Build, so queries may run in parallel.
+class REALITYSTREAM_API FSplatSphereBVH
+{
+public:
+	// Spheres at Centers * PositionScale with radius Radii * RadiusScale
+	void Build(const TArray<FVector>& Centers, const TArray<float>& Radii, float PositionScale = 1.0f, float RadiusScale = 1.0f);
+
+	bool IsValid() const { return Nodes.Num() > 0; }
+
+	// Visits spheres grown by Inflate that the ray Origin + t * Direction (t in [0, MaxT]) touches, nearer boxes first.
+	// Visit(SphereIndex, MaxT) returns the new MaxT, so a confirmed hit prunes everything behind it.
+	// Direction need not be normalised; t keeps its meaning under affine maps of the ray.
+	void Raycast(const FVector3f& Origin, const FVector3f& Direction, float MaxT, float Inflate, TFunctionRef<float(int32, float)> Visit) const;
+
+	int32 Num() const { return SphereIndex.Num(); }
+	int64 GetAllocatedSize() const { return Nodes.GetAllocatedSize() + Spheres.GetAllocatedSize() + SphereIndex.GetAllocatedSize(); }
+
+private:
+	struct FNode
+	{
+		FVector3f Min;
+		int32 Start = 0; // First sphere (leaf) or left child (inner; right child is Start + 1)
+		FVector3f Max;
+		int32 Count = 0; // Spheres in a leaf, 0 for inner nodes
+	};
+	static_assert(sizeof(FNode) == 32, "FSplatSphereBVH node should stay 32 bytes");
+
+	void BuildNode(int32 NodeIndex, int32 Begin, int32 End, const TArray<uint64>& Keys);
+
+	TArray<FNode> Nodes;
+	// Leaf order: centre and radius, and the instance index each came from
+	TArray<FVector4f> Spheres;
+	TArray<int32> SphereIndex;
+};